@@ -0,0 +1,381 @@
+#ifndef DUNGEON_GAME_ADAPTIVE_SOLVER_H
+#define DUNGEON_GAME_ADAPTIVE_SOLVER_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+
+#include "dungeon_grid.h"
+#include "dungeon_kernels.h"
+#include "kernel_timing.h"
+#include "auto_tuner.h"
+
+enum class KernelKind {
+    Scalar1D,
+    Wavefront16,
+    Wavefront32,
+    TiledParallel,
+    FullTable,
+    Batch,
+    Count
+};
+
+inline const char* kernelName(KernelKind kind) {
+    switch (kind) {
+        case KernelKind::Scalar1D:      return "scalar1d";
+        case KernelKind::Wavefront16:   return "wavefront16";
+        case KernelKind::Wavefront32:   return "wavefront32";
+        case KernelKind::TiledParallel: return "tiled";
+        case KernelKind::FullTable:     return "fulltable";
+        case KernelKind::Batch:         return "batch";
+        default:                        return "unknown";
+    }
+}
+
+// Linear cost model: time(cells) = overheadNs + perCellNs * cells
+struct KernelCost {
+    double overheadNs = 0;
+    double perCellNs = 0;
+};
+
+struct SolveOptions {
+    size_t memoryBudget = std::numeric_limits<size_t>::max();  // extra bytes
+    bool needPath = false;  // only the full table yields a path; it must fit the budget
+
+    // Set when the caller knows the cell value range (e.g. -10..10 from a
+    // generator); the int16 wavefront is only considered then, since
+    // scanning for it costs a full pass over the grid
+    bool valueRangeKnown = false;
+    int minValue = 0;
+    int maxValue = 0;
+};
+
+struct SolveResult {
+    int minimumHP = 1;
+    KernelKind kernel = KernelKind::Scalar1D;
+    std::string path;  // 'R' / 'D' moves, filled only when needPath is set
+    std::string error;  // set when no kernel meets the options; minimumHP is 0 then
+};
+
+/**
+ * Picks a kernel from dungeon_kernels.h per call
+ *
+ * Each kernel has a calibrated linear cost model; solve() estimates every
+ * candidate that fits the memory budget and value range, and runs the
+ * cheapest. The defaults are rough figures for a modern x86 core;
+ * calibrate() replaces them with measurements on this machine, and
+ * saveCalibration/loadCalibration keep them across runs. Tile size, thread
+ * count and lane width come from an AutoTuner profile per size class when
+ * one is applied (see loadTuning).
+ *
+ * The streaming kernel is not a candidate here: it is for inputs that are
+ * not in memory.
+ */
+class AdaptiveDungeonSolver {
+private:
+    static const int kKernels = static_cast<int>(KernelKind::Count);
+
+    KernelCost costs[kKernels];
+    int threads;
+    TuningProfile tuning;
+
+public:
+    explicit AdaptiveDungeonSolver(int threads = 0) : threads(threads) {
+        if (this->threads <= 0) {
+            unsigned int hardware = std::thread::hardware_concurrency();
+            this->threads = hardware > 0 ? static_cast<int>(hardware) : 1;
+        }
+        for (auto& config : tuning.classes) {
+            config.threads = this->threads;
+        }
+
+        cost(KernelKind::Scalar1D)      = makeCost(50, 1.2);
+        cost(KernelKind::Wavefront16)   = makeCost(500, 0.9);
+        cost(KernelKind::Wavefront32)   = makeCost(500, 1.4);
+        cost(KernelKind::TiledParallel) = makeCost(40000 * this->threads, 1.2 / this->threads);
+        cost(KernelKind::FullTable)     = makeCost(200, 2.0);
+        cost(KernelKind::Batch)         = makeCost(20000 * this->threads, 1.2 / this->threads);
+    }
+
+    int threadCount() const { return threads; }
+
+    void setTileSize(int rows, int cols) {
+        for (auto& config : tuning.classes) {
+            config.tileRows = std::max(1, rows);
+            config.tileCols = std::max(1, cols);
+        }
+    }
+
+    // Use tuned parameters per size class; thread counts are capped at the
+    // solver's own
+    void applyProfile(const TuningProfile& profile) {
+        tuning = profile;
+        for (auto& config : tuning.classes) {
+            config.threads = std::max(1, std::min(config.threads, threads));
+        }
+    }
+
+    // Apply the profile saved for this CPU model, if the file has one
+    bool loadTuning(const std::string& path) {
+        TuningProfile profile;
+        if (!AutoTuner::loadProfile(path, cpuModelName(), profile)) {
+            return false;
+        }
+        applyProfile(profile);
+        return true;
+    }
+
+    const TuningProfile& profile() const { return tuning; }
+
+    const KernelCost& costOf(KernelKind kind) const {
+        return costs[static_cast<int>(kind)];
+    }
+
+    double predictNs(KernelKind kind, size_t cells) const {
+        const KernelCost& model = costOf(kind);
+        return model.overheadNs + model.perCellNs * cells;
+    }
+
+    // Extra memory a kernel allocates for a rows × cols grid
+    size_t memoryBytes(KernelKind kind, int rows, int cols) const {
+        size_t cells = static_cast<size_t>(rows) * cols;
+        switch (kind) {
+            case KernelKind::Scalar1D:
+                return (cols + 1) * sizeof(int);
+            case KernelKind::Wavefront16:
+                return cells * sizeof(int16_t) + (rows + cols) * sizeof(size_t)
+                       + 2 * (rows + 1) * sizeof(int16_t);
+            case KernelKind::Wavefront32:
+                return cells * sizeof(int32_t) + (rows + cols) * sizeof(size_t)
+                       + 2 * (rows + 1) * sizeof(int32_t);
+            case KernelKind::TiledParallel: {
+                const TunedConfig& config = tuning.forCells(cells);
+                size_t bands = (rows + config.tileRows - 1) / config.tileRows;
+                size_t strips = (cols + config.tileCols - 1) / config.tileCols;
+                return ((bands + 1) * cols + (strips + 1) * rows
+                        + config.threads * (config.tileCols + 1)) * sizeof(int);
+            }
+            case KernelKind::FullTable:
+                return (rows + 1) * static_cast<size_t>(cols + 1) * sizeof(int);
+            default:
+                return (cols + 1) * sizeof(int) * threads;
+        }
+    }
+
+    // Decide without touching the grid, so it also answers "what would run"
+    KernelKind choose(int rows, int cols, const SolveOptions& options = SolveOptions()) const {
+        if (options.needPath) {
+            return KernelKind::FullTable;
+        }
+
+        static const KernelKind candidates[] = {
+            KernelKind::Scalar1D, KernelKind::Wavefront16,
+            KernelKind::Wavefront32, KernelKind::TiledParallel
+        };
+
+        size_t cells = static_cast<size_t>(rows) * cols;
+        const TunedConfig& config = tuning.forCells(cells);
+        KernelKind best = KernelKind::Scalar1D;
+        double bestNs = std::numeric_limits<double>::max();
+        for (KernelKind kind : candidates) {
+            if (kind == KernelKind::Wavefront16 &&
+                !(config.int16Lanes && options.valueRangeKnown &&
+                  DungeonKernels::fitsInt16(rows, cols, options.minValue, options.maxValue))) {
+                continue;
+            }
+            if (kind == KernelKind::TiledParallel && config.threads == 1) {
+                continue;
+            }
+            if (memoryBytes(kind, rows, cols) > options.memoryBudget) {
+                continue;
+            }
+
+            double predicted = predictNs(kind, cells);
+            if (predicted < bestNs) {
+                bestNs = predicted;
+                best = kind;
+            }
+        }
+        // Nothing fits the budget: scalar1D needs the least memory anyway
+        return best;
+    }
+
+    // A workspace kept across calls makes repeated solves allocation-free
+    // (apart from thread start-up when the tiled kernel runs on threads)
+    SolveResult solve(const DungeonGrid& grid, const SolveOptions& options = SolveOptions(),
+                      Workspace* workspace = nullptr) const {
+        SolveResult result;
+        result.kernel = choose(grid.rows, grid.cols, options);
+        if (options.needPath && memoryBytes(result.kernel, grid.rows, grid.cols) > options.memoryBudget) {
+            result.minimumHP = 0;
+            result.error = "path needs " + std::to_string(memoryBytes(result.kernel, grid.rows, grid.cols)) +
+                           " bytes, over the memory budget of " + std::to_string(options.memoryBudget);
+            return result;
+        }
+        SpanScope span(SpanKind::Solve, cellRange(0, grid.rows, 0, grid.cols),
+                       static_cast<int32_t>(result.kernel));
+        result.minimumHP = run(result.kernel, grid, options.needPath ? &result.path : nullptr, workspace);
+        return result;
+    }
+
+    SolveResult solve(const std::vector<std::vector<int>>& dungeon,
+                      const SolveOptions& options = SolveOptions(),
+                      Workspace* workspace = nullptr) const {
+        return solve(DungeonGrid::fromNested(dungeon), options, workspace);
+    }
+
+    // Many grids: spread whole grids across threads when the per-grid
+    // dispatch would not already use them
+    std::vector<int> solveBatch(const std::vector<DungeonGrid>& grids,
+                                const SolveOptions& options = SolveOptions(),
+                                Workspace* workspace = nullptr) const {
+        std::vector<int> results;
+        size_t totalCells = 0;
+        double dispatchNs = 0;
+        for (const auto& grid : grids) {
+            totalCells += grid.size();
+            dispatchNs += predictNs(choose(grid.rows, grid.cols, options), grid.size());
+        }
+
+        if (threads > 1 && grids.size() > 1 &&
+            predictNs(KernelKind::Batch, totalCells) < dispatchNs) {
+            DungeonKernels::batch(grids, results, threads, workspace);
+            return results;
+        }
+
+        results.reserve(grids.size());
+        for (const auto& grid : grids) {
+            results.push_back(solve(grid, options, workspace).minimumHP);
+        }
+        return results;
+    }
+
+    // ---- calibration ----------------------------------------------------
+
+    // Time every kernel at two sizes on random grids and fit the line
+    // through both points
+    void calibrate() {
+        DungeonGrid small = syntheticGrid(48, 48, 1);
+        DungeonGrid large = syntheticGrid(768, 768, 2);
+
+        for (int k = 0; k < kKernels; k++) {
+            KernelKind kind = static_cast<KernelKind>(k);
+            double smallNs, largeNs;
+            size_t smallCells, largeCells;
+
+            if (kind == KernelKind::Batch) {
+                std::vector<DungeonGrid> few(threads, small), many(threads * 16, small);
+                smallNs = timeBatch(few);
+                largeNs = timeBatch(many);
+                smallCells = few.size() * small.size();
+                largeCells = many.size() * small.size();
+            } else {
+                smallNs = timeKernel(kind, small);
+                largeNs = timeKernel(kind, large);
+                smallCells = small.size();
+                largeCells = large.size();
+            }
+
+            KernelCost& model = cost(kind);
+            model.perCellNs = std::max(0.0, (largeNs - smallNs) / (largeCells - smallCells));
+            model.overheadNs = std::max(0.0, smallNs - model.perCellNs * smallCells);
+        }
+    }
+
+    // Format: one "<kernel> <overhead_ns> <per_cell_ns>" line per kernel,
+    // after a "threads <n>" line; a file for another thread count is ignored
+    bool saveCalibration(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            return false;
+        }
+        out << "threads " << threads << "\n";
+        for (int k = 0; k < kKernels; k++) {
+            out << kernelName(static_cast<KernelKind>(k)) << " "
+                << costs[k].overheadNs << " " << costs[k].perCellNs << "\n";
+        }
+        return static_cast<bool>(out);
+    }
+
+    bool loadCalibration(const std::string& path) {
+        std::ifstream in(path);
+        std::string word;
+        int savedThreads = 0;
+        if (!(in >> word >> savedThreads) || word != "threads" || savedThreads != threads) {
+            return false;
+        }
+
+        KernelCost loaded[kKernels];
+        int seen = 0;
+        double overhead, perCell;
+        while (in >> word >> overhead >> perCell) {
+            for (int k = 0; k < kKernels; k++) {
+                if (word == kernelName(static_cast<KernelKind>(k))) {
+                    loaded[k].overheadNs = overhead;
+                    loaded[k].perCellNs = perCell;
+                    seen++;
+                }
+            }
+        }
+        if (seen != kKernels) {
+            return false;
+        }
+        std::copy(loaded, loaded + kKernels, costs);
+        return true;
+    }
+
+    // Load a saved calibration, or measure and save one
+    void calibrateOrLoad(const std::string& path) {
+        if (!loadCalibration(path)) {
+            calibrate();
+            saveCalibration(path);
+        }
+    }
+
+private:
+    static KernelCost makeCost(double overheadNs, double perCellNs) {
+        KernelCost model;
+        model.overheadNs = overheadNs;
+        model.perCellNs = perCellNs;
+        return model;
+    }
+
+    KernelCost& cost(KernelKind kind) {
+        return costs[static_cast<int>(kind)];
+    }
+
+    int run(KernelKind kind, const DungeonGrid& grid, std::string* path,
+            Workspace* workspace = nullptr) const {
+        switch (kind) {
+            case KernelKind::Wavefront16:
+                return DungeonKernels::wavefront<int16_t>(grid, workspace);
+            case KernelKind::Wavefront32:
+                return DungeonKernels::wavefront<int32_t>(grid, workspace);
+            case KernelKind::TiledParallel: {
+                const TunedConfig& config = tuning.forCells(grid.size());
+                return DungeonKernels::tiledParallel(grid, config.tileRows, config.tileCols,
+                                                     config.threads, workspace);
+            }
+            case KernelKind::FullTable:
+                return DungeonKernels::fullTable(grid, path, workspace);
+            default:
+                return DungeonKernels::scalar1D(grid, workspace);
+        }
+    }
+
+    double timeKernel(KernelKind kind, const DungeonGrid& grid) const {
+        volatile int sink = 0;
+        return bestTimeNs([&]() { sink = run(kind, grid, nullptr); });
+    }
+
+    double timeBatch(const std::vector<DungeonGrid>& grids) const {
+        std::vector<int> results;
+        return bestTimeNs([&]() { DungeonKernels::batch(grids, results, threads); });
+    }
+};
+
+#endif // DUNGEON_GAME_ADAPTIVE_SOLVER_H
@@ -0,0 +1,106 @@
+#ifndef DUNGEON_GAME_ALLOC_HOOKS_H
+#define DUNGEON_GAME_ALLOC_HOOKS_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "alloc_tracking.h"
+
+/**
+ * Replacement global operator new/delete that count every allocation
+ *
+ * These are definitions, not declarations: include this header from
+ * exactly one translation unit of a program (the one with main), and only
+ * in profiling and benchmark programs. Each block carries a 16-byte prefix
+ * holding its size, so delete can subtract the right number of live bytes
+ * and the user pointer keeps max_align_t alignment.
+ */
+
+namespace alloc_hooks {
+
+static const size_t kPrefix = 16;
+static_assert(kPrefix >= alignof(std::max_align_t), "prefix must keep new's alignment");
+
+inline void* allocate(size_t size) {
+    for (;;) {
+        if (void* block = std::malloc(size + kPrefix)) {
+            *static_cast<size_t*>(block) = size;
+            recordAllocation(size);
+            return static_cast<char*>(block) + kPrefix;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+inline void release(void* pointer) {
+    if (!pointer) {
+        return;
+    }
+    void* block = static_cast<char*>(pointer) - kPrefix;
+    recordFree(*static_cast<size_t*>(block));
+    std::free(block);
+}
+
+struct Installed {
+    Installed() { allocationCounters().hooksInstalled.store(true); }
+};
+static Installed installed;
+
+}  // namespace alloc_hooks
+
+void* operator new(size_t size) {
+    return alloc_hooks::allocate(size);
+}
+
+void* operator new[](size_t size) {
+    return alloc_hooks::allocate(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return alloc_hooks::allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return alloc_hooks::allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* pointer) noexcept {
+    alloc_hooks::release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    alloc_hooks::release(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    alloc_hooks::release(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    alloc_hooks::release(pointer);
+}
+
+#if defined(__cpp_sized_deallocation)
+void operator delete(void* pointer, size_t) noexcept {
+    alloc_hooks::release(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    alloc_hooks::release(pointer);
+}
+#endif
+
+#endif // DUNGEON_GAME_ALLOC_HOOKS_H
@@ -0,0 +1,210 @@
+#ifndef DUNGEON_GAME_ALLOC_TRACKING_H
+#define DUNGEON_GAME_ALLOC_TRACKING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// Process-wide allocation counters, fed by alloc_hooks.h and CountingAllocator
+struct AllocationCounterState {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<int64_t> liveBytes{0};
+    std::atomic<int64_t> peakLiveBytes{0};
+    std::atomic<bool> hooksInstalled{false};
+};
+
+// Constant-initialised, so it is usable from operator new before main
+inline AllocationCounterState& allocationCounters() {
+    static AllocationCounterState state;
+    return state;
+}
+
+// Allocations made by the calling thread, for per-solve deltas that other
+// threads cannot disturb; trivially initialised, so safe inside operator new
+inline uint64_t& threadAllocationCount() {
+    static thread_local uint64_t count = 0;
+    return count;
+}
+
+inline void recordAllocation(size_t size) {
+    threadAllocationCount()++;
+    AllocationCounterState& state = allocationCounters();
+    state.allocations.fetch_add(1, std::memory_order_relaxed);
+    state.bytes.fetch_add(size, std::memory_order_relaxed);
+    int64_t live = state.liveBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) +
+                   static_cast<int64_t>(size);
+    int64_t peak = state.peakLiveBytes.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !state.peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+inline void recordFree(size_t size) {
+    AllocationCounterState& state = allocationCounters();
+    state.frees.fetch_add(1, std::memory_order_relaxed);
+    state.liveBytes.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+}
+
+// True when the program includes alloc_hooks.h, i.e. every new is counted
+inline bool allocationHooksInstalled() {
+    return allocationCounters().hooksInstalled.load(std::memory_order_relaxed);
+}
+
+/**
+ * Peak resident set size of the process, in bytes
+ *
+ * On Linux this is VmHWM, which resetPeakRss() can rewind to the current
+ * RSS (writing "5" to /proc/self/clear_refs, Linux 4.0+), so a peak can be
+ * taken per solve. Elsewhere it is getrusage's lifetime maximum.
+ */
+inline uint64_t peakRssBytes() {
+#if defined(__linux__)
+    // Plain stdio: no heap allocation that would show up in the counters
+    if (std::FILE* status = std::fopen("/proc/self/status", "r")) {
+        char line[256];
+        unsigned long long kb = 0;
+        while (std::fgets(line, sizeof(line), status)) {
+            if (std::strncmp(line, "VmHWM:", 6) == 0) {
+                kb = std::strtoull(line + 6, nullptr, 10);
+                break;
+            }
+        }
+        std::fclose(status);
+        if (kb > 0) {
+            return kb * 1024;
+        }
+    }
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+        return static_cast<uint64_t>(usage.ru_maxrss);         // bytes
+#else
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;  // kilobytes
+#endif
+    }
+#endif
+    return 0;
+}
+
+inline bool resetPeakRss() {
+#if defined(__linux__)
+    if (std::FILE* clearRefs = std::fopen("/proc/self/clear_refs", "w")) {
+        bool ok = std::fputs("5", clearRefs) >= 0;
+        return std::fclose(clearRefs) == 0 && ok;
+    }
+#endif
+    return false;
+}
+
+// What one solve allocated
+struct AllocationStats {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;          // total requested, not net
+    int64_t peakLiveBytes = 0;   // above what was live when the scope began
+    uint64_t peakRssBytes = 0;   // process VmHWM while the scope was open
+    bool rssPerSolve = false;    // false: peakRssBytes is the lifetime peak
+};
+
+/**
+ * Measures the allocations between construction and stop()
+ *
+ * Counters are process-wide, so allocations by worker threads a solver
+ * starts are included; anything else running concurrently is too. Scopes
+ * do not nest: each one restarts the peak-live watermark.
+ */
+class AllocationScope {
+private:
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t bytes;
+    int64_t liveAtStart;
+    bool rssReset;
+
+public:
+    AllocationScope() {
+        rssReset = resetPeakRss();
+        AllocationCounterState& state = allocationCounters();
+        allocations = state.allocations.load(std::memory_order_relaxed);
+        frees = state.frees.load(std::memory_order_relaxed);
+        bytes = state.bytes.load(std::memory_order_relaxed);
+        liveAtStart = state.liveBytes.load(std::memory_order_relaxed);
+        state.peakLiveBytes.store(liveAtStart, std::memory_order_relaxed);
+    }
+
+    AllocationStats stop() const {
+        AllocationCounterState& state = allocationCounters();
+        AllocationStats stats;
+        stats.allocations = state.allocations.load(std::memory_order_relaxed) - allocations;
+        stats.frees = state.frees.load(std::memory_order_relaxed) - frees;
+        stats.bytes = state.bytes.load(std::memory_order_relaxed) - bytes;
+        stats.peakLiveBytes = state.peakLiveBytes.load(std::memory_order_relaxed) - liveAtStart;
+        stats.peakRssBytes = peakRssBytes();
+        stats.rssPerSolve = rssReset;
+        return stats;
+    }
+};
+
+// Allocations and peak of one call of work()
+template<typename Work>
+AllocationStats measureAllocations(Work work) {
+    AllocationScope scope;
+    work();
+    return scope.stop();
+}
+
+/**
+ * std::allocator replacement that feeds the same counters
+ *
+ * For solver containers in programs that do not replace global new (a
+ * library embedding the solvers, say): TrackedVector<int> counts its own
+ * buffers exactly. It allocates with malloc, so it is not counted twice
+ * when alloc_hooks.h is present too.
+ */
+template<typename T>
+struct CountingAllocator {
+    typedef T value_type;
+
+    CountingAllocator() {}
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        size_t size = count * sizeof(T);
+        void* memory = std::malloc(size > 0 ? size : 1);
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+        recordAllocation(size);
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        recordFree(count * sizeof(T));
+        std::free(pointer);
+    }
+};
+
+template<typename T, typename U>
+bool operator==(const CountingAllocator<T>&, const CountingAllocator<U>&) { return true; }
+
+template<typename T, typename U>
+bool operator!=(const CountingAllocator<T>&, const CountingAllocator<U>&) { return false; }
+
+template<typename T>
+using TrackedVector = std::vector<T, CountingAllocator<T>>;
+
+#endif // DUNGEON_GAME_ALLOC_TRACKING_H
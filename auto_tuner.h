@@ -0,0 +1,287 @@
+#ifndef DUNGEON_GAME_AUTO_TUNER_H
+#define DUNGEON_GAME_AUTO_TUNER_H
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <limits>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <utility>
+
+#include "dungeon_grid.h"
+#include "dungeon_kernels.h"
+#include "kernel_timing.h"
+
+// Grids are tuned in size classes by cell count
+enum class SizeClass {
+    Small,   // up to 64 × 64
+    Medium,  // up to 512 × 512
+    Large,   // up to 4096 × 4096
+    Huge,
+    Count
+};
+
+inline SizeClass sizeClassOf(size_t cells) {
+    if (cells <= 64u * 64u) return SizeClass::Small;
+    if (cells <= 512u * 512u) return SizeClass::Medium;
+    if (cells <= 4096u * 4096u) return SizeClass::Large;
+    return SizeClass::Huge;
+}
+
+inline const char* sizeClassName(SizeClass sizeClass) {
+    switch (sizeClass) {
+        case SizeClass::Small:  return "small";
+        case SizeClass::Medium: return "medium";
+        case SizeClass::Large:  return "large";
+        case SizeClass::Huge:   return "huge";
+        default:                return "unknown";
+    }
+}
+
+// Best parameters found for one size class
+struct TunedConfig {
+    int tileRows = 256;
+    int tileCols = 256;
+    int threads = 1;
+    bool int16Lanes = true;  // wavefront16 beat wavefront32 on this machine
+};
+
+struct TuningProfile {
+    static const int kClasses = static_cast<int>(SizeClass::Count);
+
+    std::string cpuModel;
+    TunedConfig classes[kClasses];
+
+    const TunedConfig& forCells(size_t cells) const {
+        return classes[static_cast<int>(sizeClassOf(cells))];
+    }
+};
+
+// "model name" from /proc/cpuinfo, which tells CPU generations apart;
+// "unknown" elsewhere
+inline std::string cpuModelName() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                size_t start = line.find_first_not_of(" \t", colon + 1);
+                if (start != std::string::npos) {
+                    return line.substr(start);
+                }
+            }
+        }
+    }
+    return "unknown";
+}
+
+/**
+ * Per-machine tuning of the tiled and SIMD kernels
+ *
+ * For each size class the tuner times, on a random grid representative of
+ * the class:
+ *   - tile height and width for tiledParallel (a small grid of candidates
+ *     from L1-sized to L2-sized tiles)
+ *   - thread count with the best tile, powers of two up to the hardware
+ *     thread count (more threads stop paying once memory bandwidth is the
+ *     limit)
+ *   - int16 vs int32 wavefront lanes
+ *
+ * Profiles are stored as tab-separated lines
+ *
+ *     <cpu model> <class> <tileRows> <tileCols> <threads> <laneBits>
+ *
+ * so one file serves a fleet with several CPU models; saving replaces only
+ * the lines for the current model.
+ */
+class AutoTuner {
+private:
+    int maxThreads;
+
+public:
+    explicit AutoTuner(int maxThreads = 0) : maxThreads(maxThreads) {
+        if (this->maxThreads <= 0) {
+            unsigned int hardware = std::thread::hardware_concurrency();
+            this->maxThreads = hardware > 0 ? static_cast<int>(hardware) : 1;
+        }
+    }
+
+    TuningProfile tune() const {
+        TuningProfile profile;
+        profile.cpuModel = cpuModelName();
+        for (int k = 0; k < TuningProfile::kClasses; k++) {
+            profile.classes[k] = tuneClass(static_cast<SizeClass>(k));
+        }
+        return profile;
+    }
+
+    // Load the profile for this CPU, or tune and save one
+    TuningProfile loadOrTune(const std::string& path) const {
+        TuningProfile profile;
+        if (!loadProfile(path, cpuModelName(), profile)) {
+            profile = tune();
+            saveProfile(path, profile);
+        }
+        return profile;
+    }
+
+    static bool loadProfile(const std::string& path, const std::string& cpuModel,
+                            TuningProfile& profile) {
+        std::ifstream in(path);
+        std::string line;
+        bool seen[TuningProfile::kClasses] = {};
+        TuningProfile loaded;
+        loaded.cpuModel = cpuModel;
+
+        while (std::getline(in, line)) {
+            std::vector<std::string> fields = splitTabs(line);
+            if (fields.size() != 6 || fields[0] != cpuModel) {
+                continue;
+            }
+            for (int k = 0; k < TuningProfile::kClasses; k++) {
+                if (fields[1] == sizeClassName(static_cast<SizeClass>(k))) {
+                    TunedConfig& config = loaded.classes[k];
+                    config.tileRows = std::max(1, std::atoi(fields[2].c_str()));
+                    config.tileCols = std::max(1, std::atoi(fields[3].c_str()));
+                    config.threads = std::max(1, std::atoi(fields[4].c_str()));
+                    config.int16Lanes = std::atoi(fields[5].c_str()) == 16;
+                    seen[k] = true;
+                }
+            }
+        }
+
+        for (bool found : seen) {
+            if (!found) {
+                return false;
+            }
+        }
+        profile = loaded;
+        return true;
+    }
+
+    static bool saveProfile(const std::string& path, const TuningProfile& profile) {
+        // Keep the other CPU models' lines
+        std::vector<std::string> kept;
+        {
+            std::ifstream in(path);
+            std::string line;
+            while (std::getline(in, line)) {
+                std::vector<std::string> fields = splitTabs(line);
+                if (!line.empty() && line[0] != '#' && fields[0] != profile.cpuModel) {
+                    kept.push_back(line);
+                }
+            }
+        }
+
+        std::ofstream out(path);
+        if (!out) {
+            return false;
+        }
+        out << "# cpu\tclass\ttileRows\ttileCols\tthreads\tlaneBits\n";
+        for (const auto& line : kept) {
+            out << line << "\n";
+        }
+        for (int k = 0; k < TuningProfile::kClasses; k++) {
+            const TunedConfig& config = profile.classes[k];
+            out << profile.cpuModel << "\t" << sizeClassName(static_cast<SizeClass>(k)) << "\t"
+                << config.tileRows << "\t" << config.tileCols << "\t" << config.threads << "\t"
+                << (config.int16Lanes ? 16 : 32) << "\n";
+        }
+        return static_cast<bool>(out);
+    }
+
+private:
+    // Representative grid per class; the huge class is tuned below its
+    // lower bound to keep tuning within a few seconds
+    static DungeonGrid probeGrid(SizeClass sizeClass) {
+        switch (sizeClass) {
+            case SizeClass::Small:  return syntheticGrid(48, 48, 11);
+            case SizeClass::Medium: return syntheticGrid(384, 384, 12);
+            case SizeClass::Large:  return syntheticGrid(2048, 2048, 13);
+            default:                return syntheticGrid(4096, 2048, 14);
+        }
+    }
+
+    TunedConfig tuneClass(SizeClass sizeClass) const {
+        DungeonGrid grid = probeGrid(sizeClass);
+        // Small grids repeat each run for 2 ms; large ones time single runs
+        bool small = sizeClass == SizeClass::Small || sizeClass == SizeClass::Medium;
+        double minNs = small ? 2e6 : 0;
+        int trials = small ? 3 : 2;
+        TunedConfig best;
+        best.threads = maxThreads;
+        volatile int sink = 0;
+
+        // Tile shape at full thread count; candidates clamped to the grid
+        static const int tileHeights[] = {32, 128, 512};
+        static const int tileWidths[] = {64, 256, 1024};
+        std::vector<std::pair<int, int>> shapes;
+        for (int height : tileHeights) {
+            for (int width : tileWidths) {
+                std::pair<int, int> shape(std::min(height, grid.rows), std::min(width, grid.cols));
+                if (std::find(shapes.begin(), shapes.end(), shape) == shapes.end()) {
+                    shapes.push_back(shape);
+                }
+            }
+        }
+
+        double bestNs = std::numeric_limits<double>::max();
+        for (const auto& shape : shapes) {
+            double ns = bestTimeNs([&]() {
+                sink = DungeonKernels::tiledParallel(grid, shape.first, shape.second, maxThreads);
+            }, minNs, trials);
+            if (ns < bestNs) {
+                bestNs = ns;
+                best.tileRows = shape.first;
+                best.tileCols = shape.second;
+            }
+        }
+
+        // Thread count with that tile: powers of two and the hardware count
+        std::vector<int> threadCounts;
+        for (int threads = 1; threads < maxThreads; threads *= 2) {
+            threadCounts.push_back(threads);
+        }
+        threadCounts.push_back(maxThreads);
+
+        bestNs = std::numeric_limits<double>::max();
+        for (int threads : threadCounts) {
+            double ns = bestTimeNs([&]() {
+                sink = DungeonKernels::tiledParallel(grid, best.tileRows, best.tileCols, threads);
+            }, minNs, trials);
+            if (ns < bestNs) {
+                bestNs = ns;
+                best.threads = threads;
+            }
+        }
+
+        // Lane width. Only the time matters here: on the larger probes the
+        // int16 values saturate, but the results are discarded
+        double ns16 = bestTimeNs([&]() { sink = DungeonKernels::wavefront<int16_t>(grid); },
+                                 minNs, trials);
+        double ns32 = bestTimeNs([&]() { sink = DungeonKernels::wavefront<int32_t>(grid); },
+                                 minNs, trials);
+        best.int16Lanes = ns16 < ns32;
+        return best;
+    }
+
+    static std::vector<std::string> splitTabs(const std::string& line) {
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, '\t')) {
+            fields.push_back(field);
+        }
+        if (fields.empty()) {
+            fields.push_back("");
+        }
+        return fields;
+    }
+};
+
+#endif // DUNGEON_GAME_AUTO_TUNER_H
@@ -0,0 +1,278 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <map>
+#include <cmath>
+#include <cstdlib>
+#include <cerrno>
+#include <algorithm>
+
+#include <sys/stat.h>
+#include <dirent.h>
+
+#include "benchmark_json.h"
+#include "benchmark_stats.h"
+
+using std::vector;
+using std::string;
+using std::map;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/**
+ * Baseline store and regression check for dungeon_benchmark results
+ *
+ *   benchmark_compare save NAME RESULTS.json     store RESULTS.json as NAME
+ *   benchmark_compare compare BASE RESULTS.json  compare against a baseline
+ *   benchmark_compare list                       show stored baselines
+ *
+ * BASE is a stored name or a path to a results file. A case regresses when
+ * the Mann-Whitney U test says the new samples are slower (one-sided
+ * p < alpha) and the median slowed down by more than the threshold; both
+ * are needed, since with many samples even a 0.5% shift is significant.
+ *
+ * Exit status: 0 no regression, 1 regression found, 2 usage or I/O error.
+ */
+
+struct CompareOptions {
+    string store = "benchmark_baselines";
+    double alpha = 0.01;
+    double threshold = 0.05;   // relative median slowdown
+    bool saveIfMissing = false;
+};
+
+static string baselinePath(const CompareOptions& options, const string& name) {
+    if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0) {
+        std::ifstream probe(name);
+        if (probe) {
+            return name;
+        }
+    }
+    return options.store + "/" + name + ".json";
+}
+
+static bool copyFile(const string& from, const string& to) {
+    std::ifstream in(from, std::ios::binary);
+    std::ofstream out(to, std::ios::binary);
+    if (!in || !out) {
+        return false;
+    }
+    out << in.rdbuf();
+    return static_cast<bool>(out);
+}
+
+static int saveBaseline(const CompareOptions& options, const string& name, const string& results) {
+    vector<BenchmarkRecord> records;
+    string error;
+    if (!loadBenchmarkRecords(results, records, error)) {
+        cerr << error << endl;
+        return 2;
+    }
+
+    mkdir(options.store.c_str(), 0755);  // may already exist
+    string path = options.store + "/" + name + ".json";
+    if (!copyFile(results, path)) {
+        cerr << "Cannot write " << path << endl;
+        return 2;
+    }
+    cout << "Saved baseline '" << name << "' (" << records.size() << " cases) to " << path << endl;
+    return 0;
+}
+
+static int listBaselines(const CompareOptions& options) {
+    DIR* dir = opendir(options.store.c_str());
+    if (!dir) {
+        cout << "No baselines in " << options.store << endl;
+        return 0;
+    }
+    vector<string> names;
+    while (dirent* entry = readdir(dir)) {
+        string file = entry->d_name;
+        if (file.size() > 5 && file.compare(file.size() - 5, 5, ".json") == 0) {
+            names.push_back(file.substr(0, file.size() - 5));
+        }
+    }
+    closedir(dir);
+
+    std::sort(names.begin(), names.end());
+    for (const auto& name : names) {
+        cout << name << endl;
+    }
+    return 0;
+}
+
+struct CaseComparison {
+    const BenchmarkRecord* baseline = nullptr;
+    const BenchmarkRecord* current = nullptr;
+    double ratio = 1;
+    MannWhitneyResult test;
+    string verdict;
+};
+
+static int compareRuns(const CompareOptions& options, const string& base, const string& results) {
+    string basePath = baselinePath(options, base);
+    vector<BenchmarkRecord> baseline, current;
+    string error;
+
+    if (!loadBenchmarkRecords(results, current, error)) {
+        cerr << error << endl;
+        return 2;
+    }
+    // Only a baseline that does not exist is replaced: a corrupt one is an
+    // error, not a new reference
+    struct stat info;
+    if (options.saveIfMissing && stat(basePath.c_str(), &info) != 0 && errno == ENOENT) {
+        cout << "No baseline '" << base << "' yet; saving this run as the baseline" << endl;
+        return saveBaseline(options, base, results);
+    }
+    if (!loadBenchmarkRecords(basePath, baseline, error)) {
+        cerr << error << endl;
+        return 2;
+    }
+
+    map<string, const BenchmarkRecord*> baseByKey;
+    for (const auto& record : baseline) {
+        baseByKey[record.key()] = &record;
+    }
+
+    // Group by kernel, then by size within the kernel
+    vector<CaseComparison> comparisons;
+    for (const auto& record : current) {
+        CaseComparison comparison;
+        comparison.current = &record;
+        auto match = baseByKey.find(record.key());
+        if (match == baseByKey.end()) {
+            comparison.verdict = "new";
+        } else {
+            comparison.baseline = match->second;
+            baseByKey.erase(match);
+            comparison.ratio = record.medianNs / comparison.baseline->medianNs;
+            comparison.test = mannWhitneyU(comparison.baseline->samples, record.samples);
+
+            if (comparison.test.pSlower < options.alpha && comparison.ratio > 1 + options.threshold) {
+                comparison.verdict = "REGRESSION";
+            } else if (comparison.test.pTwoSided < options.alpha &&
+                       comparison.ratio < 1 - options.threshold) {
+                comparison.verdict = "faster";
+            } else {
+                comparison.verdict = "same";
+            }
+        }
+        comparisons.push_back(comparison);
+    }
+    std::stable_sort(comparisons.begin(), comparisons.end(),
+                     [](const CaseComparison& a, const CaseComparison& b) {
+        if (a.current->kernel != b.current->kernel) return a.current->kernel < b.current->kernel;
+        return static_cast<double>(a.current->rows) * a.current->cols <
+               static_cast<double>(b.current->rows) * b.current->cols;
+    });
+
+    cout << "Baseline: " << basePath << "\nCurrent:  " << results << endl;
+    cout << "alpha = " << options.alpha << ", threshold = " << options.threshold * 100 << "%\n" << endl;
+    cout << std::left << std::setw(46) << "Case" << std::right
+         << std::setw(14) << "Base (us)" << std::setw(14) << "Current (us)"
+         << std::setw(10) << "Change" << std::setw(11) << "p(slower)" << "  Verdict" << endl;
+    cout << string(108, '-') << endl;
+
+    int regressions = 0;
+    string kernel;
+    map<string, vector<double>> ratiosByKernel;
+    for (const auto& comparison : comparisons) {
+        const BenchmarkRecord& record = *comparison.current;
+        if (record.kernel != kernel) {
+            kernel = record.kernel;
+            cout << kernel << endl;
+        }
+
+        string name = "  " + record.distribution + " " + record.aspect + " " +
+                      std::to_string(record.rows) + "x" + std::to_string(record.cols);
+        cout << std::left << std::setw(46) << name << std::right << std::fixed << std::setprecision(2);
+        if (comparison.baseline) {
+            cout << std::setw(14) << comparison.baseline->medianNs / 1e3
+                 << std::setw(14) << record.medianNs / 1e3
+                 << std::setw(9) << (comparison.ratio - 1) * 100 << "%"
+                 << std::setprecision(4) << std::setw(11) << comparison.test.pSlower;
+            ratiosByKernel[kernel].push_back(comparison.ratio);
+        } else {
+            cout << std::setw(14) << "-" << std::setw(14) << record.medianNs / 1e3
+                 << std::setw(10) << "-" << std::setw(11) << "-";
+        }
+        cout << "  " << comparison.verdict << endl;
+        cout.unsetf(std::ios::fixed);
+
+        if (comparison.verdict == "REGRESSION") {
+            regressions++;
+        }
+    }
+    for (const auto& missing : baseByKey) {
+        cout << "  (missing from current run) " << missing.first << endl;
+    }
+
+    // Per-kernel summary: geometric mean of median ratios
+    cout << "\nPer-kernel change (geometric mean of medians):" << endl;
+    for (const auto& entry : ratiosByKernel) {
+        double logSum = 0;
+        for (double ratio : entry.second) {
+            logSum += std::log(ratio);
+        }
+        double mean = std::exp(logSum / entry.second.size());
+        cout << "  " << std::left << std::setw(16) << entry.first << std::right << std::fixed
+             << std::setprecision(2) << std::showpos << (mean - 1) * 100 << "%" << std::noshowpos
+             << " over " << entry.second.size() << " cases" << endl;
+        cout.unsetf(std::ios::fixed);
+    }
+
+    if (regressions > 0) {
+        cout << "\n" << regressions << " significant regression(s)" << endl;
+        return 1;
+    }
+    cout << "\nNo significant regressions" << endl;
+    return 0;
+}
+
+static void printUsage() {
+    cerr << "Usage:\n"
+         << "  benchmark_compare save NAME RESULTS.json [--store DIR]\n"
+         << "  benchmark_compare compare BASELINE RESULTS.json [--store DIR] [--alpha A]\n"
+         << "                    [--threshold FRACTION] [--save-if-missing]\n"
+         << "  benchmark_compare list [--store DIR]\n";
+}
+
+int main(int argc, char** argv) {
+    CompareOptions options;
+    vector<string> positional;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--store" && hasValue) {
+            options.store = argv[++i];
+        } else if (arg == "--alpha" && hasValue) {
+            options.alpha = std::atof(argv[++i]);
+        } else if (arg == "--threshold" && hasValue) {
+            options.threshold = std::atof(argv[++i]);
+        } else if (arg == "--save-if-missing") {
+            options.saveIfMissing = true;
+        } else if (arg.compare(0, 2, "--") == 0) {
+            printUsage();
+            return 2;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() == 3 && positional[0] == "save") {
+        return saveBaseline(options, positional[1], positional[2]);
+    }
+    if (positional.size() == 3 && positional[0] == "compare") {
+        return compareRuns(options, positional[1], positional[2]);
+    }
+    if (positional.size() == 1 && positional[0] == "list") {
+        return listBaselines(options);
+    }
+    printUsage();
+    return 2;
+}
@@ -0,0 +1,254 @@
+#ifndef DUNGEON_GAME_BENCHMARK_JSON_H
+#define DUNGEON_GAME_BENCHMARK_JSON_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <cstdlib>
+
+// Just enough JSON to read dungeon_benchmark output back in
+struct JsonValue {
+    enum Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Null;
+    bool boolean = false;
+    double number = 0;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue* find(const std::string& key) const {
+        for (const auto& member : members) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+
+    double numberOr(const std::string& key, double fallback) const {
+        const JsonValue* value = find(key);
+        return value && value->type == Number ? value->number : fallback;
+    }
+
+    std::string textOr(const std::string& key, const std::string& fallback) const {
+        const JsonValue* value = find(key);
+        return value && value->type == String ? value->text : fallback;
+    }
+};
+
+class JsonParser {
+private:
+    const std::string& input;
+    size_t pos = 0;
+    std::string error;
+
+public:
+    explicit JsonParser(const std::string& input) : input(input) {}
+
+    bool parse(JsonValue& value) {
+        if (!parseValue(value)) {
+            return false;
+        }
+        skipSpace();
+        return pos == input.size() || fail("trailing characters");
+    }
+
+    const std::string& lastError() const { return error; }
+
+private:
+    bool fail(const std::string& message) {
+        error = message + " at offset " + std::to_string(pos);
+        return false;
+    }
+
+    void skipSpace() {
+        while (pos < input.size() && (input[pos] == ' ' || input[pos] == '\n' ||
+                                      input[pos] == '\r' || input[pos] == '\t')) {
+            pos++;
+        }
+    }
+
+    bool consume(char expected) {
+        skipSpace();
+        if (pos < input.size() && input[pos] == expected) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool parseLiteral(const char* word) {
+        size_t length = std::string(word).size();
+        if (input.compare(pos, length, word) != 0) {
+            return fail(std::string("expected ") + word);
+        }
+        pos += length;
+        return true;
+    }
+
+    bool parseValue(JsonValue& value) {
+        skipSpace();
+        if (pos >= input.size()) {
+            return fail("unexpected end of input");
+        }
+
+        char c = input[pos];
+        if (c == '{') return parseObject(value);
+        if (c == '[') return parseArray(value);
+        if (c == '"') {
+            value.type = JsonValue::String;
+            return parseString(value.text);
+        }
+        if (c == 't' || c == 'f') {
+            value.type = JsonValue::Bool;
+            value.boolean = c == 't';
+            return parseLiteral(c == 't' ? "true" : "false");
+        }
+        if (c == 'n') {
+            value.type = JsonValue::Null;
+            return parseLiteral("null");
+        }
+
+        const char* start = input.c_str() + pos;
+        char* end = nullptr;
+        value.type = JsonValue::Number;
+        value.number = std::strtod(start, &end);
+        if (end == start) {
+            return fail("unexpected character");
+        }
+        pos += end - start;
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        pos++;  // opening quote
+        out.clear();
+        while (pos < input.size() && input[pos] != '"') {
+            char c = input[pos++];
+            if (c == '\\' && pos < input.size()) {
+                char escaped = input[pos++];
+                switch (escaped) {
+                    case 'n': out.push_back('\n'); break;
+                    case 't': out.push_back('\t'); break;
+                    case 'r': out.push_back('\r'); break;
+                    case 'u': out.push_back('?'); pos += 4; break;  // not produced by the benchmark
+                    default:  out.push_back(escaped); break;
+                }
+            } else {
+                out.push_back(c);
+            }
+        }
+        if (pos >= input.size()) {
+            return fail("unterminated string");
+        }
+        pos++;  // closing quote
+        return true;
+    }
+
+    bool parseArray(JsonValue& value) {
+        value.type = JsonValue::Array;
+        pos++;
+        if (consume(']')) {
+            return true;
+        }
+        do {
+            value.items.push_back(JsonValue());
+            if (!parseValue(value.items.back())) {
+                return false;
+            }
+        } while (consume(','));
+        return consume(']') || fail("expected ',' or ']'");
+    }
+
+    bool parseObject(JsonValue& value) {
+        value.type = JsonValue::Object;
+        pos++;
+        if (consume('}')) {
+            return true;
+        }
+        do {
+            skipSpace();
+            if (pos >= input.size() || input[pos] != '"') {
+                return fail("expected member name");
+            }
+            std::string key;
+            if (!parseString(key)) {
+                return false;
+            }
+            if (!consume(':')) {
+                return fail("expected ':'");
+            }
+            value.members.push_back(std::make_pair(key, JsonValue()));
+            if (!parseValue(value.members.back().second)) {
+                return false;
+            }
+        } while (consume(','));
+        return consume('}') || fail("expected ',' or '}'");
+    }
+};
+
+// One case from a dungeon_benchmark run
+struct BenchmarkRecord {
+    std::string kernel;
+    std::string distribution;
+    std::string aspect;
+    int rows = 0;
+    int cols = 0;
+    double medianNs = 0;
+    std::vector<double> samples;
+
+    // Identifies the same case across runs
+    std::string key() const {
+        return kernel + "/" + distribution + "/" + aspect + "/" +
+               std::to_string(rows) + "x" + std::to_string(cols);
+    }
+};
+
+inline bool loadBenchmarkRecords(const std::string& path, std::vector<BenchmarkRecord>& records,
+                                 std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+
+    JsonValue root;
+    JsonParser parser(text);
+    if (!parser.parse(root)) {
+        error = path + ": " + parser.lastError();
+        return false;
+    }
+
+    const JsonValue* results = root.find("results");
+    if (!results || results->type != JsonValue::Array) {
+        error = path + ": no \"results\" array";
+        return false;
+    }
+
+    records.clear();
+    for (const auto& entry : results->items) {
+        BenchmarkRecord record;
+        record.kernel = entry.textOr("kernel", "?");
+        record.distribution = entry.textOr("distribution", "?");
+        record.aspect = entry.textOr("aspect", "?");
+        record.rows = static_cast<int>(entry.numberOr("rows", 0));
+        record.cols = static_cast<int>(entry.numberOr("cols", 0));
+        record.medianNs = entry.numberOr("median_ns", 0);
+        const JsonValue* samples = entry.find("samples_ns");
+        if (samples && samples->type == JsonValue::Array) {
+            for (const auto& sample : samples->items) {
+                record.samples.push_back(sample.number);
+            }
+        }
+        records.push_back(record);
+    }
+    return true;
+}
+
+#endif // DUNGEON_GAME_BENCHMARK_JSON_H
@@ -0,0 +1,25 @@
+# Run by the benchmark_regression test:
+#   cmake -DBENCHMARK=... -DCOMPARE=... -DSTORE=... -DRESULTS=... -P benchmark_regression.cmake
+#
+# Runs a short benchmark and compares it with the "ctest" baseline in STORE.
+# The 25% threshold only catches gross slowdowns; shared CI machines are too
+# noisy for tighter bounds on 0.2 s cases.
+# The first run on a machine has no baseline and records one; delete STORE
+# (or run benchmark_compare save ctest ...) to accept a new baseline.
+
+execute_process(
+    COMMAND ${BENCHMARK} --sizes 256,1024 --aspects square --distributions uniform
+            --kernels scalar1d,wavefront32,fulltable --time 0.2 --json ${RESULTS}
+    OUTPUT_QUIET
+    RESULT_VARIABLE benchmark_status)
+if(NOT benchmark_status EQUAL 0)
+    message(FATAL_ERROR "dungeon_benchmark failed (${benchmark_status})")
+endif()
+
+execute_process(
+    COMMAND ${COMPARE} compare ctest ${RESULTS} --store ${STORE}
+            --alpha 0.001 --threshold 0.25 --save-if-missing
+    RESULT_VARIABLE compare_status)
+if(NOT compare_status EQUAL 0)
+    message(FATAL_ERROR "Benchmark regression against baseline in ${STORE}")
+endif()
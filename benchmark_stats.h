@@ -0,0 +1,163 @@
+#ifndef DUNGEON_GAME_BENCHMARK_STATS_H
+#define DUNGEON_GAME_BENCHMARK_STATS_H
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+
+// Summary of one benchmark case's per-solve times (nanoseconds)
+struct SampleStats {
+    size_t count = 0;
+    double min = 0;
+    double median = 0;
+    double p95 = 0;
+    double mean = 0;
+    double stddev = 0;  // sample standard deviation
+};
+
+// Percentile with linear interpolation between closest ranks; `sorted`
+// must be ascending and non-empty
+inline double percentile(const std::vector<double>& sorted, double fraction) {
+    double rank = fraction * (sorted.size() - 1);
+    size_t below = static_cast<size_t>(rank);
+    size_t above = std::min(below + 1, sorted.size() - 1);
+    return sorted[below] + (rank - below) * (sorted[above] - sorted[below]);
+}
+
+inline SampleStats summarize(std::vector<double> samples) {
+    SampleStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    stats.count = samples.size();
+    stats.min = samples.front();
+    stats.median = percentile(samples, 0.5);
+    stats.p95 = percentile(samples, 0.95);
+
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    stats.mean = sum / samples.size();
+
+    double squares = 0;
+    for (double sample : samples) {
+        squares += (sample - stats.mean) * (sample - stats.mean);
+    }
+    stats.stddev = samples.size() > 1 ? std::sqrt(squares / (samples.size() - 1)) : 0;
+    return stats;
+}
+
+struct MannWhitneyResult {
+    double u = 0;        // U statistic of `current`
+    double z = 0;        // normal approximation, > 0 when current is slower
+    double pSlower = 1;  // one-sided p-value for "current is slower"
+    double pTwoSided = 1;
+};
+
+/**
+ * Mann-Whitney U test between two sets of timings
+ *
+ * Rank-based, so it makes no normality assumption and a few outliers
+ * (page faults, preemption) do not dominate the result the way they do a
+ * t-test. Uses the normal approximation with tie and continuity
+ * corrections, which is accurate from about 8 samples per side; the
+ * benchmark collects at least 10 per case.
+ */
+inline MannWhitneyResult mannWhitneyU(const std::vector<double>& baseline,
+                                      const std::vector<double>& current) {
+    MannWhitneyResult result;
+    size_t n1 = baseline.size();
+    size_t n2 = current.size();
+    if (n1 == 0 || n2 == 0) {
+        return result;
+    }
+
+    // Pool the samples, remembering which side each came from
+    std::vector<std::pair<double, int>> pooled;
+    pooled.reserve(n1 + n2);
+    for (double sample : baseline) pooled.push_back(std::make_pair(sample, 0));
+    for (double sample : current) pooled.push_back(std::make_pair(sample, 1));
+    std::sort(pooled.begin(), pooled.end());
+
+    // Average ranks over ties; collect sum(t^3 - t) for the variance
+    double currentRanks = 0;
+    double tieTerm = 0;
+    for (size_t i = 0; i < pooled.size(); ) {
+        size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first) {
+            j++;
+        }
+        double rank = (i + 1 + j) / 2.0;  // ranks i+1 .. j
+        for (size_t k = i; k < j; k++) {
+            if (pooled[k].second == 1) currentRanks += rank;
+        }
+        double t = static_cast<double>(j - i);
+        tieTerm += t * t * t - t;
+        i = j;
+    }
+
+    double n = static_cast<double>(n1 + n2);
+    result.u = currentRanks - n2 * (n2 + 1) / 2.0;
+    double mean = n1 * n2 / 2.0;
+    double variance = n1 * n2 / 12.0 * ((n + 1) - tieTerm / (n * (n - 1)));
+    if (variance <= 0) {
+        return result;  // every sample identical
+    }
+
+    double delta = result.u - mean;
+    double corrected = delta > 0 ? std::max(0.0, delta - 0.5) : std::min(0.0, delta + 0.5);
+    result.z = corrected / std::sqrt(variance);
+    result.pSlower = 0.5 * std::erfc(result.z / std::sqrt(2.0));
+    result.pTwoSided = std::min(1.0, std::erfc(std::fabs(result.z) / std::sqrt(2.0)));
+    return result;
+}
+
+// time = constant * size^exponent, fitted by least squares on log-log axes
+struct PowerLawFit {
+    size_t points = 0;
+    double exponent = 0;
+    double constant = 0;  // time at size 1, in the units of the input
+    double r2 = 0;        // of the log-log regression
+
+    double predict(double size) const {
+        return constant * std::pow(size, exponent);
+    }
+};
+
+// Points with a non-positive size or time are skipped; fewer than two
+// usable points leave the fit empty (points < 2)
+inline PowerLawFit fitPowerLaw(const std::vector<double>& sizes, const std::vector<double>& times) {
+    PowerLawFit fit;
+    double sx = 0, sy = 0, sxx = 0, sxy = 0, syy = 0;
+    size_t n = 0;
+    for (size_t i = 0; i < sizes.size() && i < times.size(); i++) {
+        if (sizes[i] <= 0 || times[i] <= 0) continue;
+        double x = std::log(sizes[i]);
+        double y = std::log(times[i]);
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+        syy += y * y;
+        n++;
+    }
+    fit.points = n;
+    double varX = n * sxx - sx * sx;
+    if (n < 2 || varX <= 0) {
+        return fit;
+    }
+
+    fit.exponent = (n * sxy - sx * sy) / varX;
+    fit.constant = std::exp((sy - fit.exponent * sx) / n);
+    double varY = n * syy - sy * sy;
+    double covXY = n * sxy - sx * sy;
+    fit.r2 = varY > 0 ? covXY * covXY / (varX * varY) : 1;
+    return fit;
+}
+
+#endif // DUNGEON_GAME_BENCHMARK_STATS_H
@@ -0,0 +1,258 @@
+#ifndef DUNGEON_GAME_CALL_TRACE_H
+#define DUNGEON_GAME_CALL_TRACE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// What a trace record describes
+enum class TraceEvent : uint8_t {
+    SolveBegin,   // row/col hold the grid size
+    Enter,        // recurse(row, col) called
+    Princess,     // returned from the princess room; value = health needed
+    OutOfBounds,  // returned INT_MAX
+    Memoized,     // returned a memoized value
+    Computed,     // returned a freshly computed value
+    SolveEnd,     // value = answer
+    Count
+};
+
+inline const char* traceEventName(TraceEvent event) {
+    switch (event) {
+        case TraceEvent::SolveBegin:  return "solve-begin";
+        case TraceEvent::Enter:       return "enter";
+        case TraceEvent::Princess:    return "princess";
+        case TraceEvent::OutOfBounds: return "out-of-bounds";
+        case TraceEvent::Memoized:    return "memoized";
+        case TraceEvent::Computed:    return "computed";
+        case TraceEvent::SolveEnd:    return "solve-end";
+        default:                      return "unknown";
+    }
+}
+
+// Every event after Enter and before SolveEnd closes the innermost call
+inline bool traceEventReturns(TraceEvent event) {
+    return event == TraceEvent::Princess || event == TraceEvent::OutOfBounds ||
+           event == TraceEvent::Memoized || event == TraceEvent::Computed;
+}
+
+// Fixed-size, 24-byte trace record, written in native byte order
+struct TraceRecord {
+    uint64_t timestampNs;  // steady_clock
+    int32_t row;
+    int32_t col;
+    int32_t value;
+    uint8_t event;         // TraceEvent
+    uint8_t reserved[3];
+};
+static_assert(sizeof(TraceRecord) == 24, "trace records must stay 24 bytes");
+
+/**
+ * Trace file layout
+ *
+ *   header:  "DGTRACE" NUL, uint32 version, uint32 record size
+ *   blocks:  uint32 thread, uint32 count, then `count` TraceRecords
+ *
+ * Each block holds consecutive records of one thread, so a reader follows
+ * every thread's call stack by keeping one stack per thread id.
+ */
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+struct TraceBlockHeader {
+    uint32_t thread;
+    uint32_t count;
+};
+
+static const char kTraceMagic[8] = {'D', 'G', 'T', 'R', 'A', 'C', 'E', '\0'};
+static const uint32_t kTraceVersion = 1;
+
+/**
+ * Single-producer, single-consumer ring of trace records
+ *
+ * The traced thread pushes, the tracer's writer thread drains. Head and
+ * tail are free-running counters, so head - tail is the fill level with no
+ * wrap-around case. The producer caches the tail it last saw and only
+ * rereads it when the ring looks full; when the ring really is full it
+ * yields until the writer catches up, so no record is dropped.
+ */
+class TraceRing {
+public:
+    static const size_t kCapacity = 1 << 16;  // records, 1.5 MB
+
+private:
+    std::unique_ptr<TraceRecord[]> records;
+    std::atomic<uint64_t> head;  // written by the producer
+    uint64_t cachedTail = 0;
+    uint64_t stalls = 0;
+    char separator[64];          // keeps head and tail on different cache lines
+    std::atomic<uint64_t> tail;  // written by the consumer
+    uint32_t threadId;
+
+public:
+    explicit TraceRing(uint32_t threadId)
+        : records(new TraceRecord[kCapacity]), head(0), tail(0), threadId(threadId) {}
+
+    uint32_t thread() const { return threadId; }
+    uint64_t stallCount() const { return stalls; }
+
+    void push(TraceEvent event, int row, int col, int value) {
+        uint64_t position = head.load(std::memory_order_relaxed);
+        if (position - cachedTail == kCapacity) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            while (position - cachedTail == kCapacity) {
+                stalls++;
+                std::this_thread::yield();
+                cachedTail = tail.load(std::memory_order_acquire);
+            }
+        }
+
+        TraceRecord& record = records[position & (kCapacity - 1)];
+        record.timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        record.row = row;
+        record.col = col;
+        record.value = value;
+        record.event = static_cast<uint8_t>(event);
+        std::memset(record.reserved, 0, sizeof(record.reserved));
+        head.store(position + 1, std::memory_order_release);
+    }
+
+    // Consumer side: write up to one contiguous run of at least minRecords
+    // as a block; returns the number of records written
+    size_t drainTo(std::FILE* out, size_t minRecords) {
+        uint64_t start = tail.load(std::memory_order_relaxed);
+        uint64_t end = head.load(std::memory_order_acquire);
+        size_t available = static_cast<size_t>(end - start);
+        if (available == 0 || available < minRecords) {
+            return 0;
+        }
+
+        size_t offset = static_cast<size_t>(start & (kCapacity - 1));
+        size_t count = std::min(available, kCapacity - offset);
+        TraceBlockHeader block = {threadId, static_cast<uint32_t>(count)};
+        std::fwrite(&block, sizeof(block), 1, out);
+        std::fwrite(&records[offset], sizeof(TraceRecord), count, out);
+        tail.store(start + count, std::memory_order_release);
+        return count;
+    }
+};
+
+/**
+ * Binary call tracer with one lock-free ring per traced thread
+ *
+ * A background writer thread moves records from the rings to the file in
+ * blocks of a quarter ring (16K records, 384 KB) or more, so the traced
+ * code never formats text or touches the file. Rings are created the first
+ * time a thread asks for one; that, not recording, is the only step that
+ * takes the mutex. finish() (or the destructor) drains everything left.
+ */
+class CallTracer {
+private:
+    static const size_t kBlockRecords = TraceRing::kCapacity / 4;
+
+    std::FILE* file = nullptr;
+    std::mutex ringsMutex;
+    std::vector<std::unique_ptr<TraceRing>> rings;
+    std::vector<std::thread::id> owners;
+    std::atomic<bool> stopping;
+    std::thread writer;
+    uint64_t recordsWritten = 0;
+
+public:
+    explicit CallTracer(const std::string& path) : stopping(false) {
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            return;
+        }
+        TraceFileHeader header;
+        std::memcpy(header.magic, kTraceMagic, sizeof(header.magic));
+        header.version = kTraceVersion;
+        header.recordSize = sizeof(TraceRecord);
+        std::fwrite(&header, sizeof(header), 1, file);
+        writer = std::thread([this]() { writerLoop(); });
+    }
+
+    ~CallTracer() {
+        finish();
+    }
+
+    CallTracer(const CallTracer&) = delete;
+    CallTracer& operator=(const CallTracer&) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+
+    // The calling thread's ring; look it up once per solve, not per call
+    TraceRing& threadRing() {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        std::thread::id self = std::this_thread::get_id();
+        for (size_t i = 0; i < owners.size(); i++) {
+            if (owners[i] == self) {
+                return *rings[i];
+            }
+        }
+        owners.push_back(self);
+        rings.emplace_back(new TraceRing(static_cast<uint32_t>(rings.size())));
+        return *rings.back();
+    }
+
+    // Stops the writer, drains every ring and closes the file
+    void finish() {
+        if (!file) {
+            return;
+        }
+        stopping.store(true);
+        writer.join();
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (auto& ring : rings) {
+            while (size_t written = ring->drainTo(file, 1)) {
+                recordsWritten += written;
+            }
+        }
+        std::fclose(file);
+        file = nullptr;
+    }
+
+    // Valid after finish()
+    uint64_t records() const { return recordsWritten; }
+
+    // Times a traced thread found its ring full; read after finish()
+    uint64_t producerStalls() {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        uint64_t total = 0;
+        for (auto& ring : rings) {
+            total += ring->stallCount();
+        }
+        return total;
+    }
+
+private:
+    void writerLoop() {
+        while (!stopping.load()) {
+            size_t written = 0;
+            {
+                std::lock_guard<std::mutex> lock(ringsMutex);
+                for (auto& ring : rings) {
+                    written += ring->drainTo(file, kBlockRecords);
+                }
+            }
+            recordsWritten += written;
+            if (written == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+        }
+    }
+};
+
+#endif // DUNGEON_GAME_CALL_TRACE_H
@@ -1,13 +1,19 @@
 #include <iostream>
+#include <fstream>
 #include <vector>
 #include <climits>
 #include <string>
-#include <fstream>
+#include <chrono>
+#include <cstdlib>
+
+#include "call_trace.h"
+#include "trace_reader.h"
 
 using std::vector;
 using std::max;
 using std::min;
 using std::cout;
+using std::cerr;
 using std::endl;
 using std::string;
 using std::ofstream;
@@ -15,171 +21,179 @@ using std::ofstream;
 // DungeonGame class with call tracing
 class DungeonGame {
 private:
-    int callDepth = 0;
-    ofstream* traceFile = nullptr;
-    
-    void logCall(const string& functionName, int row, int col, const string& action = "") {
-        if (traceFile) {
-            string indent(callDepth * 2, ' ');
-            *traceFile << indent << functionName << "(" << row << "," << col << ")" << action << endl;
-        }
-    }
-    
+    CallTracer* tracer = nullptr;
+
 public:
-    void setTraceFile(ofstream* file) {
-        traceFile = file;
+    void setTracer(CallTracer* callTracer) {
+        tracer = callTracer;
     }
-    
-    int recurse(int row, int col, const vector<vector<int>>& dungeon, 
-                vector<vector<int>>& memo) {
-        
-        callDepth++;
-        logCall("recurse", row, col, " - ENTER");
-        
+
+    // `ring` is null when tracing is off
+    int recurse(int row, int col, const vector<vector<int>>& dungeon,
+                vector<vector<int>>& memo, TraceRing* ring) {
+
+        if (ring) ring->push(TraceEvent::Enter, row, col, 0);
+
         int rows = dungeon.size();
         int cols = dungeon[0].size();
 
         // Base case: reached princess
         if(row == rows - 1 && col == cols - 1) {
             int result = max(1, 1 - dungeon[row][col]);
-            logCall("recurse", row, col, " - PRINCESS ROOM, health needed: " + std::to_string(result));
-            callDepth--;
+            if (ring) ring->push(TraceEvent::Princess, row, col, result);
             return result;
         }
 
         // Out of bounds
         if(row >= rows || col >= cols) {
-            logCall("recurse", row, col, " - OUT OF BOUNDS");
-            callDepth--;
+            if (ring) ring->push(TraceEvent::OutOfBounds, row, col, INT_MAX);
             return INT_MAX;
         }
 
         // Already computed
         if(memo[row][col] != INT_MIN) {
-            logCall("recurse", row, col, " - MEMOIZED: " + std::to_string(memo[row][col]));
-            callDepth--;
+            if (ring) ring->push(TraceEvent::Memoized, row, col, memo[row][col]);
             return memo[row][col];
         }
 
         // Explore paths
-        logCall("recurse", row, col, " - EXPLORING PATHS");
-        
-        int goRight = recurse(row, col + 1, dungeon, memo);
-        int goDown = recurse(row + 1, col, dungeon, memo);
+        int goRight = recurse(row, col + 1, dungeon, memo, ring);
+        int goDown = recurse(row + 1, col, dungeon, memo, ring);
 
         int minimumHealth = min(goRight, goDown) - dungeon[row][col];
         memo[row][col] = max(1, minimumHealth);
-        
-        logCall("recurse", row, col, " - COMPUTED: " + std::to_string(memo[row][col]) + 
-                " (right=" + std::to_string(goRight) + ", down=" + std::to_string(goDown) + 
-                ", cell=" + std::to_string(dungeon[row][col]) + ")");
-        
-        callDepth--;
+
+        if (ring) ring->push(TraceEvent::Computed, row, col, memo[row][col]);
         return memo[row][col];
     }
 
     int calculateMinimumHP(vector<vector<int>>& dungeon) {
         int rows = dungeon.size();
         int cols = dungeon[0].size();
-        
+
         vector<vector<int>> memo(rows, vector<int>(cols, INT_MIN));
-        
-        if (traceFile) {
-            *traceFile << "=== DUNGEON GAME CALL TRACE ===" << endl;
-            *traceFile << "Grid size: " << rows << "x" << cols << endl;
-            *traceFile << "Dungeon:" << endl;
-            for (int i = 0; i < rows; i++) {
-                *traceFile << "  [";
-                for (int j = 0; j < cols; j++) {
-                    *traceFile << dungeon[i][j];
-                    if (j < cols - 1) *traceFile << ", ";
-                }
-                *traceFile << "]" << endl;
-            }
-            *traceFile << endl;
-        }
 
-        return recurse(0, 0, dungeon, memo);
+        TraceRing* ring = tracer ? &tracer->threadRing() : nullptr;
+        if (ring) ring->push(TraceEvent::SolveBegin, rows, cols, 0);
+        int result = recurse(0, 0, dungeon, memo, ring);
+        if (ring) ring->push(TraceEvent::SolveEnd, 0, 0, result);
+        return result;
     }
 };
 
-// Function to generate DOT file for callgraph visualization
-void generateCallGraphDot(const string& traceFile, const string& dotFile) {
-    // This is a simplified version - in practice you'd parse the trace file
-    // and generate a proper DOT graph
-    ofstream dot(dotFile);
-    dot << "digraph CallGraph {" << endl;
-    dot << "  rankdir=TD;" << endl;
-    dot << "  node [shape=box, style=filled, fillcolor=lightblue];" << endl;
-    dot << "  edge [color=blue];" << endl;
-    dot << endl;
-    
-    // For the 2x2 example, we know the structure
-    dot << "  \"calculateMinimumHP\" [fillcolor=lightgreen];" << endl;
-    dot << "  \"recurse(0,0)\" [fillcolor=yellow];" << endl;
-    dot << "  \"recurse(0,1)\" [fillcolor=yellow];" << endl;
-    dot << "  \"recurse(1,0)\" [fillcolor=yellow];" << endl;
-    dot << "  \"recurse(1,1)\" [fillcolor=orange, label=\"recurse(1,1)\\nPrincess Room\"];" << endl;
-    dot << "  \"recurse(0,2)\" [fillcolor=red, label=\"recurse(0,2)\\nOut of Bounds\"];" << endl;
-    dot << "  \"recurse(1,2)\" [fillcolor=red, label=\"recurse(1,2)\\nOut of Bounds\"];" << endl;
-    dot << "  \"recurse(2,0)\" [fillcolor=red, label=\"recurse(2,0)\\nOut of Bounds\"];" << endl;
-    dot << "  \"recurse(2,1)\" [fillcolor=red, label=\"recurse(2,1)\\nOut of Bounds\"];" << endl;
-    dot << endl;
-    
-    // Edges
-    dot << "  \"calculateMinimumHP\" -> \"recurse(0,0)\";" << endl;
-    dot << "  \"recurse(0,0)\" -> \"recurse(0,1)\";" << endl;
-    dot << "  \"recurse(0,0)\" -> \"recurse(1,0)\";" << endl;
-    dot << "  \"recurse(0,1)\" -> \"recurse(0,2)\";" << endl;
-    dot << "  \"recurse(0,1)\" -> \"recurse(1,1)\";" << endl;
-    dot << "  \"recurse(1,0)\" -> \"recurse(1,1)\";" << endl;
-    dot << "  \"recurse(1,0)\" -> \"recurse(2,0)\";" << endl;
-    dot << "  \"recurse(1,1)\" -> \"recurse(1,2)\";" << endl;
-    dot << "  \"recurse(1,1)\" -> \"recurse(2,1)\";" << endl;
-    dot << endl;
-    
-    dot << "}" << endl;
-    dot.close();
+// Decodes a binary trace into the text trace and the DOT call graph
+static bool renderTrace(const string& tracePath, const string& textPath, const string& dotPath) {
+    TraceReader reader(tracePath);
+    ofstream text;
+    if (!textPath.empty()) {
+        text.open(textPath);
+    }
+    TraceTextWriter textWriter(text);
+    CallGraphAggregate graph;
+
+    bool ok = reader.forEach([&](uint32_t thread, const TraceRecord& record) {
+        if (!textPath.empty()) textWriter.add(thread, record);
+        graph.add(thread, record);
+    });
+    if (!ok) {
+        cerr << reader.lastError() << endl;
+        return false;
+    }
+
+    ofstream dot(dotPath);
+    graph.writeDot(dot);
+    return static_cast<bool>(dot);
 }
 
-int main() {
+// Traces one size x size solve and compares it with an untraced one
+static int traceLargeGrid(int size) {
+    vector<vector<int>> dungeon(size, vector<int>(size));
+    srand(42);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            dungeon[i][j] = rand() % 21 - 10;
+        }
+    }
+
     DungeonGame game;
-    
+    auto start = std::chrono::steady_clock::now();
+    int plain = game.calculateMinimumHP(dungeon);
+    double plainMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    CallTracer tracer("callgraph_trace.bin");
+    if (!tracer.isOpen()) {
+        cerr << "Cannot write callgraph_trace.bin" << endl;
+        return 1;
+    }
+    game.setTracer(&tracer);
+    start = std::chrono::steady_clock::now();
+    int traced = game.calculateMinimumHP(dungeon);
+    tracer.finish();
+    double tracedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    cout << size << "x" << size << " grid, minimum HP " << traced
+         << (traced == plain ? "" : " (MISMATCH)") << endl;
+    cout << "Untraced solve: " << plainMs << " ms" << endl;
+    cout << "Traced solve:   " << tracedMs << " ms, " << tracer.records() << " records ("
+         << tracer.records() * sizeof(TraceRecord) / (1024.0 * 1024.0) << " MB), "
+         << tracer.producerStalls() << " ring-full stalls" << endl;
+
+    if (!renderTrace("callgraph_trace.bin", "", "callgraph.dot")) {
+        return 1;
+    }
+    cout << "Binned call graph written to callgraph.dot" << endl;
+    cout << "Heatmap: ./trace_analyze heatmap callgraph_trace.bin heatmap.pgm" << endl;
+    return traced == plain ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && string(argv[1]) == "--size") {
+        return traceLargeGrid(std::atoi(argv[2]));
+    }
+
+    DungeonGame game;
+
     // Test case: 2x2 grid
     vector<vector<int>> dungeon = {
         {-3, 5},
         {1, -4}
     };
-    
-    // Create trace file
-    ofstream traceFile("callgraph_trace.txt");
-    game.setTraceFile(&traceFile);
-    
+
     cout << "Generating callgraph for 2x2 dungeon..." << endl;
     cout << "Dungeon grid:" << endl;
     cout << "  [-3,  5]" << endl;
     cout << "  [ 1, -4]" << endl;
     cout << endl;
-    
-    int result = game.calculateMinimumHP(dungeon);
-    
-    traceFile << endl << "=== FINAL RESULT ===" << endl;
-    traceFile << "Minimum HP needed: " << result << endl;
-    traceFile.close();
-    
+
+    int result;
+    {
+        CallTracer tracer("callgraph_trace.bin");
+        if (!tracer.isOpen()) {
+            cerr << "Cannot write callgraph_trace.bin" << endl;
+            return 1;
+        }
+        game.setTracer(&tracer);
+        result = game.calculateMinimumHP(dungeon);
+        tracer.finish();
+    }
+
     cout << "Minimum HP needed: " << result << endl;
+    cout << "Binary trace saved to: callgraph_trace.bin" << endl;
+
+    // Decode the trace into the text trace and the DOT call graph
+    if (!renderTrace("callgraph_trace.bin", "callgraph_trace.txt", "callgraph.dot")) {
+        return 1;
+    }
     cout << "Call trace saved to: callgraph_trace.txt" << endl;
-    
-    // Generate DOT file for visualization
-    generateCallGraphDot("callgraph_trace.txt", "callgraph.dot");
     cout << "DOT file generated: callgraph.dot" << endl;
     cout << endl;
-    
+
     cout << "To visualize the callgraph:" << endl;
     cout << "1. Install Graphviz: brew install graphviz" << endl;
     cout << "2. Generate PNG: dot -Tpng callgraph.dot -o callgraph.png" << endl;
     cout << "3. Generate SVG: dot -Tsvg callgraph.dot -o callgraph.svg" << endl;
     cout << "4. View the trace: cat callgraph_trace.txt" << endl;
-    
+    cout << "5. Trace a large grid: ./callgraph_generator --size 1000" << endl;
+
     return 0;
 }
@@ -8,6 +8,9 @@
 #include <algorithm>
 #include <cmath>
 
+#include "alloc_hooks.h"
+#include "dungeon_generator.h"
+
 using std::vector;
 using std::max;
 using std::min;
@@ -606,32 +609,60 @@ public:
     }
     
     void memoryAnalysis() {
-        cout << "\n=== MEMORY COMPLEXITY ANALYSIS ===" << endl;
-        
-        vector<int> sizes = {10, 50, 100, 500, 1000};
+        cout << "\n=== MEMORY ANALYSIS (measured per solve) ===" << endl;
+        cout << "Model = size*size*sizeof(int) style estimate; the rest is counted by the" << endl;
+        cout << "global new/delete hooks, including per-row vector headers and queue growth." << endl;
+        
+        cout << std::left << std::setw(14) << "Solver"
+             << std::setw(11) << "Grid"
+             << std::right << std::setw(10) << "Model"
+             << std::setw(9) << "Allocs"
+             << std::setw(12) << "Allocated"
+             << std::setw(12) << "Peak live"
+             << std::setw(10) << "vs model" << endl;
+        cout << std::string(78, '-') << endl;
+        
+        for (int size : {10, 100, 1000}) {
+            size_t cells = static_cast<size_t>(size) * size;
+            measureMemory("2D DP", size, cells * sizeof(int),
+                          [&](vector<vector<int>>& d) { return original.calculateMinimumHP(d); });
+            measureMemory("1D DP", size, size * sizeof(int),
+                          [&](vector<vector<int>>& d) { return optimized.calculateMinimumHP(d); });
+            measureMemory("In-Place DP", size, 0,
+                          [&](vector<vector<int>>& d) { return inPlace.calculateMinimumHP(d); });
+        }
         
-        cout << std::left << std::setw(10) << "Grid Size" 
-             << std::setw(15) << "2D DP Memory" 
-             << std::setw(15) << "1D DP Memory" 
-             << std::setw(17) << "In-Place Memory" 
-             << std::setw(12) << "1D Reduction"
-             << std::setw(15) << "In-Place Reduction" << endl;
-        cout << std::string(84, '-') << endl;
+        // Graph searches: no simple model, and too slow for the large grids
+        for (int size : {10, 25}) {
+            measureMemory("BFS", size, 0, [&](vector<vector<int>>& d) { return bfs.calculateMinimumHP(d); });
+            measureMemory("DFS", size, 0, [&](vector<vector<int>>& d) { return dfs.calculateMinimumHP(d); });
+            measureMemory("Dijkstra", size, 0, [&](vector<vector<int>>& d) { return dijkstra.calculateMinimumHP(d); });
+            measureMemory("Bellman-Ford", size, 0, [&](vector<vector<int>>& d) { return bellmanFord.calculateMinimumHP(d); });
+            measureMemory("A*", size, 0, [&](vector<vector<int>>& d) { return aStar.calculateMinimumHP(d); });
+        }
         
-        for (int size : sizes) {
-            size_t memory2D = size * size * sizeof(int);
-            size_t memory1D = size * sizeof(int);
-            size_t memoryInPlace = 0; // Only uses input array
-            double reduction1D = (double)(memory2D - memory1D) / memory2D * 100;
-            double reductionInPlace = 100.0; // 100% reduction in extra memory
-            
-            cout << std::left << std::setw(10) << (std::to_string(size) + "x" + std::to_string(size))
-                 << std::setw(15) << formatBytes(memory2D)
-                 << std::setw(15) << formatBytes(memory1D)
-                 << std::setw(17) << formatBytes(memoryInPlace)
-                 << std::setw(12) << (std::to_string((int)reduction1D) + "%")
-                 << std::setw(15) << (std::to_string((int)reductionInPlace) + "%") << endl;
+        AllocationStats last = measureAllocations([]() {});
+        cout << "Peak RSS " << (last.rssPerSolve ? "(current)" : "(process lifetime)") << ": "
+             << formatBytes(last.peakRssBytes) << endl;
+    }
+    
+    template<typename AlgorithmFunc>
+    void measureMemory(const std::string& name, int size, size_t model, AlgorithmFunc func) {
+        vector<vector<int>> dungeon = generateRandomDungeon(size, size);
+        AllocationStats stats = measureAllocations([&]() { func(dungeon); });
+        
+        cout << std::left << std::setw(14) << name
+             << std::setw(11) << (std::to_string(size) + "x" + std::to_string(size))
+             << std::right << std::setw(10) << (model > 0 || name == "In-Place DP" ? formatBytes(model) : "-")
+             << std::setw(9) << stats.allocations
+             << std::setw(12) << formatBytes(stats.bytes)
+             << std::setw(12) << formatBytes(static_cast<size_t>(stats.peakLiveBytes));
+        if (model > 0) {
+            cout << std::setw(9) << std::fixed << std::setprecision(2)
+                 << static_cast<double>(stats.peakLiveBytes) / model << "x";
+            cout.unsetf(std::ios::fixed);
         }
+        cout << endl;
     }
     
     void algorithmAnalysis() {
@@ -697,14 +728,8 @@ public:
     
 private:
     vector<vector<int>> generateRandomDungeon(int rows, int cols) {
-        vector<vector<int>> dungeon(rows, vector<int>(cols));
-        srand(42);  // Fixed seed for reproducible results
-        for (int i = 0; i < rows; i++) {
-            for (int j = 0; j < cols; j++) {
-                dungeon[i][j] = (rand() % 21) - 10;  // -10 to 10
-            }
-        }
-        return dungeon;
+        // -10 to 10, fixed seed: the same grid on every platform
+        return DungeonGenerator(GeneratorSpec::make(DungeonFamily::Uniform, rows, cols, 42)).generate().toNested();
     }
     
     std::string formatBytes(size_t bytes) {
@@ -715,14 +740,15 @@ private:
     
     template<typename AlgorithmFunc>
     double benchmarkAlgorithm(AlgorithmFunc func, const vector<vector<int>>& dungeon, int iterations) {
-        auto start = std::chrono::high_resolution_clock::now();
+        // Copy before timing: some solvers modify their input. Quick numbers
+        // only; dungeon_benchmark has warmup and proper statistics.
+        vector<vector<vector<int>>> copies(iterations, dungeon);
+        auto start = std::chrono::steady_clock::now();
         for (int i = 0; i < iterations; i++) {
-            vector<vector<int>> testDungeon = dungeon;
-            func(testDungeon);
+            func(copies[i]);
         }
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-        return duration.count() / double(iterations);
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
     }
 };
 
@@ -3,26 +3,1180 @@
 #include <chrono>
 #include <iomanip>
 #include <climits>
+#include <cmath>
+#include <limits>
+#include <cstdlib>
+#include <string>
+#include <sstream>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
 
-// Include all algorithm classes by copying their implementations
-// This is a comprehensive comparison of all approaches
-
-// [Previous DP implementations would be included here]
-// For brevity, I'll include simplified versions that call the actual executables
+#include "adaptive_solver.h"
+#include "kernel_timing.h"
+#include "benchmark_stats.h"
+#include "search_workspace.h"
+#include "forward_sweep.h"
+#include "indexed_heap.h"
+#include "alloc_hooks.h"
 
 using std::vector;
+using std::pair;
+using std::max;
+using std::min;
 using std::cout;
+using std::cerr;
 using std::endl;
+using std::string;
+
+/**
+ * Empirical complexity of every solver
+ *
+ * Each solver runs on geometrically growing grids (the side doubles from
+ * 16) in three shapes with the same cell count: square, wide (1:16) and
+ * tall (16:1). A solver stops growing in a shape once one solve takes
+ * longer than --max-solve-ms or the grid passes --max-cells. Time per
+ * solve is the minimum of at least three solves; the first also records
+ * the peak heap above the input.
+ *
+ * time = C * cells^k is fitted on log-log axes over the largest points of
+ * each shape, where constant overheads matter least, and k is compared
+ * with the exponent the textbook claim implies (log factors count as
+ * exponent 1; the claims are those this file used to print). The square
+ * fits then extrapolate time and heap to the --production sizes, and any
+ * solver over --deadline-ms or --memory-mb there is reported as failing.
+ *
+ *   comprehensive_algorithm_analysis [--solvers a,b] [--aspects a,b]
+ *       [--max-cells N] [--max-solve-ms MS] [--time SECONDS]
+ *       [--production N,N] [--deadline-ms MS] [--memory-mb MB] [--verbose] [--strict]
+ *
+ * Every answer is checked against scalar1d. A solver that disagrees is
+ * reported as wrong in the tables and the summary; with --strict the exit
+ * status is then 1.
+ */
+
+// Recursive memoized 2D DP, copied from dungeon-game.cpp
+class DungeonGame {
+public:
+    int recurse(int row, int col, const vector<vector<int>>& dungeon,
+                vector<vector<int>>& memo) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        if (row == rows - 1 && col == cols - 1) {
+            return max(1, 1 - dungeon[row][col]);
+        }
+
+        if (row >= rows || col >= cols) {
+            return INT_MAX;
+        }
+
+        if (memo[row][col] != INT_MIN) {
+            return memo[row][col];
+        }
+
+        int goRight = recurse(row, col + 1, dungeon, memo);
+        int goDown = recurse(row + 1, col, dungeon, memo);
+
+        int minimumHealth = min(goRight, goDown) - dungeon[row][col];
+        memo[row][col] = max(1, minimumHealth);
+
+        return memo[row][col];
+    }
+
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        vector<vector<int>> memo(rows, vector<int>(cols, INT_MIN));
+
+        return recurse(0, 0, dungeon, memo);
+    }
+};
+
+// Top-down DungeonGame without recursion, copied from dungeon-game.cpp
+//
+// Same recurrence and memo semantics as DungeonGame::recurse, but cells are
+// resolved with an explicit stack, so grid size cannot overflow the call
+// stack. The memo is one flat array with an extra padding column and row:
+// out-of-bounds neighbours read INT_MAX and the princess's two virtual
+// neighbours read 1, so no bounds checks are needed. The grid is resolved
+// tile by tile from the bottom-right; since everything right of and below
+// a tile is already known, each tile's search stays inside it and the
+// stack never holds more than about 2 * (tile height + tile width) cells.
+class DungeonGameIterative {
+private:
+    static const int kTile = 64;
+
+    int* memo = nullptr;        // memoStore's or the caller's workspace's
+    vector<int> memoStore;
+    vector<size_t> pending;     // kept across calls
+
+public:
+    // With a workspace (solver_workspace.h) the memo comes from it instead
+    // of the solver, so one solver need not hold the largest grid's memo
+    int calculateMinimumHP(vector<vector<int>>& dungeon, Workspace* workspace = nullptr) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+        size_t stride = cols + 1;
+        size_t cells = static_cast<size_t>(rows + 1) * stride;
+
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        if (workspace) {
+            memo = scratch.allocate<int>(cells, INT_MIN);
+        } else {
+            memoStore.assign(cells, INT_MIN);
+            memo = memoStore.data();
+        }
+        for (int row = 0; row <= rows; row++) {
+            memo[row * stride + cols] = INT_MAX;
+        }
+        for (int col = 0; col < cols; col++) {
+            memo[rows * stride + col] = INT_MAX;
+        }
+        memo[(rows - 1) * stride + cols] = 1;
+        memo[rows * stride + cols - 1] = 1;
+
+        for (int tileRow = (rows - 1) / kTile * kTile; tileRow >= 0; tileRow -= kTile) {
+            for (int tileCol = (cols - 1) / kTile * kTile; tileCol >= 0; tileCol -= kTile) {
+                resolve(tileRow, tileCol, dungeon, stride);
+            }
+        }
+
+        return memo[0];
+    }
+
+private:
+    // Depth-first evaluation of recurse(row, col) on an explicit stack
+    void resolve(int row, int col, const vector<vector<int>>& dungeon, size_t stride) {
+        pending.clear();
+        pending.push_back(row * stride + col);
+
+        while (!pending.empty()) {
+            size_t cell = pending.back();
+            if (memo[cell] != INT_MIN) {
+                pending.pop_back();
+                continue;
+            }
+
+            int goRight = memo[cell + 1];
+            int goDown = memo[cell + stride];
+
+            // Evaluate unresolved subproblems first, right before down
+            if (goRight == INT_MIN || goDown == INT_MIN) {
+                if (goDown == INT_MIN) pending.push_back(cell + stride);
+                if (goRight == INT_MIN) pending.push_back(cell + 1);
+                continue;
+            }
+
+            int minimumHealth = min(goRight, goDown) - dungeon[cell / stride][cell % stride];
+            memo[cell] = max(1, minimumHealth);
+            pending.pop_back();
+        }
+    }
+};
+
+// Parallel lazy top-down DungeonGame, copied from simple_tests.cpp
+//
+// Fork-join version of DungeonGame::recurse for queries that only need
+// part of the table, e.g. minimum health from an interior start cell.
+// A task for cell (row, col) spawns its right and down subproblems as
+// tasks and finishes once both are known, so only cells reachable from
+// the query are ever evaluated.
+//
+// Memo cells are atomics with two reserved states: kEmpty (never claimed)
+// and kComputing (claimed by a task). A cell is claimed with a single
+// compare-and-swap, so exactly one task ever computes it. A task whose
+// subproblem is being computed by another thread is requeued, and its
+// worker runs or steals other tasks meanwhile instead of spinning.
+// The memo is padded like DungeonGameIterative's and survives between
+// queries on the same dungeon.
+class DungeonGameParallel {
+private:
+    static const int kEmpty = INT_MIN;
+    static const int kComputing = INT_MIN + 1;
+
+    struct WorkQueue {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+
+    const vector<vector<int>>* grid = nullptr;
+    size_t stride = 0;
+    std::unique_ptr<std::atomic<int>[]> memo;
+    std::unique_ptr<WorkQueue[]> queues;
+    int workers = 1;
+
+public:
+    int calculateMinimumHP(vector<vector<int>>& dungeon, int threads = 0) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        load(dungeon);
+        return minimumHPFrom(0, 0, threads);
+    }
+
+    // Reset the memo for a new dungeon; the dungeon must outlive the queries
+    void load(const vector<vector<int>>& dungeon) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        grid = &dungeon;
+        stride = cols + 1;
+        memo.reset(new std::atomic<int>[(rows + 1) * stride]);
+
+        for (size_t cell = 0; cell < (rows + 1) * stride; cell++) {
+            memo[cell].store(kEmpty, std::memory_order_relaxed);
+        }
+        for (int row = 0; row <= rows; row++) {
+            memo[row * stride + cols].store(INT_MAX, std::memory_order_relaxed);
+        }
+        for (int col = 0; col < cols; col++) {
+            memo[rows * stride + col].store(INT_MAX, std::memory_order_relaxed);
+        }
+        memo[(rows - 1) * stride + cols].store(1, std::memory_order_relaxed);
+        memo[rows * stride + cols - 1].store(1, std::memory_order_relaxed);
+    }
+
+    // Minimum health needed when starting at (row, col) of the loaded dungeon
+    int minimumHPFrom(int row, int col, int threads = 0) {
+        size_t root = row * stride + col;
+
+        int expected = kEmpty;
+        if (!memo[root].compare_exchange_strong(expected, kComputing)) {
+            return memo[root].load();  // answered by an earlier query
+        }
+
+        workers = threads > 0 ? threads : max(1u, std::thread::hardware_concurrency());
+        queues.reset(new WorkQueue[workers]);
+        queues[0].tasks.push_back(root);
+
+        vector<std::thread> helpers;
+        for (int worker = 1; worker < workers; worker++) {
+            helpers.push_back(std::thread(&DungeonGameParallel::work, this, worker, root));
+        }
+        work(0, root);
+        for (auto& helper : helpers) {
+            helper.join();
+        }
+
+        return memo[root].load();
+    }
+
+private:
+    static bool isKnown(int value) {
+        return value != kEmpty && value != kComputing;
+    }
+
+    void work(int self, size_t root) {
+        while (!isKnown(memo[root].load(std::memory_order_acquire))) {
+            size_t cell;
+            if (popOwn(self, cell) || steal(self, cell)) {
+                run(self, cell);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Advance one claimed cell: compute it, or fork its missing subproblems
+    void run(int self, size_t cell) {
+        int goRight = claimOrRead(cell + 1);
+        int goDown = claimOrRead(cell + stride);
+
+        if (isKnown(goRight) && isKnown(goDown)) {
+            int value = (*grid)[cell / stride][cell % stride];
+            int minimumHealth = min(goRight, goDown) - value;
+            memo[cell].store(max(1, minimumHealth), std::memory_order_release);
+            return;
+        }
+
+        WorkQueue& queue = queues[self];
+        std::lock_guard<std::mutex> guard(queue.lock);
+
+        if (goRight == kEmpty || goDown == kEmpty) {
+            // Fork: requeue this cell as a continuation beneath its new
+            // children, which run first (right before down)
+            queue.tasks.push_back(cell);
+            if (goDown == kEmpty) queue.tasks.push_back(cell + stride);
+            if (goRight == kEmpty) queue.tasks.push_back(cell + 1);
+        } else {
+            // Only waiting on another thread: park at the steal end so this
+            // worker runs other tasks first
+            queue.tasks.push_front(cell);
+        }
+    }
+
+    // Read a subproblem; if nobody owns it yet, claim it for the caller to
+    // spawn and return kEmpty
+    int claimOrRead(size_t cell) {
+        int value = memo[cell].load(std::memory_order_acquire);
+        if (value != kEmpty) {
+            return value;
+        }
+        if (!memo[cell].compare_exchange_strong(value, kComputing,
+                                                std::memory_order_acq_rel)) {
+            return value;  // another thread claimed or finished it first
+        }
+        return kEmpty;
+    }
+
+    bool popOwn(int self, size_t& cell) {
+        WorkQueue& queue = queues[self];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        cell = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(int self, size_t& cell) {
+        for (int offset = 1; offset < workers; offset++) {
+            WorkQueue& victim = queues[(self + offset) % workers];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                cell = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// 1D and in-place DP, copied from dungeon_game_1d_dp.cpp
+class DungeonGameOptimized {
+public:
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        vector<int> dp(cols, INT_MAX);
+        dp[cols - 1] = max(1, 1 - dungeon[rows - 1][cols - 1]);
+        for (int j = cols - 2; j >= 0; j--) {
+            dp[j] = max(1, dp[j + 1] - dungeon[rows - 1][j]);
+        }
+
+        for (int i = rows - 2; i >= 0; i--) {
+            dp[cols - 1] = max(1, dp[cols - 1] - dungeon[i][cols - 1]);
+            for (int j = cols - 2; j >= 0; j--) {
+                dp[j] = max(1, min(dp[j + 1], dp[j]) - dungeon[i][j]);
+            }
+        }
+
+        return dp[0];
+    }
+
+    int calculateMinimumHPInPlace(vector<vector<int>>& dungeon) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        dungeon[rows - 1][cols - 1] = max(1, 1 - dungeon[rows - 1][cols - 1]);
+        for (int j = cols - 2; j >= 0; j--) {
+            dungeon[rows - 1][j] = max(1, dungeon[rows - 1][j + 1] - dungeon[rows - 1][j]);
+        }
+        for (int i = rows - 2; i >= 0; i--) {
+            dungeon[i][cols - 1] = max(1, dungeon[i + 1][cols - 1] - dungeon[i][cols - 1]);
+        }
+        for (int i = rows - 2; i >= 0; i--) {
+            for (int j = cols - 2; j >= 0; j--) {
+                dungeon[i][j] = max(1, min(dungeon[i][j + 1], dungeon[i + 1][j]) - dungeon[i][j]);
+            }
+        }
+
+        return dungeon[0][0];
+    }
+};
+
+// Copied from dungeon_game_bfs.cpp (sequential search only)
+class DungeonGameBFS {
+private:
+    vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
+
+    FeasibilityBackend backend;
+    ForwardHealthSweep sweep;
+    SearchWorkspace workspace;
+    vector<int> scratch;
+
+public:
+    explicit DungeonGameBFS(FeasibilityBackend backend = FeasibilityBackend::Sweep)
+        : backend(backend) {}
+
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        if (backend == FeasibilityBackend::Sweep) {
+            sweep.load(dungeon);
+        }
+
+        // Binary search on the answer
+        int left = 1, right = 1000000;
+
+        while (left < right) {
+            int mid = left + (right - left) / 2;
+
+            if (canReach(dungeon, mid)) {
+                right = mid;
+            } else {
+                left = mid + 1;
+            }
+        }
+
+        return left;
+    }
+
+private:
+    bool canReach(vector<vector<int>>& dungeon, int startHealth) {
+        if (backend == FeasibilityBackend::Sweep) {
+            return sweep.canReach(startHealth, scratch);
+        }
+        return canReachPrincess(dungeon, startHealth, workspace);
+    }
+
+    bool canReachPrincess(vector<vector<int>>& dungeon, int startHealth,
+                          SearchWorkspace& ws) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        ws.beginProbe(rows * cols);
+        ws.pushFrontier(0, startHealth);
+
+        while (!ws.frontierEmpty()) {
+            PackedState current = ws.popFront();
+
+            // A healthier copy of this cell was queued after this one
+            if (ws.isDominated(current.cell, current.health)) {
+                continue;
+            }
+
+            int row = current.cell / cols;
+            int col = current.cell % cols;
+            int currentHealth = current.health + dungeon[row][col];
+            if (currentHealth <= 0) {
+                continue;
+            }
+            if (row == rows - 1 && col == cols - 1) {
+                return true;
+            }
+
+            for (auto& dir : directions) {
+                int newRow = row + dir.first;
+                int newCol = col + dir.second;
+
+                if (newRow < rows && newCol < cols) {
+                    uint32_t next = newRow * cols + newCol;
+                    if (ws.improveBest(next, currentHealth)) {
+                        ws.pushFrontier(next, currentHealth);
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+};
+
+// Copied from dungeon_game_dfs.cpp (sequential search only)
+class DungeonGameDFS {
+private:
+    vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
+
+    FeasibilityBackend backend;
+    ForwardHealthSweep sweep;
+    SearchWorkspace workspace;
+    vector<int> scratch;
+
+public:
+    explicit DungeonGameDFS(FeasibilityBackend backend = FeasibilityBackend::Sweep)
+        : backend(backend) {}
+
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        if (backend == FeasibilityBackend::Sweep) {
+            sweep.load(dungeon);
+        }
+
+        // Binary search on the minimum starting health
+        int left = 1, right = 1000000;
+
+        while (left < right) {
+            int mid = left + (right - left) / 2;
+
+            if (canReach(dungeon, mid)) {
+                right = mid;
+            } else {
+                left = mid + 1;
+            }
+        }
+
+        return left;
+    }
+
+private:
+    bool canReach(vector<vector<int>>& dungeon, int startHealth) {
+        if (backend == FeasibilityBackend::Sweep) {
+            return sweep.canReach(startHealth, scratch);
+        }
+        return canReachPrincessDFS(dungeon, startHealth, workspace);
+    }
+
+    bool canReachPrincessDFS(vector<vector<int>>& dungeon, int startHealth,
+                             SearchWorkspace& ws) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        ws.beginProbe(rows * cols);
+        ws.pushFrontier(0, startHealth);
+
+        while (!ws.frontierEmpty()) {
+            PackedState current = ws.popBack();
+            int row = current.cell / cols;
+            int col = current.cell % cols;
+
+            int currentHealth = current.health + dungeon[row][col];
+            if (currentHealth <= 0) {
+                continue;
+            }
+
+            // Skip only if an earlier visit entered with at least as much health
+            if (!ws.improveBest(current.cell, currentHealth)) {
+                continue;
+            }
+            if (row == rows - 1 && col == cols - 1) {
+                return true;
+            }
+
+            for (int i = directions.size() - 1; i >= 0; i--) {
+                int newRow = row + directions[i].first;
+                int newCol = col + directions[i].second;
+
+                if (newRow < rows && newCol < cols) {
+                    ws.pushFrontier(newRow * cols + newCol, currentHealth);
+                }
+            }
+        }
+
+        return false;
+    }
+};
+
+// Copied from dungeon_game_dijkstra.cpp
+class DungeonGameDijkstra {
+public:
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        vector<int> minHealth(rows * cols, INT_MAX);
+        IndexedDaryHeap<int> pq(rows * cols);
+
+        int princess = (rows - 1) * cols + (cols - 1);
+        int princessHealth = max(1, 1 - dungeon[rows-1][cols-1]);
+        minHealth[princess] = princessHealth;
+        pq.push(princess, princessHealth);
+
+        // Reverse directions (left, up) since we're working backwards
+        vector<pair<int, int>> reverseDirections = {{0, -1}, {-1, 0}};
+
+        while (!pq.empty()) {
+            int current = pq.pop();
+
+            int row = current / cols;
+            int col = current % cols;
+
+            for (auto& dir : reverseDirections) {
+                int newRow = row + dir.first;
+                int newCol = col + dir.second;
+                if (newRow < 0 || newCol < 0) {
+                    continue;
+                }
+
+                int next = newRow * cols + newCol;
+                int healthNeeded = max(1, minHealth[current] - dungeon[newRow][newCol]);
+                if (healthNeeded < minHealth[next]) {
+                    minHealth[next] = healthNeeded;
+                    // max(1, h - d) is not monotone in the path, so a cell already
+                    // popped can still get a better label; it is then queued again
+                    pq.pushOrDecrease(next, healthNeeded);
+                }
+            }
+        }
+
+        return minHealth[0];
+    }
+};
+
+// Copied from dungeon_game_bellman_ford.cpp
+class DungeonGameBellmanFord {
+private:
+    struct Edge {
+        int from_row, from_col, to_row, to_col, weight;
+
+        Edge(int fr, int fc, int tr, int tc, int w)
+            : from_row(fr), from_col(fc), to_row(tr), to_col(tc), weight(w) {}
+    };
+
+    vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
+
+public:
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        vector<Edge> edges;
+        createEdges(dungeon, edges);
+
+        vector<vector<int>> minHealth(rows, vector<int>(cols, INT_MAX));
+        minHealth[rows-1][cols-1] = max(1, 1 - dungeon[rows-1][cols-1]);
+
+        // Relax edges (rows * cols - 1) times
+        for (int i = 0; i < rows * cols - 1; i++) {
+            bool updated = false;
+
+            for (const Edge& edge : edges) {
+                int fromHealth = minHealth[edge.to_row][edge.to_col];
+                if (fromHealth != INT_MAX) {
+                    int healthNeeded = max(1, fromHealth - dungeon[edge.from_row][edge.from_col]);
+                    if (healthNeeded < minHealth[edge.from_row][edge.from_col]) {
+                        minHealth[edge.from_row][edge.from_col] = healthNeeded;
+                        updated = true;
+                    }
+                }
+            }
+
+            // Early termination if no updates
+            if (!updated) break;
+        }
+
+        return minHealth[0][0];
+    }
+
+private:
+    void createEdges(vector<vector<int>>& dungeon, vector<Edge>& edges) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                for (auto& dir : directions) {
+                    int newRow = i + dir.first;
+                    int newCol = j + dir.second;
+
+                    if (newRow < rows && newCol < cols) {
+                        edges.push_back(Edge(i, j, newRow, newCol, dungeon[newRow][newCol]));
+                    }
+                }
+            }
+        }
+    }
+};
+
+// Copied from dungeon_game_astar.cpp
+class DungeonGameAStar {
+public:
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        vector<int> minHealth(rows * cols, INT_MAX);
+        FlatBitset closed(rows * cols);
+        IndexedDaryHeap<double> open(rows * cols);
+
+        int princess = (rows - 1) * cols + (cols - 1);
+        int princessHealth = max(1, 1 - dungeon[rows-1][cols-1]);
+        minHealth[princess] = princessHealth;
+
+        double heuristic = manhattanDistance(rows-1, cols-1, 0, 0);
+        open.push(princess, princessHealth + heuristic);
+
+        vector<pair<int, int>> reverseDirections = {{0, -1}, {-1, 0}};
+
+        while (!open.empty()) {
+            int current = open.pop();
+            closed.set(current);
+
+            int row = current / cols;
+            int col = current % cols;
+            if (current == 0) {
+                return minHealth[current];
+            }
+
+            for (auto& dir : reverseDirections) {
+                int newRow = row + dir.first;
+                int newCol = col + dir.second;
+                if (newRow < 0 || newCol < 0) {
+                    continue;
+                }
+
+                int next = newRow * cols + newCol;
+                if (closed.test(next)) {
+                    continue;
+                }
+
+                int healthNeeded = max(1, minHealth[current] - dungeon[newRow][newCol]);
+                if (healthNeeded < minHealth[next]) {
+                    minHealth[next] = healthNeeded;
+                    double h = manhattanDistance(newRow, newCol, 0, 0);
+                    open.pushOrDecrease(next, healthNeeded + h);
+                }
+            }
+        }
+
+        return minHealth[0];
+    }
+
+private:
+    double manhattanDistance(int row1, int col1, int row2, int col2) {
+        return abs(row1 - row2) + abs(col1 - col2);
+    }
+};
+
+// What each solver is documented to cost; claimedExponent is the power of
+// the cell count m×n it implies (< 0: exponential). log(max) is constant
+// in the grid size; a log(m×n) factor adds 1 / ln(m×n) to the local slope
+struct SolverClaim {
+    const char* name;
+    const char* claim;
+    double claimedExponent;
+    bool logCells;
+};
+
+static const SolverClaim kSolverClaims[] = {
+    {"memo2d",       "O(m×n)",          1, false},
+    {"iterative",    "O(m×n)",          1, false},
+    {"parallel",     "O(m×n)",          1, false},
+    {"dp1d",         "O(m×n)",          1, false},
+    {"inplace",      "O(m×n)",          1, false},
+    {"scalar1d",     "O(m×n)",          1, false},
+    {"wavefront32",  "O(m×n)",          1, false},
+    {"tiled",        "O(m×n)",          1, false},
+    {"bfs",          "O(m×n×log(max))", 1, false},
+    {"dfs",          "O(m×n×log(max))", 1, false},
+    {"dijkstra",     "O(m×n×log(m×n))", 1, true},
+    {"bellman_ford", "O((m×n)²)",       2, false},
+    {"astar",        "O(b^d)",          -1, false}
+};
+
+// Same cell count as side × side, different shape: rows = side * rowsPer4 / 4
+struct GridShape {
+    const char* name;
+    int rowsPer4;
+    int colsPer4;
+};
+
+static const GridShape kShapes[] = {
+    {"square", 4, 4},
+    {"wide", 1, 16},
+    {"tall", 16, 1}
+};
+
+struct AnalysisConfig {
+    vector<string> solvers;  // empty = all
+    vector<string> shapes;   // empty = all
+    double maxCells = 1 << 22;
+    double maxSolveNs = 250e6;
+    double minPointNs = 20e6;
+    vector<int> production = {1000, 5000, 10000};
+    double deadlineNs = 1e9;
+    double memoryLimitBytes = 4096.0 * (1 << 20);
+    bool verbose = false;
+    bool strict = false;  // exit status 1 if a solver answers wrong
+};
+
+struct GrowthPoint {
+    int rows = 0;
+    int cols = 0;
+    double ns = 0;
+    double peakHeapBytes = 0;
+
+    double cells() const { return static_cast<double>(rows) * cols; }
+};
+
+struct GrowthSeries {
+    const SolverClaim* solver = nullptr;
+    const GridShape* shape = nullptr;
+    vector<GrowthPoint> points;
+    bool stopped = false;  // a solve hit --max-solve-ms
+    PowerLawFit fit;
+    double fitCells = 0;   // geometric mean of the fitted sizes
+    int wrongGrids = 0;    // sizes where the answer differed from scalar1d
+};
+
+/**
+ * Measures how each solver's time grows with the grid and fits a power law
+ *
+ * The points of a series are fitted over the largest kFitPoints sizes;
+ * below that, call overhead and cache effects flatten the curve and pull
+ * the exponent under its asymptotic value.
+ */
+class ComplexityAnalysis {
+private:
+    static const int kFitPoints = 4;
+    static constexpr double kTolerance = 0.25;  // exponent difference still "as claimed"
+
+    AnalysisConfig config;
+    vector<GrowthSeries> series;
+
+    // Solver instances persist across sizes, like in a service
+    DungeonGame memo;
+    DungeonGameIterative iterative;
+    DungeonGameParallel parallel;
+    DungeonGameOptimized optimized;
+    DungeonGameBFS bfs;
+    DungeonGameDFS dfs;
+    DungeonGameDijkstra dijkstra;
+    DungeonGameBellmanFord bellmanFord;
+    DungeonGameAStar astar;
+    Workspace workspace;
+
+public:
+    explicit ComplexityAnalysis(const AnalysisConfig& config) : config(config) {}
+
+    // Solvers that answered wrong on at least one grid
+    vector<string> wrongSolvers() const {
+        vector<string> names;
+        for (const GrowthSeries& entry : series) {
+            if (entry.wrongGrids > 0 &&
+                std::find(names.begin(), names.end(), entry.solver->name) == names.end()) {
+                names.push_back(entry.solver->name);
+            }
+        }
+        return names;
+    }
+
+    void run() {
+        for (const GridShape& shape : kShapes) {
+            if (!selected(config.shapes, shape.name)) continue;
+            size_t first = series.size();
+            for (const SolverClaim& solver : kSolverClaims) {
+                if (!selected(config.solvers, solver.name)) continue;
+                GrowthSeries entry;
+                entry.solver = &solver;
+                entry.shape = &shape;
+                series.push_back(entry);
+            }
+            measureShape(shape, first);
+        }
+        for (GrowthSeries& entry : series) {
+            fit(entry);
+        }
+    }
+
+    void printGrowth() const {
+        cout << "\n=== MEASURED GROWTH (time = C × cells^k) ===" << endl;
+        cout << "| Algorithm     | Claim            | Shape  | Points | Largest     | k     | C (ns)     | R²    | Verdict                    |" << endl;
+        cout << "|---------------|------------------|--------|--------|-------------|-------|------------|-------|----------------------------|" << endl;
+        for (const GrowthSeries& entry : series) {
+            const GrowthPoint* largest = entry.points.empty() ? nullptr : &entry.points.back();
+            string grid = largest ? std::to_string(largest->rows) + "x" + std::to_string(largest->cols) : "-";
+            cout << "| " << std::left << std::setw(13) << entry.solver->name
+                 << " | " << padded(entry.solver->claim, 16)
+                 << " | " << std::setw(6) << entry.shape->name
+                 << " | " << std::right << std::setw(6) << entry.points.size()
+                 << " | " << std::left << std::setw(11) << grid << " | " << std::right;
+            if (entry.fit.points >= 3) {
+                cout << std::fixed << std::setprecision(2) << std::setw(5) << entry.fit.exponent
+                     << " | " << std::scientific << std::setprecision(3) << std::setw(10) << entry.fit.constant
+                     << " | " << std::fixed << std::setprecision(3) << std::setw(5) << entry.fit.r2;
+                cout.unsetf(std::ios::floatfield);
+            } else {
+                cout << std::setw(5) << "-" << " | " << std::setw(10) << "-" << " | " << std::setw(5) << "-";
+            }
+            cout << " | " << std::left << std::setw(26) << verdict(entry) << " |" << std::right << endl;
+        }
+        cout << "\nk is fitted over the " << kFitPoints << " largest sizes of each shape; a verdict"
+             << " differs when |k - claimed| > " << kTolerance << "." << endl;
+    }
+
+    void printVerbose() const {
+        cout << "\n=== RAW POINTS ===" << endl;
+        cout << "| Algorithm     | Shape  | Grid          | Time (ms)    | Peak heap (KB) |" << endl;
+        cout << "|---------------|--------|---------------|--------------|----------------|" << endl;
+        for (const GrowthSeries& entry : series) {
+            for (const GrowthPoint& point : entry.points) {
+                cout << "| " << std::left << std::setw(13) << entry.solver->name
+                     << " | " << std::setw(6) << entry.shape->name
+                     << " | " << std::setw(13) << (std::to_string(point.rows) + "x" + std::to_string(point.cols))
+                     << " | " << std::right << std::fixed << std::setprecision(4) << std::setw(12) << point.ns / 1e6
+                     << " | " << std::setprecision(0) << std::setw(14) << point.peakHeapBytes / 1024 << " |" << endl;
+                cout.unsetf(std::ios::floatfield);
+            }
+        }
+    }
+
+    // Square fits extrapolated to the production sizes, fastest first at
+    // the largest one
+    void printExtrapolation() const {
+        vector<const GrowthSeries*> square;
+        for (const GrowthSeries& entry : series) {
+            if (string(entry.shape->name) == "square" && entry.fit.points >= 3) {
+                square.push_back(&entry);
+            }
+        }
+        if (square.empty() || config.production.empty()) {
+            return;
+        }
+        double largest = static_cast<double>(config.production.back()) * config.production.back();
+        std::sort(square.begin(), square.end(), [&](const GrowthSeries* a, const GrowthSeries* b) {
+            return a->fit.predict(largest) < b->fit.predict(largest);
+        });
+
+        cout << "\n=== EXTRAPOLATED TO PRODUCTION SIZES (square fits) ===" << endl;
+        cout << "| Algorithm     |";
+        for (int n : config.production) {
+            cout << " " << std::setw(13) << (std::to_string(n) + "x" + std::to_string(n)) << " |";
+        }
+        cout << " Heap at largest | Fails at      |" << endl;
+        cout << "|---------------|";
+        for (size_t i = 0; i < config.production.size(); i++) {
+            cout << "---------------|";
+        }
+        cout << "-----------------|---------------|" << endl;
+
+        for (const GrowthSeries* entry : square) {
+            const GrowthPoint& measured = entry->points.back();
+            double heapPerCell = measured.peakHeapBytes / measured.cells();
+            string failsAt = entry->wrongGrids > 0 ? "wrong answers" : "-";
+            cout << "| " << std::left << std::setw(13) << entry->solver->name << " |" << std::right;
+            for (int n : config.production) {
+                double cells = static_cast<double>(n) * n;
+                double ns = entry->fit.predict(cells);
+                cout << " " << std::setw(13) << formatDuration(ns) << " |";
+                if (failsAt == "-" && (ns > config.deadlineNs || heapPerCell * cells > config.memoryLimitBytes)) {
+                    failsAt = std::to_string(n) + "x" + std::to_string(n);
+                }
+            }
+            std::ostringstream heap;
+            heap << std::fixed << std::setprecision(0) << heapPerCell * largest / (1 << 20) << " MB";
+            cout << " " << std::setw(15) << heap.str() << " | " << std::left << std::setw(13) << failsAt
+                 << " |" << std::right << endl;
+        }
+        cout << "\nFails at: first size over the " << formatDuration(config.deadlineNs) << " deadline or "
+             << std::fixed << std::setprecision(0) << config.memoryLimitBytes / (1 << 20)
+             << " MB of heap beyond the input grid." << endl;
+        cout.unsetf(std::ios::floatfield);
+    }
+
+private:
+    static bool selected(const vector<string>& filter, const string& name) {
+        return filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+    }
+
+    static string padded(const string& text, size_t width) {
+        // setw counts bytes, and the claims contain multi-byte "×" and "²"
+        size_t glyphs = 0;
+        for (char c : text) {
+            if ((c & 0xC0) != 0x80) glyphs++;
+        }
+        return text + string(glyphs < width ? width - glyphs : 0, ' ');
+    }
+
+    static string formatDuration(double ns) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(2);
+        if (ns < 1e6) {
+            out << ns / 1e3 << " us";
+        } else if (ns < 1e9) {
+            out << ns / 1e6 << " ms";
+        } else if (ns < 3600e9) {
+            out << ns / 1e9 << " s";
+        } else {
+            out << ns / 3600e9 << " h";
+        }
+        return out.str();
+    }
+
+    std::function<int()> solverFor(const string& name, const DungeonGrid& grid,
+                                   vector<vector<int>>& nested) {
+        if (name == "memo2d") return [&]() { return memo.calculateMinimumHP(nested); };
+        if (name == "iterative") return [&]() { return iterative.calculateMinimumHP(nested, &workspace); };
+        if (name == "parallel") return [&]() { return parallel.calculateMinimumHP(nested); };
+        if (name == "dp1d") return [&]() { return optimized.calculateMinimumHP(nested); };
+        if (name == "inplace") return [&]() { return optimized.calculateMinimumHPInPlace(nested); };
+        if (name == "scalar1d") return [&]() { return DungeonKernels::scalar1D(grid, &workspace); };
+        if (name == "wavefront32") return [&]() { return DungeonKernels::wavefront<int32_t>(grid, &workspace); };
+        if (name == "tiled") return [&]() { return DungeonKernels::tiledParallel(grid, 256, 256, 1, &workspace); };
+        if (name == "bfs") return [&]() { return bfs.calculateMinimumHP(nested); };
+        if (name == "dfs") return [&]() { return dfs.calculateMinimumHP(nested); };
+        if (name == "dijkstra") return [&]() { return dijkstra.calculateMinimumHP(nested); };
+        if (name == "bellman_ford") return [&]() { return bellmanFord.calculateMinimumHP(nested); };
+        return [&]() { return astar.calculateMinimumHP(nested); };
+    }
+
+    // Grows series[first..] together, so each grid is built once per size
+    void measureShape(const GridShape& shape, size_t first) {
+        typedef std::chrono::steady_clock Clock;
+        for (int side = 16; ; side *= 2) {
+            int rows = max(1, side * shape.rowsPer4 / 4);
+            int cols = max(1, side * shape.colsPer4 / 4);
+            if (static_cast<double>(rows) * cols > config.maxCells) {
+                break;
+            }
+
+            bool active = false;
+            for (size_t s = first; s < series.size(); s++) {
+                active = active || !series[s].stopped;
+            }
+            if (!active) {
+                break;
+            }
+
+            DungeonGrid grid = syntheticGrid(rows, cols, static_cast<uint32_t>(side * 31 + rows));
+            const vector<vector<int>> original = grid.toNested();
+            vector<vector<int>> nested = original;
+            int expected = DungeonKernels::scalar1D(grid, &workspace);
+
+            for (size_t s = first; s < series.size(); s++) {
+                GrowthSeries& entry = series[s];
+                if (entry.stopped) continue;
+                std::function<int()> solve = solverFor(entry.solver->name, grid, nested);
+                bool restore = string(entry.solver->name) == "inplace";
+
+                GrowthPoint point;
+                point.rows = rows;
+                point.cols = cols;
+                point.ns = std::numeric_limits<double>::max();
+                double spent = 0;
+                int answer = 0;
+                bool wrong = false;
+                for (int run = 0; run < 3 || spent < config.minPointNs; run++) {
+                    if (restore) nested = original;
+                    double ns = 0;
+                    auto timed = [&]() {
+                        auto start = Clock::now();
+                        answer = solve();
+                        ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                    };
+                    if (run == 0) {
+                        point.peakHeapBytes = static_cast<double>(measureAllocations(timed).peakLiveBytes);
+                    } else {
+                        timed();
+                    }
+                    point.ns = min(point.ns, ns);
+                    spent += ns;
+                    if (answer != expected && !wrong) {
+                        if (entry.wrongGrids == 0) {
+                            cerr << "WARNING: " << entry.solver->name << " answered " << answer << " on "
+                                 << rows << "x" << cols << " (" << shape.name << "), expected "
+                                 << expected << endl;
+                        }
+                        entry.wrongGrids++;
+                        wrong = true;
+                    }
+                    if (ns >= config.maxSolveNs) {
+                        entry.stopped = true;
+                        break;
+                    }
+                }
+                entry.points.push_back(point);
+                if (restore) nested = original;
+            }
+        }
+    }
+
+    void fit(GrowthSeries& entry) const {
+        vector<double> cells, times;
+        size_t begin = entry.points.size() > kFitPoints ? entry.points.size() - kFitPoints : 0;
+        for (size_t i = begin; i < entry.points.size(); i++) {
+            cells.push_back(entry.points[i].cells());
+            times.push_back(entry.points[i].ns);
+        }
+        entry.fit = fitPowerLaw(cells, times);
+
+        double logSum = 0;
+        for (double size : cells) {
+            logSum += std::log(size);
+        }
+        entry.fitCells = cells.empty() ? 0 : std::exp(logSum / cells.size());
+    }
+
+    static string verdict(const GrowthSeries& entry) {
+        if (entry.wrongGrids > 0) {
+            return "WRONG on " + std::to_string(entry.wrongGrids) + " of " +
+                   std::to_string(entry.points.size()) + " sizes";
+        }
+        if (entry.fit.points < 3) {
+            return "too few sizes to fit";
+        }
+        double claimed = entry.solver->claimedExponent;
+        if (entry.solver->logCells && entry.fitCells > 1) {
+            claimed += 1 / std::log(entry.fitCells);
+        }
+        double k = entry.fit.exponent;
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(2);
+        if (claimed < 0) {
+            // An exponential cost shows up as k rising with every size
+            if (k < 3) {
+                text << "DIFFERS: polynomial";
+            } else {
+                text << "as claimed (k >= 3)";
+            }
+        } else if (std::fabs(k - claimed) <= kTolerance) {
+            text << "as claimed (" << claimed << ")";
+        } else if (k > claimed) {
+            text << "DIFFERS: slower than " << claimed;
+        } else {
+            text << "DIFFERS: faster than " << claimed;
+        }
+        return text.str();
+    }
+};
 
 class AlgorithmComprehensiveComparison {
+private:
+    AnalysisConfig config;
+
 public:
-    void compareAllAlgorithms() {
+    explicit AlgorithmComprehensiveComparison(const AnalysisConfig& config) : config(config) {}
+
+    // Returns the solvers that answered wrong while being measured
+    vector<string> compareAllAlgorithms() {
         cout << "=== COMPREHENSIVE ALGORITHM COMPARISON ===" << endl;
         cout << "Testing Dungeon Game with different algorithm approaches:" << endl;
         cout << "\n1. Dynamic Programming Approaches:" << endl;
         cout << "   - 2D DP (Original): Recursive with memoization" << endl;
         cout << "   - 1D DP (Optimized): Space-optimized iterative" << endl;
         cout << "   - In-Place DP: Modifies input array directly" << endl;
+        cout << "   - scalar1d / wavefront32 / tiled: flat-grid kernels (dungeon_kernels.h)" << endl;
         
         cout << "\n2. Graph Algorithm Approaches:" << endl;
         cout << "   - BFS: Breadth-first search with binary search" << endl;
@@ -31,30 +1185,22 @@ public:
         cout << "   - Bellman-Ford: Single-source shortest path" << endl;
         cout << "   - A*: Heuristic-based pathfinding" << endl;
         
-        performComplexityAnalysis();
+        vector<string> wrong = performComplexityAnalysis();
         algorithmCharacteristics();
         recommendations();
+        return wrong;
     }
     
 private:
-    void performComplexityAnalysis() {
-        cout << "\n=== ALGORITHM COMPLEXITY ANALYSIS ===" << endl;
-        
-        cout << "| Algorithm     | Time Complexity  | Space Complexity | Approach Type    |" << endl;
-        cout << "|---------------|------------------|------------------|------------------|" << endl;
-        cout << "| 2D DP         | O(m×n)          | O(m×n)          | Top-down DP      |" << endl;
-        cout << "| 1D DP         | O(m×n)          | O(n)            | Bottom-up DP     |" << endl;
-        cout << "| In-Place DP   | O(m×n)          | O(1)            | Bottom-up DP     |" << endl;
-        cout << "| BFS           | O(m×n×log(max)) | O(m×n)          | Graph traversal  |" << endl;
-        cout << "| DFS           | O(m×n×log(max)) | O(m×n)          | Graph traversal  |" << endl;
-        cout << "| Dijkstra      | O(m×n×log(m×n)) | O(m×n)          | Shortest path    |" << endl;
-        cout << "| Bellman-Ford  | O((m×n)²)       | O(m×n)          | Shortest path    |" << endl;
-        cout << "| A*            | O(b^d)          | O(b^d)          | Heuristic search |" << endl;
-        
-        cout << "\nWhere:" << endl;
-        cout << "- m, n: grid dimensions" << endl;
-        cout << "- max: maximum possible health value" << endl;
-        cout << "- b: branching factor, d: depth" << endl;
+    vector<string> performComplexityAnalysis() {
+        ComplexityAnalysis analysis(config);
+        analysis.run();
+        if (config.verbose) {
+            analysis.printVerbose();
+        }
+        analysis.printGrowth();
+        analysis.printExtrapolation();
+        return analysis.wrongSolvers();
     }
     
     void algorithmCharacteristics() {
@@ -113,24 +1259,127 @@ private:
         cout << "   • Can handle weighted edges, obstacles, etc." << endl;
         cout << "   • A* provides good performance with heuristics" << endl;
         
-        cout << "\n📊 **Performance Ranking (Best to Worst):**" << endl;
-        cout << "   1. In-Place DP      (Fastest, O(1) space)" << endl;
-        cout << "   2. 1D DP            (Fast, O(n) space)" << endl;
-        cout << "   3. 2D DP            (Baseline)" << endl;
-        cout << "   4. A* (Backward)    (Good with heuristics)" << endl;
-        cout << "   5. Dijkstra         (Reliable shortest path)" << endl;
-        cout << "   6. BFS/DFS          (Simple but needs binary search)" << endl;
-        cout << "   7. Bellman-Ford     (Most general, slowest)" << endl;
+        dispatchTable();
+    }
+    
+    // What AdaptiveDungeonSolver would run on this machine, per grid size
+    void dispatchTable() {
+        cout << "\n=== ADAPTIVE DISPATCH (calibrated on this machine) ===" << endl;
+        
+        AdaptiveDungeonSolver solver;
+        
+        // Cost models saved by an earlier run; measured and saved if missing
+        const char* calibrationPath = std::getenv("DUNGEON_CALIBRATION");
+        string calibration = calibrationPath ? calibrationPath : "dungeon_calibration.txt";
+        solver.calibrateOrLoad(calibration);
+        cout << "Cost models from " << calibration << " (delete it to measure again)" << endl;
+        
+        // Tuned tile size, threads and lane width, written by dungeon_tune
+        const char* profilePath = std::getenv("DUNGEON_TUNING_PROFILE");
+        string path = profilePath ? profilePath : "dungeon_tuning.profile";
+        if (solver.loadTuning(path)) {
+            cout << "Using tuning profile " << path << " for " << cpuModelName() << endl;
+        } else {
+            cout << "No tuning profile for " << cpuModelName() << " (run dungeon_tune)" << endl;
+        }
+        
+        SolveOptions generated;  // values in [-10, 10], as generateRandomDungeon
+        generated.valueRangeKnown = true;
+        generated.minValue = -10;
+        generated.maxValue = 10;
+        
+        const int sizes[] = {4, 32, 100, 500, 1000, 5000, 20000, 50000};
+        cout << "| Grid          | Unknown range | Values -10..10 | Predicted (ms) |" << endl;
+        cout << "|---------------|---------------|----------------|----------------|" << endl;
+        for (int n : sizes) {
+            KernelKind unknown = solver.choose(n, n);
+            KernelKind known = solver.choose(n, n, generated);
+            double ms = solver.predictNs(known, static_cast<size_t>(n) * n) / 1e6;
+            cout << "| " << std::left << std::setw(13) << (std::to_string(n) + "x" + std::to_string(n))
+                 << " | " << std::setw(13) << kernelName(unknown)
+                 << " | " << std::setw(14) << kernelName(known)
+                 << " | " << std::right << std::setw(14) << std::fixed << std::setprecision(3) << ms
+                 << " |" << endl;
+        }
     }
 };
 
-int main() {
+static vector<string> splitList(const string& text) {
+    vector<string> items;
+    std::stringstream stream(text);
+    string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+static void printUsage() {
+    cout << "Usage: comprehensive_algorithm_analysis [options]\n"
+         << "  --solvers a,b,...     memo2d iterative parallel dp1d inplace scalar1d wavefront32 tiled\n"
+         << "                        bfs dfs dijkstra bellman_ford astar\n"
+         << "  --aspects a,b,...     square wide tall\n"
+         << "  --max-cells N         largest grid measured (default 4194304)\n"
+         << "  --max-solve-ms MS     stop growing a solver after a solve this slow (default 250)\n"
+         << "  --time SECONDS        minimum measuring time per point (default 0.02)\n"
+         << "  --production N,N,...  square sizes to extrapolate to (default 1000,5000,10000)\n"
+         << "  --deadline-ms MS      predicted time that counts as failing (default 1000)\n"
+         << "  --memory-mb MB        predicted heap that counts as failing (default 4096)\n"
+         << "  --verbose             print every measured point\n"
+         << "  --strict              exit with status 1 if any solver answers wrong\n";
+}
+
+int main(int argc, char** argv) {
+    AnalysisConfig config;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--solvers" && hasValue) {
+            config.solvers = splitList(argv[++i]);
+        } else if (arg == "--aspects" && hasValue) {
+            config.shapes = splitList(argv[++i]);
+        } else if (arg == "--max-cells" && hasValue) {
+            config.maxCells = std::atof(argv[++i]);
+        } else if (arg == "--max-solve-ms" && hasValue) {
+            config.maxSolveNs = std::atof(argv[++i]) * 1e6;
+        } else if (arg == "--time" && hasValue) {
+            config.minPointNs = std::atof(argv[++i]) * 1e9;
+        } else if (arg == "--production" && hasValue) {
+            config.production.clear();
+            for (const auto& size : splitList(argv[++i])) {
+                if (std::atoi(size.c_str()) > 0) config.production.push_back(std::atoi(size.c_str()));
+            }
+            std::sort(config.production.begin(), config.production.end());
+        } else if (arg == "--deadline-ms" && hasValue) {
+            config.deadlineNs = std::atof(argv[++i]) * 1e6;
+        } else if (arg == "--memory-mb" && hasValue) {
+            config.memoryLimitBytes = std::atof(argv[++i]) * (1 << 20);
+        } else if (arg == "--verbose") {
+            config.verbose = true;
+        } else if (arg == "--strict") {
+            config.strict = true;
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    for (const auto& solver : config.solvers) {
+        bool known = false;
+        for (const SolverClaim& claim : kSolverClaims) {
+            known = known || solver == claim.name;
+        }
+        if (!known) {
+            cerr << "Unknown solver: " << solver << endl;
+            return 1;
+        }
+    }
+
     cout << "=== DUNGEON GAME: COMPREHENSIVE ALGORITHM ANALYSIS ===" << endl;
     cout << "Comparing Dynamic Programming vs Graph Algorithm Approaches" << endl;
     cout << "==========================================================" << endl;
     
-    AlgorithmComprehensiveComparison comparison;
-    comparison.compareAllAlgorithms();
+    AlgorithmComprehensiveComparison comparison(config);
+    vector<string> wrong = comparison.compareAllAlgorithms();
     
     cout << "\n=== SUMMARY ===" << endl;
     cout << "This analysis demonstrates that while the Dungeon Game can be" << endl;
@@ -145,5 +1394,13 @@ int main() {
     cout << "\n🎯 **Practical Recommendation:**" << endl;
     cout << "Use 1D DP for production, but understand all approaches!" << endl;
     
+    if (!wrong.empty()) {
+        cout << "\n⚠️  Wrong answers (do not deploy):";
+        for (const auto& name : wrong) {
+            cout << " " << name;
+        }
+        cout << endl;
+        return config.strict ? 1 : 0;
+    }
     return 0;
 }
@@ -1,5 +1,13 @@
 #include <iostream>
 #include <vector>
+#include <climits>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "solver_workspace.h"
 
 using std::vector;
 using std::max;
@@ -10,8 +18,17 @@ class DungeonGame {
 
  public:
 
+    // A row-major memo block read as memo[row][col], like the nested one
+    struct FlatMemo {
+        int* cells;
+        int cols;
+
+        int* operator[](int row) { return cells + static_cast<size_t>(row) * cols; }
+    };
+
+    template<typename Memo>
     int recurse(int row, int col, const vector<vector<int>>& dungeon, 
-    vector<vector<int>>& memo){
+    Memo& memo){
 
         int rows = dungeon.size();
         int cols = dungeon[0].size();
@@ -37,12 +54,279 @@ class DungeonGame {
         return memo[row][col];
     }
 
-    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+    // With a workspace (solver_workspace.h) the memo is one block from it,
+    // so repeated solves with a warm workspace do not allocate
+    int calculateMinimumHP(vector<vector<int>>& dungeon, Workspace* workspace = nullptr) {
         int rows = dungeon.size();
         int cols = dungeon[0].size();
         
+        if (workspace) {
+            Workspace::Frame frame(*workspace);
+            FlatMemo memo = { workspace->allocate<int>(static_cast<size_t>(rows) * cols, INT_MIN), cols };
+            return recurse(0, 0, dungeon, memo);
+        }
+
         vector<vector<int>> memo(rows, vector<int>(cols, INT_MIN));
 
         return recurse(0, 0, dungeon, memo);
     }
-};
\ No newline at end of file
+};
+
+// Top-down DungeonGame without recursion
+//
+// Same recurrence and memo semantics as DungeonGame::recurse, but cells are
+// resolved with an explicit stack, so grid size cannot overflow the call
+// stack. The memo is one flat array with an extra padding column and row:
+// out-of-bounds neighbours read INT_MAX and the princess's two virtual
+// neighbours read 1, so no bounds checks are needed. The grid is resolved
+// tile by tile from the bottom-right; since everything right of and below
+// a tile is already known, each tile's search stays inside it and the
+// stack never holds more than about 2 * (tile height + tile width) cells.
+class DungeonGameIterative {
+private:
+    static const int kTile = 64;
+
+    int* memo = nullptr;        // memoStore's or the caller's workspace's
+    vector<int> memoStore;
+    vector<size_t> pending;     // kept across calls
+
+public:
+    // With a workspace (solver_workspace.h) the memo comes from it instead
+    // of the solver, so one solver need not hold the largest grid's memo
+    int calculateMinimumHP(vector<vector<int>>& dungeon, Workspace* workspace = nullptr) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+        size_t stride = cols + 1;
+        size_t cells = static_cast<size_t>(rows + 1) * stride;
+
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        if (workspace) {
+            memo = scratch.allocate<int>(cells, INT_MIN);
+        } else {
+            memoStore.assign(cells, INT_MIN);
+            memo = memoStore.data();
+        }
+        for (int row = 0; row <= rows; row++) {
+            memo[row * stride + cols] = INT_MAX;
+        }
+        for (int col = 0; col < cols; col++) {
+            memo[rows * stride + col] = INT_MAX;
+        }
+        memo[(rows - 1) * stride + cols] = 1;
+        memo[rows * stride + cols - 1] = 1;
+
+        for (int tileRow = (rows - 1) / kTile * kTile; tileRow >= 0; tileRow -= kTile) {
+            for (int tileCol = (cols - 1) / kTile * kTile; tileCol >= 0; tileCol -= kTile) {
+                resolve(tileRow, tileCol, dungeon, stride);
+            }
+        }
+
+        return memo[0];
+    }
+
+private:
+    // Depth-first evaluation of recurse(row, col) on an explicit stack
+    void resolve(int row, int col, const vector<vector<int>>& dungeon, size_t stride) {
+        pending.clear();
+        pending.push_back(row * stride + col);
+
+        while (!pending.empty()) {
+            size_t cell = pending.back();
+            if (memo[cell] != INT_MIN) {
+                pending.pop_back();
+                continue;
+            }
+
+            int goRight = memo[cell + 1];
+            int goDown = memo[cell + stride];
+
+            // Evaluate unresolved subproblems first, right before down
+            if (goRight == INT_MIN || goDown == INT_MIN) {
+                if (goDown == INT_MIN) pending.push_back(cell + stride);
+                if (goRight == INT_MIN) pending.push_back(cell + 1);
+                continue;
+            }
+
+            int minimumHealth = min(goRight, goDown) - dungeon[cell / stride][cell % stride];
+            memo[cell] = max(1, minimumHealth);
+            pending.pop_back();
+        }
+    }
+};
+
+// Parallel lazy top-down DungeonGame
+//
+// Fork-join version of DungeonGame::recurse for queries that only need
+// part of the table, e.g. minimum health from an interior start cell.
+// A task for cell (row, col) spawns its right and down subproblems as
+// tasks and finishes once both are known, so only cells reachable from
+// the query are ever evaluated.
+//
+// Memo cells are atomics with two reserved states: kEmpty (never claimed)
+// and kComputing (claimed by a task). A cell is claimed with a single
+// compare-and-swap, so exactly one task ever computes it. A task whose
+// subproblem is being computed by another thread is requeued, and its
+// worker runs or steals other tasks meanwhile instead of spinning.
+// The memo is padded like DungeonGameIterative's and survives between
+// queries on the same dungeon.
+class DungeonGameParallel {
+private:
+    static const int kEmpty = INT_MIN;
+    static const int kComputing = INT_MIN + 1;
+
+    struct WorkQueue {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+
+    const vector<vector<int>>* grid = nullptr;
+    size_t stride = 0;
+    std::unique_ptr<std::atomic<int>[]> memo;
+    std::unique_ptr<WorkQueue[]> queues;
+    int workers = 1;
+
+public:
+    int calculateMinimumHP(vector<vector<int>>& dungeon, int threads = 0) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        load(dungeon);
+        return minimumHPFrom(0, 0, threads);
+    }
+
+    // Reset the memo for a new dungeon; the dungeon must outlive the queries
+    void load(const vector<vector<int>>& dungeon) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        grid = &dungeon;
+        stride = cols + 1;
+        memo.reset(new std::atomic<int>[(rows + 1) * stride]);
+
+        for (size_t cell = 0; cell < (rows + 1) * stride; cell++) {
+            memo[cell].store(kEmpty, std::memory_order_relaxed);
+        }
+        for (int row = 0; row <= rows; row++) {
+            memo[row * stride + cols].store(INT_MAX, std::memory_order_relaxed);
+        }
+        for (int col = 0; col < cols; col++) {
+            memo[rows * stride + col].store(INT_MAX, std::memory_order_relaxed);
+        }
+        memo[(rows - 1) * stride + cols].store(1, std::memory_order_relaxed);
+        memo[rows * stride + cols - 1].store(1, std::memory_order_relaxed);
+    }
+
+    // Minimum health needed when starting at (row, col) of the loaded dungeon
+    int minimumHPFrom(int row, int col, int threads = 0) {
+        size_t root = row * stride + col;
+
+        int expected = kEmpty;
+        if (!memo[root].compare_exchange_strong(expected, kComputing)) {
+            return memo[root].load();  // answered by an earlier query
+        }
+
+        workers = threads > 0 ? threads : max(1u, std::thread::hardware_concurrency());
+        queues.reset(new WorkQueue[workers]);
+        queues[0].tasks.push_back(root);
+
+        vector<std::thread> helpers;
+        for (int worker = 1; worker < workers; worker++) {
+            helpers.push_back(std::thread(&DungeonGameParallel::work, this, worker, root));
+        }
+        work(0, root);
+        for (auto& helper : helpers) {
+            helper.join();
+        }
+
+        return memo[root].load();
+    }
+
+private:
+    static bool isKnown(int value) {
+        return value != kEmpty && value != kComputing;
+    }
+
+    void work(int self, size_t root) {
+        while (!isKnown(memo[root].load(std::memory_order_acquire))) {
+            size_t cell;
+            if (popOwn(self, cell) || steal(self, cell)) {
+                run(self, cell);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Advance one claimed cell: compute it, or fork its missing subproblems
+    void run(int self, size_t cell) {
+        int goRight = claimOrRead(cell + 1);
+        int goDown = claimOrRead(cell + stride);
+
+        if (isKnown(goRight) && isKnown(goDown)) {
+            int value = (*grid)[cell / stride][cell % stride];
+            int minimumHealth = min(goRight, goDown) - value;
+            memo[cell].store(max(1, minimumHealth), std::memory_order_release);
+            return;
+        }
+
+        WorkQueue& queue = queues[self];
+        std::lock_guard<std::mutex> guard(queue.lock);
+
+        if (goRight == kEmpty || goDown == kEmpty) {
+            // Fork: requeue this cell as a continuation beneath its new
+            // children, which run first (right before down)
+            queue.tasks.push_back(cell);
+            if (goDown == kEmpty) queue.tasks.push_back(cell + stride);
+            if (goRight == kEmpty) queue.tasks.push_back(cell + 1);
+        } else {
+            // Only waiting on another thread: park at the steal end so this
+            // worker runs other tasks first
+            queue.tasks.push_front(cell);
+        }
+    }
+
+    // Read a subproblem; if nobody owns it yet, claim it for the caller to
+    // spawn and return kEmpty
+    int claimOrRead(size_t cell) {
+        int value = memo[cell].load(std::memory_order_acquire);
+        if (value != kEmpty) {
+            return value;
+        }
+        if (!memo[cell].compare_exchange_strong(value, kComputing,
+                                                std::memory_order_acq_rel)) {
+            return value;  // another thread claimed or finished it first
+        }
+        return kEmpty;
+    }
+
+    bool popOwn(int self, size_t& cell) {
+        WorkQueue& queue = queues[self];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        cell = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(int self, size_t& cell) {
+        for (int offset = 1; offset < workers; offset++) {
+            WorkQueue& victim = queues[(self + offset) % workers];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                cell = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+};
@@ -0,0 +1,769 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <climits>
+#include <cstdlib>
+#include <algorithm>
+
+#include "dungeon_grid.h"
+#include "dungeon_kernels.h"
+#include "kernel_timing.h"
+#include "benchmark_stats.h"
+#include "auto_tuner.h"
+#include "alloc_hooks.h"
+#include "roofline.h"
+
+using std::vector;
+using std::string;
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::max;
+using std::min;
+
+/**
+ * Benchmark driver for the bottom-up solvers
+ *
+ * For every (size, aspect ratio, value distribution, kernel) case:
+ *   1. the grid and any per-solve copies are built outside the timed region
+ *   2. a batch size is picked so that one sample lasts >= 20 µs, well above
+ *      the clock resolution
+ *   3. warmup samples run until the warmup budget is spent
+ *   4. samples are collected until the case budget is spent, extended up to
+ *      3x while the standard error of the mean is above 1%
+ *
+ * After sampling, one more untimed solve runs under an AllocationScope to
+ * record its allocation count, bytes, peak live heap and peak RSS.
+ *
+ * Results go to a table on stdout and to JSON with every raw sample, which
+ * is what the regression comparator reads.
+ *
+ * --allocations instead counts heap allocations per solve for each kernel,
+ * once with a fresh scratch buffer per call and once with a Workspace kept
+ * across calls, and fails if a single-threaded kernel still allocates
+ * after warming the workspace up.
+ *
+ * --roofline measures this machine's STREAM bandwidth at L1-, L2-, LLC-
+ * and DRAM-sized working sets and the compute ceiling of the cell update,
+ * then runs every kernel on a grid resident at each level and reports
+ * achieved cells/ns against the roofline bound for that kernel and level.
+ */
+
+// Recursive memoized baseline, copied from dungeon-game.cpp
+class DungeonGameMemo {
+public:
+    int recurse(int row, int col, const vector<vector<int>>& dungeon,
+                vector<vector<int>>& memo) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        if (row == rows - 1 && col == cols - 1) {
+            return max(1, 1 - dungeon[row][col]);
+        }
+
+        if (row >= rows || col >= cols) {
+            return INT_MAX;
+        }
+
+        if (memo[row][col] != INT_MIN) {
+            return memo[row][col];
+        }
+
+        int goRight = recurse(row, col + 1, dungeon, memo);
+        int goDown = recurse(row + 1, col, dungeon, memo);
+
+        int minimumHealth = min(goRight, goDown) - dungeon[row][col];
+        memo[row][col] = max(1, minimumHealth);
+
+        return memo[row][col];
+    }
+
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        vector<vector<int>> memo(rows, vector<int>(cols, INT_MIN));
+
+        return recurse(0, 0, dungeon, memo);
+    }
+};
+
+// Nested-vector baselines, copied from dungeon_game_1d_dp.cpp
+class DungeonGameOptimized {
+public:
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        vector<int> dp(cols, INT_MAX);
+        dp[cols - 1] = max(1, 1 - dungeon[rows - 1][cols - 1]);
+        for (int j = cols - 2; j >= 0; j--) {
+            dp[j] = max(1, dp[j + 1] - dungeon[rows - 1][j]);
+        }
+
+        for (int i = rows - 2; i >= 0; i--) {
+            dp[cols - 1] = max(1, dp[cols - 1] - dungeon[i][cols - 1]);
+            for (int j = cols - 2; j >= 0; j--) {
+                dp[j] = max(1, min(dp[j + 1], dp[j]) - dungeon[i][j]);
+            }
+        }
+
+        return dp[0];
+    }
+
+    int calculateMinimumHPInPlace(vector<vector<int>>& dungeon) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        dungeon[rows - 1][cols - 1] = max(1, 1 - dungeon[rows - 1][cols - 1]);
+        for (int j = cols - 2; j >= 0; j--) {
+            dungeon[rows - 1][j] = max(1, dungeon[rows - 1][j + 1] - dungeon[rows - 1][j]);
+        }
+        for (int i = rows - 2; i >= 0; i--) {
+            dungeon[i][cols - 1] = max(1, dungeon[i + 1][cols - 1] - dungeon[i][cols - 1]);
+        }
+        for (int i = rows - 2; i >= 0; i--) {
+            for (int j = cols - 2; j >= 0; j--) {
+                dungeon[i][j] = max(1, min(dungeon[i][j + 1], dungeon[i + 1][j]) - dungeon[i][j]);
+            }
+        }
+
+        return dungeon[0][0];
+    }
+};
+
+struct Distribution {
+    const char* name;
+    int low;
+    int high;
+};
+
+static const Distribution kDistributions[] = {
+    {"uniform", -10, 10},      // generateRandomDungeon
+    {"deadly", -100, 5},       // large answers, never fits int16 at scale
+    {"rewarding", -5, 100},    // answers stay near 1
+    {"wide", -1000, 1000}
+};
+
+// Same cell count as n × n, different shape: rows = n * rowsPer4 / 4
+struct Aspect {
+    const char* name;
+    int rowsPer4;
+    int colsPer4;
+};
+
+static const Aspect kAspects[] = {
+    {"square", 4, 4},
+    {"wide", 1, 16},   // n/4 × 4n
+    {"tall", 16, 1}    // 4n × n/4
+};
+
+static const char* const kKernelNames[] = {
+    "dp1d_nested", "inplace_nested", "scalar1d", "wavefront16", "wavefront32", "tiled", "fulltable"
+};
+
+struct BenchmarkConfig {
+    vector<int> sizes = {64, 256, 1024, 4096};
+    vector<string> kernels;        // empty = all
+    vector<string> distributions;  // empty = all
+    vector<string> aspects;        // empty = all
+    double caseSeconds = 0.5;
+    double warmupSeconds = 0.1;
+    int minSamples = 10;
+    int maxSamples = 1000;
+    int threads = 0;
+    string jsonPath = "benchmark_results.json";
+    bool allocations = false;
+    bool roofline = false;
+    size_t rooflineMaxBytes = 256u << 20;  // largest grid the roofline mode builds
+};
+
+// One timed solve; prepare(batch) runs untimed before each sample and
+// run(k) is the k-th solve of the sample
+struct BenchmarkCase {
+    string kernel;
+    std::function<void(int)> prepare;
+    std::function<int(int)> run;
+};
+
+struct CaseResult {
+    string kernel;
+    string distribution;
+    string aspect;
+    int rows = 0;
+    int cols = 0;
+    int batch = 1;
+    int answer = 0;
+    vector<double> samples;  // ns per solve
+    SampleStats stats;
+    AllocationStats memory;  // one extra, untimed solve
+};
+
+class DungeonBenchmark {
+private:
+    BenchmarkConfig config;
+    vector<CaseResult> results;
+
+public:
+    explicit DungeonBenchmark(const BenchmarkConfig& config) : config(config) {
+        if (this->config.threads <= 0) {
+            unsigned int hardware = std::thread::hardware_concurrency();
+            this->config.threads = hardware > 0 ? static_cast<int>(hardware) : 1;
+        }
+    }
+
+    void runAll() {
+        printHeader();
+        for (int size : config.sizes) {
+            for (const Aspect& aspect : kAspects) {
+                if (!selected(config.aspects, aspect.name)) continue;
+                for (const Distribution& distribution : kDistributions) {
+                    if (!selected(config.distributions, distribution.name)) continue;
+                    runGrid(size, aspect, distribution);
+                }
+            }
+        }
+    }
+
+    bool writeJson(const string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            return false;
+        }
+
+        out << std::setprecision(10);
+        out << "{\n";
+        out << "  \"schema\": \"dungeon-benchmark/1\",\n";
+        out << "  \"cpu\": \"" << escape(cpuModelName()) << "\",\n";
+        out << "  \"compiler\": \"" << escape(compilerName()) << "\",\n";
+        out << "  \"threads\": " << config.threads << ",\n";
+        out << "  \"case_seconds\": " << config.caseSeconds << ",\n";
+        // false: peak_rss_bytes is the process lifetime peak, not per solve
+        bool rssPerSolve = !results.empty() && results[0].memory.rssPerSolve;
+        out << "  \"rss_per_solve\": " << (rssPerSolve ? "true" : "false") << ",\n";
+        out << "  \"results\": [";
+        for (size_t r = 0; r < results.size(); r++) {
+            const CaseResult& result = results[r];
+            double cells = static_cast<double>(result.rows) * result.cols;
+            out << (r ? ",\n" : "\n");
+            out << "    {\"kernel\": \"" << result.kernel << "\""
+                << ", \"distribution\": \"" << result.distribution << "\""
+                << ", \"aspect\": \"" << result.aspect << "\""
+                << ", \"rows\": " << result.rows << ", \"cols\": " << result.cols
+                << ", \"batch\": " << result.batch << ", \"answer\": " << result.answer
+                << ", \"count\": " << result.stats.count
+                << ", \"min_ns\": " << result.stats.min
+                << ", \"median_ns\": " << result.stats.median
+                << ", \"p95_ns\": " << result.stats.p95
+                << ", \"mean_ns\": " << result.stats.mean
+                << ", \"stddev_ns\": " << result.stats.stddev
+                << ", \"ns_per_cell\": " << result.stats.median / cells
+                << ", \"allocations\": " << result.memory.allocations
+                << ", \"allocated_bytes\": " << result.memory.bytes
+                << ", \"peak_live_bytes\": " << result.memory.peakLiveBytes
+                << ", \"peak_rss_bytes\": " << result.memory.peakRssBytes
+                << ", \"samples_ns\": [";
+            for (size_t s = 0; s < result.samples.size(); s++) {
+                out << (s ? ", " : "") << result.samples[s];
+            }
+            out << "]}";
+        }
+        out << "\n  ]\n}\n";
+        return static_cast<bool>(out);
+    }
+
+private:
+    static bool selected(const vector<string>& filter, const string& name) {
+        return filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+    }
+
+    void runGrid(int size, const Aspect& aspect, const Distribution& distribution) {
+        int rows = max(1, static_cast<int>(static_cast<long long>(size) * aspect.rowsPer4 / 4));
+        int cols = max(1, static_cast<int>(static_cast<long long>(size) * aspect.colsPer4 / 4));
+
+        // Setup, untimed: the grid, its nested copy and the int16 check
+        DungeonGrid grid = syntheticGrid(rows, cols, static_cast<uint32_t>(size * 31 + rows),
+                                         distribution.low, distribution.high);
+        bool wantNested = selected(config.kernels, "dp1d_nested") ||
+                          selected(config.kernels, "inplace_nested");
+        vector<vector<int>> nested;
+        if (wantNested) {
+            nested = grid.toNested();
+        }
+        bool int16Fits = DungeonKernels::fitsInt16(grid);
+
+        DungeonGameOptimized optimized;
+        vector<vector<vector<int>>> copies;
+        int tile = 256;
+        int threads = config.threads;
+
+        vector<BenchmarkCase> cases;
+        cases.push_back({"dp1d_nested", [](int) {},
+                         [&](int) { return optimized.calculateMinimumHP(nested); }});
+        cases.push_back({"inplace_nested",
+                         [&](int batch) { copies.assign(batch, nested); },
+                         [&](int k) { return optimized.calculateMinimumHPInPlace(copies[k]); }});
+        cases.push_back({"scalar1d", [](int) {},
+                         [&](int) { return DungeonKernels::scalar1D(grid); }});
+        if (int16Fits) {
+            cases.push_back({"wavefront16", [](int) {},
+                             [&](int) { return DungeonKernels::wavefront<int16_t>(grid); }});
+        }
+        cases.push_back({"wavefront32", [](int) {},
+                         [&](int) { return DungeonKernels::wavefront<int32_t>(grid); }});
+        cases.push_back({"tiled", [](int) {},
+                         [&](int) { return DungeonKernels::tiledParallel(grid, tile, tile, threads); }});
+        cases.push_back({"fulltable", [](int) {},
+                         [&](int) { return DungeonKernels::fullTable(grid, nullptr); }});
+
+        int expected = -1;
+        for (auto& benchmarkCase : cases) {
+            if (!selected(config.kernels, benchmarkCase.kernel)) continue;
+
+            CaseResult result = measure(benchmarkCase);
+            result.distribution = distribution.name;
+            result.aspect = aspect.name;
+            result.rows = rows;
+            result.cols = cols;
+            printRow(result);
+
+            // Every kernel solves the same grid; a mismatch means a broken kernel
+            if (expected == -1) {
+                expected = result.answer;
+            } else if (result.answer != expected) {
+                cerr << "WARNING: " << result.kernel << " answered " << result.answer
+                     << ", expected " << expected << endl;
+            }
+            results.push_back(result);
+        }
+    }
+
+    CaseResult measure(BenchmarkCase& benchmarkCase) {
+        typedef std::chrono::steady_clock Clock;
+        CaseResult result;
+        result.kernel = benchmarkCase.kernel;
+        int answer = 0;
+
+        auto sample = [&](int batch) {
+            benchmarkCase.prepare(batch);
+            auto start = Clock::now();
+            for (int k = 0; k < batch; k++) {
+                answer = benchmarkCase.run(k);
+            }
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        };
+
+        // Batch size: one sample should last at least 20 µs
+        int batch = 1;
+        double ns = sample(batch);
+        while (ns < 20000 && batch < (1 << 20)) {
+            batch = ns > 0 ? min(1 << 20, max(batch * 2, static_cast<int>(batch * 25000 / ns))) : batch * 2;
+            ns = sample(batch);
+        }
+
+        // Warmup: caches, page faults, frequency ramp
+        double warmupNs = config.warmupSeconds * 1e9;
+        for (double spent = ns; spent < warmupNs; ) {
+            spent += sample(batch);
+        }
+
+        // Don't let very slow cases take more than ~10x the budget
+        double perSample = sample(batch);
+        double budgetNs = config.caseSeconds * 1e9;
+        int minSamples = max(3, min(config.minSamples, static_cast<int>(10 * budgetNs / perSample)));
+
+        double spent = 0;
+        while (static_cast<int>(result.samples.size()) < config.maxSamples) {
+            double elapsed = sample(batch);
+            spent += elapsed;
+            result.samples.push_back(elapsed / batch);
+
+            if (static_cast<int>(result.samples.size()) >= minSamples && spent >= budgetNs) {
+                SampleStats running = summarize(result.samples);
+                double standardError = running.stddev / std::sqrt(static_cast<double>(running.count));
+                if (standardError < 0.01 * running.mean || spent >= 3 * budgetNs) {
+                    break;
+                }
+            }
+        }
+
+        // Memory of a single solve, outside the timed samples
+        benchmarkCase.prepare(1);
+        result.memory = measureAllocations([&]() { answer = benchmarkCase.run(0); });
+
+        result.batch = batch;
+        result.answer = answer;
+        result.stats = summarize(result.samples);
+        return result;
+    }
+
+    void printHeader() const {
+        cout << "CPU: " << cpuModelName() << ", threads: " << config.threads << endl;
+        cout << std::left << std::setw(16) << "Kernel" << std::setw(11) << "Values"
+             << std::setw(8) << "Shape" << std::setw(14) << "Grid" << std::right
+             << std::setw(8) << "Samples" << std::setw(13) << "Min (us)"
+             << std::setw(13) << "Median (us)" << std::setw(13) << "p95 (us)"
+             << std::setw(10) << "Stddev %" << std::setw(10) << "ns/cell" << endl;
+        cout << string(116, '-') << endl;
+    }
+
+    static void printRow(const CaseResult& result) {
+        double cells = static_cast<double>(result.rows) * result.cols;
+        string shape = std::to_string(result.rows) + "x" + std::to_string(result.cols);
+        cout << std::left << std::setw(16) << result.kernel << std::setw(11) << result.distribution
+             << std::setw(8) << result.aspect << std::setw(14) << shape << std::right
+             << std::setw(8) << result.stats.count << std::fixed << std::setprecision(2)
+             << std::setw(13) << result.stats.min / 1e3
+             << std::setw(13) << result.stats.median / 1e3
+             << std::setw(13) << result.stats.p95 / 1e3
+             << std::setw(10) << 100 * result.stats.stddev / result.stats.mean
+             << std::setprecision(3) << std::setw(10) << result.stats.median / cells << endl;
+        cout.unsetf(std::ios::fixed);
+    }
+
+    static string compilerName() {
+#if defined(__clang__)
+        return string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+        return string("gcc ") + __VERSION__;
+#else
+        return "unknown";
+#endif
+    }
+
+    static string escape(const string& text) {
+        string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') escaped.push_back('\\');
+            escaped.push_back(c);
+        }
+        return escaped;
+    }
+};
+
+// Allocations per solve of one kernel, with and without a warm Workspace
+struct AllocationRow {
+    string kernel;
+    int threads = 1;
+    double freshPerSolve = 0;
+    double reusedPerSolve = 0;
+    size_t highWater = 0;
+};
+
+static int reportAllocations(const BenchmarkConfig& config) {
+    const int solves = 16;
+    cout << std::left << std::setw(14) << "Kernel" << std::setw(12) << "Grid" << std::right
+         << std::setw(9) << "Threads" << std::setw(14) << "Fresh/solve" << std::setw(16)
+         << "Workspace/solve" << std::setw(16) << "High water (B)" << endl;
+    cout << string(81, '-') << endl;
+
+    bool clean = true;
+    for (int size : config.sizes) {
+        DungeonGrid grid = syntheticGrid(size, size, static_cast<uint32_t>(size * 31 + size), -10, 10);
+        bool int16Fits = DungeonKernels::fitsInt16(grid);
+        int tile = 256;
+
+        typedef std::function<int(Workspace*)> Kernel;
+        vector<std::pair<AllocationRow, Kernel>> kernels;
+        auto add = [&](const string& name, int threads, Kernel kernel) {
+            if (!config.kernels.empty() &&
+                std::find(config.kernels.begin(), config.kernels.end(), name) == config.kernels.end()) {
+                return;
+            }
+            AllocationRow row;
+            row.kernel = name;
+            row.threads = threads;
+            kernels.push_back(std::make_pair(row, kernel));
+        };
+        add("scalar1d", 1, [&](Workspace* ws) { return DungeonKernels::scalar1D(grid, ws); });
+        if (int16Fits) {
+            add("wavefront16", 1, [&](Workspace* ws) { return DungeonKernels::wavefront<int16_t>(grid, ws); });
+        }
+        add("wavefront32", 1, [&](Workspace* ws) { return DungeonKernels::wavefront<int32_t>(grid, ws); });
+        add("tiled", 1, [&](Workspace* ws) { return DungeonKernels::tiledParallel(grid, tile, tile, 1, ws); });
+        if (config.threads > 1) {
+            add("tiled", config.threads, [&](Workspace* ws) {
+                return DungeonKernels::tiledParallel(grid, tile, tile, config.threads, ws);
+            });
+        }
+        add("fulltable", 1, [&](Workspace* ws) { return DungeonKernels::fullTable(grid, nullptr, ws); });
+
+        for (auto& entry : kernels) {
+            AllocationRow& row = entry.first;
+            Kernel& kernel = entry.second;
+            volatile int sink = 0;
+
+            AllocationStats fresh = measureAllocations([&]() {
+                for (int k = 0; k < solves; k++) sink = kernel(nullptr);
+            });
+            Workspace workspace;
+            sink = kernel(&workspace);  // warmup: grows to the high-water mark
+            AllocationStats reused = measureAllocations([&]() {
+                for (int k = 0; k < solves; k++) sink = kernel(&workspace);
+            });
+
+            row.freshPerSolve = static_cast<double>(fresh.allocations) / solves;
+            row.reusedPerSolve = static_cast<double>(reused.allocations) / solves;
+            row.highWater = workspace.highWater();
+            // Only thread start-up may allocate once the workspace is warm
+            if (row.threads == 1 && reused.allocations > 0) {
+                clean = false;
+            }
+
+            string shape = std::to_string(size) + "x" + std::to_string(size);
+            cout << std::left << std::setw(14) << row.kernel << std::setw(12) << shape << std::right
+                 << std::setw(9) << row.threads << std::fixed << std::setprecision(2)
+                 << std::setw(14) << row.freshPerSolve << std::setw(16) << row.reusedPerSolve
+                 << std::setw(16) << row.highWater << endl;
+            cout.unsetf(std::ios::fixed);
+        }
+    }
+
+    if (!clean) {
+        cerr << "A single-threaded kernel allocated with a warm workspace" << endl;
+        return 1;
+    }
+    cout << "Single-threaded kernels make no allocations with a warm workspace" << endl;
+    return 0;
+}
+
+// One kernel in the roofline report. bytesPerCell is the traffic to the
+// level the grid lives in, assuming row and diagonal buffers stay in L1:
+//   memo2d          grid read, memo initialised, memo written     12
+//   dp1d, scalar1d, tiled   grid read once                         4
+//   inplace         grid read and written back                     8
+//   wavefront<T>    grid read, diagonal copy written and read  4 + 2T
+//   fulltable       grid read, table written                       8
+struct RooflineKernel {
+    string name;
+    double bytesPerCell;
+    double computeCeiling;  // cells/ns: the machine's peak for the kernel's lane width
+    std::function<int()> run;
+};
+
+static void printRooflineMachine(const MachineRoofline& machine) {
+    cout << "CPU: " << cpuModelName() << endl;
+    cout << "Caches: L1d " << machine.caches.l1 / 1024 << " KB, L2 " << machine.caches.l2 / 1024
+         << " KB, LLC " << machine.caches.llc / 1024 << " KB" << endl;
+    cout << std::left << std::setw(8) << "Level" << std::right << std::setw(14) << "Probe (KB)"
+         << std::setw(14) << "Read GB/s" << std::setw(14) << "Copy GB/s" << std::setw(14)
+         << "Triad GB/s" << endl;
+    cout << string(64, '-') << endl;
+    for (int l = 0; l < static_cast<int>(MemoryLevel::Count); l++) {
+        const StreamBandwidth& bandwidth = machine.bandwidth[l];
+        cout << std::left << std::setw(8) << memoryLevelName(static_cast<MemoryLevel>(l)) << std::right
+             << std::setw(14) << machine.probeBytes[l] / 1024 << std::fixed << std::setprecision(2)
+             << std::setw(14) << bandwidth.read << std::setw(14) << bandwidth.copy
+             << std::setw(14) << bandwidth.triad << endl;
+        cout.unsetf(std::ios::fixed);
+    }
+    cout << std::fixed << std::setprecision(3)
+         << "Compute peak (cells/ns, independent min/sub/max): int32 " << machine.compute.peak32
+         << ", int16 " << machine.compute.peak16 << endl
+         << "Latency note: a row-order kernel carries each cell into the next, which runs at "
+         << machine.compute.chained << " cells/ns on one core\n" << endl;
+    cout.unsetf(std::ios::fixed);
+}
+
+static int reportRoofline(const BenchmarkConfig& config) {
+    MachineRoofline machine = measureMachineRoofline(config.rooflineMaxBytes);
+    printRooflineMachine(machine);
+
+    cout << std::left << std::setw(7) << "Level" << std::setw(16) << "Kernel" << std::setw(14)
+         << "Grid" << std::right << std::setw(11) << "cells/ns" << std::setw(8) << "B/cell"
+         << std::setw(10) << "GB/s" << std::setw(11) << "Bound" << std::setw(9) << "% bound"
+         << std::setw(9) << "Limit" << endl;
+    cout << string(95, '-') << endl;
+
+    bool mismatch = false;
+    for (int l = 0; l < static_cast<int>(MemoryLevel::Count); l++) {
+        MemoryLevel level = static_cast<MemoryLevel>(l);
+        size_t bytes = residentBytes(level, machine.caches, config.rooflineMaxBytes);
+        int size = max(2, static_cast<int>(std::sqrt(static_cast<double>(bytes / sizeof(int)))));
+        DungeonGrid grid = syntheticGrid(size, size, static_cast<uint32_t>(size * 31 + size), -10, 10);
+        bool int16Fits = DungeonKernels::fitsInt16(grid);
+        vector<vector<int>> nested = grid.toNested();
+        // In-place overwrites its input, so it keeps solving its own output:
+        // the per-cell work is branch-free and does not depend on the values
+        vector<vector<int>> scratch = nested;
+        Workspace workspace;
+        DungeonGameMemo memo;
+        DungeonGameOptimized optimized;
+        int tile = 256;
+        double peak = machine.compute.peak32;
+
+        vector<RooflineKernel> kernels;
+        kernels.push_back({"memo2d", 12, peak, [&]() { return memo.calculateMinimumHP(nested); }});
+        kernels.push_back({"dp1d_nested", 4, peak, [&]() { return optimized.calculateMinimumHP(nested); }});
+        kernels.push_back({"inplace_nested", 8, peak,
+                           [&]() { return optimized.calculateMinimumHPInPlace(scratch); }});
+        kernels.push_back({"scalar1d", 4, peak, [&]() { return DungeonKernels::scalar1D(grid, &workspace); }});
+        if (int16Fits) {
+            kernels.push_back({"wavefront16", 8, machine.compute.peak16,
+                               [&]() { return DungeonKernels::wavefront<int16_t>(grid, &workspace); }});
+        }
+        kernels.push_back({"wavefront32", 12, peak,
+                           [&]() { return DungeonKernels::wavefront<int32_t>(grid, &workspace); }});
+        kernels.push_back({"tiled", 4, peak,
+                           [&]() { return DungeonKernels::tiledParallel(grid, tile, tile, 1, &workspace); }});
+        kernels.push_back({"fulltable", 8, peak,
+                           [&]() { return DungeonKernels::fullTable(grid, nullptr, &workspace); }});
+
+        int expected = DungeonKernels::scalar1D(grid, &workspace);
+        for (RooflineKernel& kernel : kernels) {
+            if (!config.kernels.empty() &&
+                std::find(config.kernels.begin(), config.kernels.end(), kernel.name) == config.kernels.end()) {
+                continue;
+            }
+            int answer = kernel.run();
+            if (kernel.name != "inplace_nested" && answer != expected) {
+                cerr << "WARNING: " << kernel.name << " answered " << answer
+                     << ", expected " << expected << endl;
+                mismatch = true;
+            }
+
+            volatile int sink = 0;
+            double ns = bestTimeNs([&]() { sink = kernel.run(); }, config.caseSeconds * 1e9 / 10);
+            double cells = static_cast<double>(size) * size;
+            double achieved = cells / ns;
+            double bandwidth = machine.bandwidth[l].triad;
+            double bound = rooflineBound(kernel.computeCeiling, bandwidth, kernel.bytesPerCell);
+            bool memoryBound = bandwidth / kernel.bytesPerCell < kernel.computeCeiling;
+
+            string shape = std::to_string(size) + "x" + std::to_string(size);
+            cout << std::left << std::setw(7) << memoryLevelName(level) << std::setw(16) << kernel.name
+                 << std::setw(14) << shape << std::right << std::fixed << std::setprecision(3)
+                 << std::setw(11) << achieved << std::setprecision(0) << std::setw(8) << kernel.bytesPerCell
+                 << std::setprecision(2) << std::setw(10) << achieved * kernel.bytesPerCell
+                 << std::setprecision(3) << std::setw(11) << bound << std::setprecision(1)
+                 << std::setw(9) << 100 * achieved / bound << std::setw(9)
+                 << (memoryBound ? "memory" : "compute") << endl;
+            cout.unsetf(std::ios::fixed);
+        }
+    }
+
+    // The DRAM row is only DRAM-resident if the grid outgrows the LLC
+    size_t dramBytes = residentBytes(MemoryLevel::DRAM, machine.caches, config.rooflineMaxBytes);
+    if (dramBytes <= machine.caches.llc) {
+        cout << "\nNote: the DRAM grid (" << (dramBytes >> 20) << " MB) fits in the "
+             << (machine.caches.llc >> 20) << " MB LLC; raise --roofline-max-mb above "
+             << 2 * (machine.caches.llc >> 20) << " for a DRAM-resident size" << endl;
+    }
+    return mismatch ? 1 : 0;
+}
+
+static vector<string> splitList(const string& text) {
+    vector<string> items;
+    std::stringstream stream(text);
+    string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+static void printUsage() {
+    cout << "Usage: dungeon_benchmark [options]\n"
+         << "  --sizes N,N,...        grid sizes (cells = N x N; default 64,256,1024,4096)\n"
+         << "  --full                 sizes 64 to 20000 (needs several GB of memory)\n"
+         << "  --max-size N           drop sizes above N\n"
+         << "  --kernels a,b,...      dp1d_nested inplace_nested scalar1d wavefront16\n"
+         << "                         wavefront32 tiled fulltable\n"
+         << "  --distributions a,...  uniform deadly rewarding wide\n"
+         << "  --aspects a,...        square wide tall\n"
+         << "  --time SECONDS         measurement budget per case (default 0.5)\n"
+         << "  --threads N            threads for the tiled kernel\n"
+         << "  --json PATH            output file (default benchmark_results.json)\n"
+         << "  --allocations          count allocations per solve with and without a Workspace\n"
+         << "  --roofline             measure bandwidth and compute ceilings, then report each\n"
+         << "                         kernel against the roofline at L1/L2/LLC/DRAM grid sizes\n"
+         << "                         (adds the memo2d kernel)\n"
+         << "  --roofline-max-mb N    largest grid the roofline mode builds (default 256)\n";
+}
+
+int main(int argc, char** argv) {
+    BenchmarkConfig config;
+    int maxSize = INT_MAX;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sizes" && hasValue) {
+            config.sizes.clear();
+            for (const auto& size : splitList(argv[++i])) config.sizes.push_back(std::atoi(size.c_str()));
+        } else if (arg == "--full") {
+            config.sizes = {64, 256, 1024, 4096, 10000, 20000};
+        } else if (arg == "--max-size" && hasValue) {
+            maxSize = std::atoi(argv[++i]);
+        } else if (arg == "--kernels" && hasValue) {
+            config.kernels = splitList(argv[++i]);
+        } else if (arg == "--distributions" && hasValue) {
+            config.distributions = splitList(argv[++i]);
+        } else if (arg == "--aspects" && hasValue) {
+            config.aspects = splitList(argv[++i]);
+        } else if (arg == "--time" && hasValue) {
+            config.caseSeconds = std::atof(argv[++i]);
+            config.warmupSeconds = min(config.warmupSeconds, config.caseSeconds);
+        } else if (arg == "--threads" && hasValue) {
+            config.threads = std::atoi(argv[++i]);
+        } else if (arg == "--json" && hasValue) {
+            config.jsonPath = argv[++i];
+        } else if (arg == "--allocations") {
+            config.allocations = true;
+        } else if (arg == "--roofline") {
+            config.roofline = true;
+        } else if (arg == "--roofline-max-mb" && hasValue) {
+            config.rooflineMaxBytes = static_cast<size_t>(max(1, std::atoi(argv[++i]))) << 20;
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    config.sizes.erase(std::remove_if(config.sizes.begin(), config.sizes.end(),
+                                      [&](int size) { return size < 1 || size > maxSize; }),
+                       config.sizes.end());
+    for (const auto& kernel : config.kernels) {
+        bool rooflineOnly = config.roofline && kernel == "memo2d";
+        if (!rooflineOnly &&
+            std::find(std::begin(kKernelNames), std::end(kKernelNames), kernel) == std::end(kKernelNames)) {
+            cerr << "Unknown kernel: " << kernel << endl;
+            return 1;
+        }
+    }
+
+    if (config.allocations) {
+        if (config.threads <= 0) {
+            unsigned int hardware = std::thread::hardware_concurrency();
+            config.threads = hardware > 0 ? static_cast<int>(hardware) : 1;
+        }
+        return reportAllocations(config);
+    }
+    if (config.roofline) {
+        return reportRoofline(config);
+    }
+
+    DungeonBenchmark benchmark(config);
+    benchmark.runAll();
+
+    if (!benchmark.writeJson(config.jsonPath)) {
+        cerr << "Cannot write " << config.jsonPath << endl;
+        return 1;
+    }
+    cout << "\nResults written to " << config.jsonPath << endl;
+    return 0;
+}
@@ -0,0 +1,309 @@
+#ifndef DUNGEON_GAME_DUNGEON_FILE_H
+#define DUNGEON_GAME_DUNGEON_FILE_H
+
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+#include <climits>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define DUNGEON_FILE_MMAP 1
+#endif
+
+#include "dungeon_grid.h"
+
+/**
+ * Binary dungeon file (.dgrid)
+ *
+ *   [0, 4096)       DungeonFileHeader, zero padded
+ *   [4096, ...)     rows * cols int32 cells, row-major, host byte order
+ *
+ * The cells start on a page boundary, so the file can be memory-mapped
+ * and handed to the kernels as it is, and read with O_DIRECT. byteOrder
+ * holds 0x01020304 as the writer stored it; a reader on a host of the
+ * other endianness sees it swapped and rejects the file. The generator
+ * fields record how the file was made, for reproducing it.
+ */
+struct DungeonFileHeader {
+    char magic[8];         // "DGRID\0\0\0"
+    uint32_t version;
+    uint32_t headerBytes;  // offset of the first cell
+    uint32_t byteOrder;
+    uint32_t cellBytes;
+    uint64_t rows;
+    uint64_t cols;
+    uint32_t family;       // DungeonFamily of the generator, or ~0u
+    int32_t low;
+    int32_t high;
+    uint32_t reserved;
+    uint64_t seed;
+};
+
+const uint32_t kDungeonFileVersion = 1;
+const uint32_t kDungeonFileHeaderBytes = 4096;
+const uint32_t kDungeonFileByteOrder = 0x01020304u;
+
+inline DungeonFileHeader makeDungeonFileHeader(int rows, int cols) {
+    DungeonFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "DGRID", 5);
+    header.version = kDungeonFileVersion;
+    header.headerBytes = kDungeonFileHeaderBytes;
+    header.byteOrder = kDungeonFileByteOrder;
+    header.cellBytes = sizeof(int32_t);
+    header.rows = static_cast<uint64_t>(rows);
+    header.cols = static_cast<uint64_t>(cols);
+    header.family = ~0u;
+    return header;
+}
+
+// Empty string if the header describes a file of fileBytes this build can map
+inline std::string checkDungeonFileHeader(const DungeonFileHeader& header, uint64_t fileBytes) {
+    if (std::memcmp(header.magic, "DGRID\0\0\0", 8) != 0) {
+        return "not a dungeon file";
+    }
+    if (header.byteOrder != kDungeonFileByteOrder) {
+        return "written on a host of the other byte order";
+    }
+    if (header.version != kDungeonFileVersion || header.cellBytes != sizeof(int32_t) ||
+        header.headerBytes < sizeof(DungeonFileHeader)) {
+        return "unsupported format version";
+    }
+    if (header.rows > static_cast<uint64_t>(INT_MAX) || header.cols > static_cast<uint64_t>(INT_MAX)) {
+        return "grid dimensions exceed int";
+    }
+    if (header.rows * header.cols > (uint64_t(1) << 60)) {
+        return "grid too large";
+    }
+    if (fileBytes < header.headerBytes + header.rows * header.cols * sizeof(int32_t)) {
+        return "file is shorter than its header says";
+    }
+    return "";
+}
+
+/**
+ * A whole file mapped into memory: openRead maps it read-only, create
+ * sizes (or truncates) it, allocating its blocks where the filesystem
+ * can, and maps it read-write, zero filled. Errors come
+ * back as false, with the reason in error(). Needs POSIX mmap; elsewhere
+ * both always fail.
+ */
+class FileMapping {
+private:
+    char* base = nullptr;
+    size_t bytes = 0;
+    bool opened = false;
+    std::string lastError;
+
+    bool fail(const std::string& path, const std::string& reason) {
+        close();
+        lastError = path + ": " + reason;
+        return false;
+    }
+
+#if defined(DUNGEON_FILE_MMAP)
+    // Size the file with its blocks allocated, so a full disk fails here
+    // with ENOSPC instead of as SIGBUS on a store through the mapping.
+    // Filesystems that cannot preallocate get a sparse file from ftruncate.
+    // Returns 0 or the error code.
+    static int reserve(int fd, uint64_t size) {
+#if !defined(__APPLE__)
+        int code = posix_fallocate(fd, 0, static_cast<off_t>(size));
+        if (code != EOPNOTSUPP && code != EINVAL) {
+            return code;  // EINVAL: size 0, or no fallocate on some filesystems
+        }
+#endif
+        return ftruncate(fd, static_cast<off_t>(size)) == 0 ? 0 : errno;
+    }
+
+    bool map(const std::string& path, int fd, size_t size, int protection) {
+        // An empty file has nothing to map but is not an error
+        void* mapping = size > 0 ? mmap(nullptr, size, protection, MAP_SHARED, fd, 0) : nullptr;
+        int code = errno;
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            return fail(path, std::strerror(code));
+        }
+        base = static_cast<char*>(mapping);
+        bytes = size;
+        opened = true;
+        return true;
+    }
+#endif
+
+public:
+    FileMapping() {}
+    ~FileMapping() { close(); }
+
+    FileMapping(const FileMapping&) = delete;
+    FileMapping& operator=(const FileMapping&) = delete;
+
+    bool openRead(const std::string& path) {
+        close();
+#if defined(DUNGEON_FILE_MMAP)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return fail(path, std::strerror(errno));
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            int code = errno;
+            ::close(fd);
+            return fail(path, std::strerror(code));
+        }
+        return map(path, fd, static_cast<size_t>(info.st_size), PROT_READ);
+#else
+        return fail(path, "memory-mapped files need POSIX mmap");
+#endif
+    }
+
+    bool create(const std::string& path, uint64_t size) {
+        close();
+#if defined(DUNGEON_FILE_MMAP)
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return fail(path, std::strerror(errno));
+        }
+        int code = reserve(fd, size);
+        if (code != 0) {
+            ::close(fd);
+            return fail(path, std::strerror(code));
+        }
+        return map(path, fd, static_cast<size_t>(size), PROT_READ | PROT_WRITE);
+#else
+        (void)size;
+        return fail(path, "memory-mapped files need POSIX mmap");
+#endif
+    }
+
+    void close() {
+#if defined(DUNGEON_FILE_MMAP)
+        if (base) {
+            munmap(base, bytes);
+        }
+#endif
+        base = nullptr;
+        bytes = 0;
+        opened = false;
+        lastError.clear();
+    }
+
+    bool isOpen() const { return opened; }
+    const std::string& error() const { return lastError; }
+    char* data() { return base; }
+    const char* data() const { return base; }
+    size_t size() const { return bytes; }
+};
+
+/**
+ * A dungeon file mapped into memory, read-only or (create) read-write
+ *
+ * row(i) points into the mapping, so
+ *
+ *     DungeonKernels::streaming(file.rows(), file.cols(),
+ *                               [&file](int i) { return file.row(i); })
+ *
+ * solves a file larger than RAM in O(cols) memory, the page cache doing
+ * the I/O. Errors are reported as by FileMapping.
+ */
+class MappedDungeonFile {
+private:
+    DungeonFileHeader fileHeader;
+    FileMapping mapping;
+    int* cells = nullptr;
+    std::string lastError;
+
+    // By value: the reason may be mapping.error(), which close() clears
+    bool fail(std::string reason) {
+        close();
+        lastError = reason;
+        return false;
+    }
+
+public:
+    MappedDungeonFile() { std::memset(&fileHeader, 0, sizeof(fileHeader)); }
+
+    MappedDungeonFile(const MappedDungeonFile&) = delete;
+    MappedDungeonFile& operator=(const MappedDungeonFile&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        if (!mapping.openRead(path)) {
+            return fail(mapping.error());
+        }
+        if (mapping.size() < sizeof(DungeonFileHeader)) {
+            return fail(path + ": not a dungeon file");
+        }
+        std::memcpy(&fileHeader, mapping.data(), sizeof(fileHeader));
+        std::string problem = checkDungeonFileHeader(fileHeader, mapping.size());
+        if (!problem.empty()) {
+            return fail(path + ": " + problem);
+        }
+        cells = reinterpret_cast<int*>(mapping.data() + fileHeader.headerBytes);
+        return true;
+    }
+
+    // Creates (or truncates) path at its full size and maps it for writing;
+    // the cells read as zero until written
+    bool create(const std::string& path, const DungeonFileHeader& header) {
+        close();
+        std::string problem = checkDungeonFileHeader(header, UINT64_MAX);
+        if (!problem.empty()) {
+            return fail(path + ": " + problem);
+        }
+        if (!mapping.create(path, header.headerBytes + header.rows * header.cols * sizeof(int32_t))) {
+            return fail(mapping.error());
+        }
+        fileHeader = header;
+        std::memcpy(mapping.data(), &fileHeader, sizeof(fileHeader));
+        cells = reinterpret_cast<int*>(mapping.data() + fileHeader.headerBytes);
+        return true;
+    }
+
+    void close() {
+        mapping.close();
+        cells = nullptr;
+        lastError.clear();
+    }
+
+    bool isOpen() const { return cells != nullptr; }
+    const std::string& error() const { return lastError; }
+    const DungeonFileHeader& header() const { return fileHeader; }
+
+    int rows() const { return static_cast<int>(fileHeader.rows); }
+    int cols() const { return static_cast<int>(fileHeader.cols); }
+    size_t size() const { return static_cast<size_t>(fileHeader.rows) * fileHeader.cols; }
+
+    int* data() { return cells; }
+    const int* data() const { return cells; }
+    const int* row(int i) const { return cells + static_cast<size_t>(i) * cols(); }
+
+    DungeonGrid toGrid() const {
+        DungeonGrid grid(rows(), cols());
+        if (!grid.empty()) {
+            std::copy(cells, cells + size(), grid.cells.begin());
+        }
+        return grid;
+    }
+};
+
+// Writes grid to path through a mapping; false (and the reason in error,
+// if given) when it cannot
+inline bool writeDungeonFile(const std::string& path, const DungeonGrid& grid, std::string* error = nullptr) {
+    MappedDungeonFile file;
+    if (!file.create(path, makeDungeonFileHeader(grid.rows, grid.cols))) {
+        if (error) *error = file.error();
+        return false;
+    }
+    std::copy(grid.cells.begin(), grid.cells.end(), file.data());
+    return true;
+}
+
+#endif // DUNGEON_GAME_DUNGEON_FILE_H
@@ -1,8 +1,13 @@
 #include <iostream>
 #include <vector>
 #include <climits>
+#include <chrono>
+#include <cstdlib>
 #include <algorithm>
 
+#include "dungeon_generator.h"
+#include "solver_workspace.h"
+
 using std::vector;
 using std::max;
 using std::min;
@@ -21,7 +26,9 @@ using std::endl;
  */
 class DungeonGameOptimized {
 public:
-    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+    // The row comes from `workspace` if given (solver_workspace.h), so
+    // repeated solves with a warm workspace do not allocate
+    int calculateMinimumHP(vector<vector<int>>& dungeon, Workspace* workspace = nullptr) {
         if (dungeon.empty() || dungeon[0].empty()) {
             return 1;
         }
@@ -29,9 +36,13 @@ public:
         int rows = dungeon.size();
         int cols = dungeon[0].size();
         
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        
         // Single array to store minimum health needed for current row
         // dp[j] = minimum health needed at position (i, j)
-        vector<int> dp(cols, INT_MAX);
+        int* dp = scratch.allocate<int>(cols, INT_MAX);
         
         // Start from bottom-right (princess room) and work backwards
         // For the last row, we can compute directly
@@ -64,7 +75,7 @@ public:
      * Alternative implementation that processes left-to-right, top-to-bottom
      * This requires storing the entire last row, but demonstrates the concept
      */
-    int calculateMinimumHPAlternative(vector<vector<int>>& dungeon) {
+    int calculateMinimumHPAlternative(vector<vector<int>>& dungeon, Workspace* workspace = nullptr) {
         if (dungeon.empty() || dungeon[0].empty()) {
             return 1;
         }
@@ -72,9 +83,14 @@ public:
         int rows = dungeon.size();
         int cols = dungeon[0].size();
         
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        scratch.reserve(2 * Workspace::bytesFor<int>(cols));
+        
         // Use two arrays to alternate between current and next row
-        vector<int> curr(cols, 0);
-        vector<int> next(cols, 0);
+        int* curr = scratch.allocate<int>(cols, 0);
+        int* next = scratch.allocate<int>(cols, 0);
         
         // Initialize the princess room (bottom-right corner)
         next[cols - 1] = max(1, 1 - dungeon[rows - 1][cols - 1]);
@@ -86,7 +102,7 @@ public:
         
         // Process from second-to-last row upwards
         for (int i = rows - 2; i >= 0; i--) {
-            curr = vector<int>(cols, INT_MAX);
+            std::fill(curr, curr + cols, INT_MAX);
             
             // Rightmost column - can only come from below
             curr[cols - 1] = max(1, next[cols - 1] - dungeon[i][cols - 1]);
@@ -98,7 +114,7 @@ public:
                 curr[j] = max(1, min(fromRight, fromBelow) - dungeon[i][j]);
             }
             
-            next = curr;  // Move to next iteration
+            std::swap(curr, next);  // Move to next iteration
         }
         
         return next[0];
@@ -201,26 +217,28 @@ public:
             
             const int iterations = 1000;
             
+            // Copies for the in-place version are made before the clock starts
+            // (dungeon_benchmark has the full statistics)
+            vector<vector<vector<int>>> copies(iterations, dungeon);
+            
             // Benchmark 1D DP
-            auto start = std::chrono::high_resolution_clock::now();
+            auto start = std::chrono::steady_clock::now();
             for (int i = 0; i < iterations; i++) {
-                vector<vector<int>> testDungeon = dungeon;
-                optimized.calculateMinimumHP(testDungeon);
+                optimized.calculateMinimumHP(dungeon);
             }
-            auto end = std::chrono::high_resolution_clock::now();
-            auto time1D = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+            auto end = std::chrono::steady_clock::now();
+            double time1D = std::chrono::duration<double, std::micro>(end - start).count();
             
             // Benchmark in-place DP
-            start = std::chrono::high_resolution_clock::now();
+            start = std::chrono::steady_clock::now();
             for (int i = 0; i < iterations; i++) {
-                vector<vector<int>> testDungeon = dungeon;
-                optimized.calculateMinimumHPInPlace(testDungeon);
+                optimized.calculateMinimumHPInPlace(copies[i]);
             }
-            end = std::chrono::high_resolution_clock::now();
-            auto timeInPlace = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+            end = std::chrono::steady_clock::now();
+            double timeInPlace = std::chrono::duration<double, std::micro>(end - start).count();
             
-            cout << "1D DP: " << time1D.count() / iterations << " μs/iteration" << endl;
-            cout << "In-place DP: " << timeInPlace.count() / iterations << " μs/iteration" << endl;
+            cout << "1D DP: " << time1D / iterations << " μs/iteration" << endl;
+            cout << "In-place DP: " << timeInPlace / iterations << " μs/iteration" << endl;
             cout << "Memory saved: " << (size * size * sizeof(int)) << " bytes" << endl;
         }
     }
@@ -238,13 +256,8 @@ private:
     }
     
     vector<vector<int>> generateRandomDungeon(int rows, int cols) {
-        vector<vector<int>> dungeon(rows, vector<int>(cols));
-        for (int i = 0; i < rows; i++) {
-            for (int j = 0; j < cols; j++) {
-                dungeon[i][j] = (rand() % 21) - 10;  // Random values from -10 to 10
-            }
-        }
-        return dungeon;
+        // Values from -10 to 10, the same on every platform
+        return DungeonGenerator(GeneratorSpec::make(DungeonFamily::Uniform, rows, cols, 1)).generate().toNested();
     }
 };
 
@@ -5,6 +5,11 @@
 #include <algorithm>
 #include <cmath>
 
+#include "indexed_heap.h"
+#include "solver_workspace.h"
+#include "forward_sweep.h"
+#include "parallel_health_search.h"
+
 using std::vector;
 using std::priority_queue;
 using std::pair;
@@ -13,87 +18,91 @@ using std::min;
 using std::cout;
 using std::endl;
 
-struct AStarState {
-    int row, col, minHealthNeeded;
-    double fScore; // g(n) + h(n)
-    
-    AStarState(int r, int c, int h, double f) 
-        : row(r), col(c), minHealthNeeded(h), fScore(f) {}
-    
-    // For priority queue (min-heap based on f-score)
-    bool operator>(const AStarState& other) const {
-        return fScore > other.fScore;
-    }
-};
-
 class DungeonGameAStar {
 private:
     vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
     
 public:
-    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+    // Scratch memory comes from `workspace` if given (solver_workspace.h),
+    // so repeated solves with a warm workspace do not allocate
+    int calculateMinimumHP(vector<vector<int>>& dungeon, Workspace* workspace = nullptr) {
         if (dungeon.empty() || dungeon[0].empty()) {
             return 1;
         }
         
         int rows = dungeon.size();
         int cols = dungeon[0].size();
+        int cells = rows * cols;
+        
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        scratch.reserve(scratchBytes(cells));
         
         // A* working backwards from princess to start
-        vector<vector<int>> minHealth(rows, vector<int>(cols, INT_MAX));
-        vector<vector<bool>> visited(rows, vector<bool>(cols, false));
-        priority_queue<AStarState, vector<AStarState>, std::greater<AStarState>> pq;
+        // Cells are addressed by flat index (row * cols + col); each cell is
+        // queued at most once and improved in place via decrease-key
+        int* minHealth = scratch.allocate<int>(cells, INT_MAX);
+        FlatBitset closed(cells, scratch);
+        IndexedDaryHeap<double> open(cells, scratch);
         
         // Start from princess room
+        int princess = (rows - 1) * cols + (cols - 1);
         int princessHealth = max(1, 1 - dungeon[rows-1][cols-1]);
-        minHealth[rows-1][cols-1] = princessHealth;
+        minHealth[princess] = princessHealth;
         
         double heuristic = manhattanDistance(rows-1, cols-1, 0, 0);
-        pq.push(AStarState(rows-1, cols-1, princessHealth, princessHealth + heuristic));
+        open.push(princess, princessHealth + heuristic);
         
         // Reverse directions for backward search
-        vector<pair<int, int>> reverseDirections = {{0, -1}, {-1, 0}};
+        const pair<int, int> reverseDirections[] = {{0, -1}, {-1, 0}};
         
-        while (!pq.empty()) {
-            AStarState current = pq.top();
-            pq.pop();
+        while (!open.empty()) {
+            int current = open.pop();
+            closed.set(current);
             
-            // Skip if already visited
-            if (visited[current.row][current.col]) {
-                continue;
-            }
-            visited[current.row][current.col] = true;
+            int row = current / cols;
+            int col = current % cols;
             
             // Found the start position
-            if (current.row == 0 && current.col == 0) {
-                return current.minHealthNeeded;
+            if (current == 0) {
+                return minHealth[current];
             }
             
             // Explore neighbors
             for (auto& dir : reverseDirections) {
-                int newRow = current.row + dir.first;
-                int newCol = current.col + dir.second;
+                int newRow = row + dir.first;
+                int newCol = col + dir.second;
                 
-                if (newRow >= 0 && newRow < rows && newCol >= 0 && newCol < cols 
-                    && !visited[newRow][newCol]) {
-                    
-                    // Calculate health needed at (newRow, newCol)
-                    int healthNeeded = max(1, current.minHealthNeeded - dungeon[newRow][newCol]);
+                if (newRow < 0 || newCol < 0) {
+                    continue;
+                }
+                
+                int next = newRow * cols + newCol;
+                if (closed.test(next)) {
+                    continue;
+                }
+                
+                // Calculate health needed at (newRow, newCol)
+                int healthNeeded = max(1, minHealth[current] - dungeon[newRow][newCol]);
+                
+                if (healthNeeded < minHealth[next]) {
+                    minHealth[next] = healthNeeded;
                     
-                    if (healthNeeded < minHealth[newRow][newCol]) {
-                        minHealth[newRow][newCol] = healthNeeded;
-                        
-                        // Calculate f-score = g-score + heuristic
-                        double h = manhattanDistance(newRow, newCol, 0, 0);
-                        double fScore = healthNeeded + h;
-                        
-                        pq.push(AStarState(newRow, newCol, healthNeeded, fScore));
-                    }
+                    // Calculate f-score = g-score + heuristic
+                    double h = manhattanDistance(newRow, newCol, 0, 0);
+                    open.pushOrDecrease(next, healthNeeded + h);
                 }
             }
         }
         
-        return minHealth[0][0];
+        return minHealth[0];
+    }
+    
+    // minHealth, the closed set and the heap's three arrays
+    static size_t scratchBytes(int cells) {
+        return 3 * Workspace::bytesFor<int>(cells) + Workspace::bytesFor<double>(cells) +
+               Workspace::bytesFor<uint64_t>((cells + 63) / 64);
     }
     
 private:
@@ -123,26 +132,22 @@ private:
     
     vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
     
+    ForwardHealthSearch<NoLaneScratch> search;
+    
 public:
+    explicit DungeonGameAStarForward(FeasibilityBackend backend = FeasibilityBackend::Sweep)
+        : search(backend) {}
+    
     int calculateMinimumHP(vector<vector<int>>& dungeon) {
-        if (dungeon.empty() || dungeon[0].empty()) {
-            return 1;
-        }
-        
-        // Binary search on starting health
-        int left = 1, right = 1000000;
-        
-        while (left < right) {
-            int mid = left + (right - left) / 2;
-            
-            if (canReachPrincess(dungeon, mid)) {
-                right = mid;
-            } else {
-                left = mid + 1;
-            }
-        }
-        
-        return left;
+        return search.minimumHealth(dungeon, [&](int health, NoLaneScratch&) {
+            return canReachPrincess(dungeon, health);
+        });
+    }
+    
+    int calculateMinimumHPParallel(vector<vector<int>>& dungeon, int lanes = defaultSearchLanes()) {
+        return search.minimumHealthParallel(dungeon, lanes, [&](int health, NoLaneScratch&) {
+            return canReachPrincess(dungeon, health);
+        });
     }
     
 private:
@@ -208,78 +213,75 @@ private:
 // A* with more sophisticated heuristics
 class DungeonGameAStarAdvanced {
 private:
-    struct AdvancedState {
-        int row, col, minHealthNeeded;
-        double fScore;
-        
-        AdvancedState(int r, int c, int h, double f) 
-            : row(r), col(c), minHealthNeeded(h), fScore(f) {}
-        
-        bool operator>(const AdvancedState& other) const {
-            return fScore > other.fScore;
-        }
-    };
-    
     vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
     
 public:
-    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+    // Scratch memory comes from `workspace` if given, as in DungeonGameAStar
+    int calculateMinimumHP(vector<vector<int>>& dungeon, Workspace* workspace = nullptr) {
         if (dungeon.empty() || dungeon[0].empty()) {
             return 1;
         }
         
         int rows = dungeon.size();
         int cols = dungeon[0].size();
+        int cells = rows * cols;
         
-        vector<vector<int>> minHealth(rows, vector<int>(cols, INT_MAX));
-        vector<vector<bool>> visited(rows, vector<bool>(cols, false));
-        priority_queue<AdvancedState, vector<AdvancedState>, std::greater<AdvancedState>> pq;
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        scratch.reserve(DungeonGameAStar::scratchBytes(cells));
+        
+        int* minHealth = scratch.allocate<int>(cells, INT_MAX);
+        FlatBitset closed(cells, scratch);
+        IndexedDaryHeap<double> open(cells, scratch);
         
         // Start from princess room
+        int princess = (rows - 1) * cols + (cols - 1);
         int princessHealth = max(1, 1 - dungeon[rows-1][cols-1]);
-        minHealth[rows-1][cols-1] = princessHealth;
+        minHealth[princess] = princessHealth;
         
         double heuristic = advancedHeuristic(dungeon, rows-1, cols-1, 0, 0);
-        pq.push(AdvancedState(rows-1, cols-1, princessHealth, princessHealth + heuristic));
+        open.push(princess, princessHealth + heuristic);
         
         // Reverse directions for backward search
-        vector<pair<int, int>> reverseDirections = {{0, -1}, {-1, 0}};
+        const pair<int, int> reverseDirections[] = {{0, -1}, {-1, 0}};
         
-        while (!pq.empty()) {
-            AdvancedState current = pq.top();
-            pq.pop();
+        while (!open.empty()) {
+            int current = open.pop();
+            closed.set(current);
             
-            if (visited[current.row][current.col]) {
-                continue;
-            }
-            visited[current.row][current.col] = true;
+            int row = current / cols;
+            int col = current % cols;
             
-            if (current.row == 0 && current.col == 0) {
-                return current.minHealthNeeded;
+            if (current == 0) {
+                return minHealth[current];
             }
             
             for (auto& dir : reverseDirections) {
-                int newRow = current.row + dir.first;
-                int newCol = current.col + dir.second;
+                int newRow = row + dir.first;
+                int newCol = col + dir.second;
                 
-                if (newRow >= 0 && newRow < rows && newCol >= 0 && newCol < cols 
-                    && !visited[newRow][newCol]) {
-                    
-                    int healthNeeded = max(1, current.minHealthNeeded - dungeon[newRow][newCol]);
+                if (newRow < 0 || newCol < 0) {
+                    continue;
+                }
+                
+                int next = newRow * cols + newCol;
+                if (closed.test(next)) {
+                    continue;
+                }
+                
+                int healthNeeded = max(1, minHealth[current] - dungeon[newRow][newCol]);
+                
+                if (healthNeeded < minHealth[next]) {
+                    minHealth[next] = healthNeeded;
                     
-                    if (healthNeeded < minHealth[newRow][newCol]) {
-                        minHealth[newRow][newCol] = healthNeeded;
-                        
-                        double h = advancedHeuristic(dungeon, newRow, newCol, 0, 0);
-                        double fScore = healthNeeded + h;
-                        
-                        pq.push(AdvancedState(newRow, newCol, healthNeeded, fScore));
-                    }
+                    double h = advancedHeuristic(dungeon, newRow, newCol, 0, 0);
+                    open.pushOrDecrease(next, healthNeeded + h);
                 }
             }
         }
         
-        return minHealth[0][0];
+        return minHealth[0];
     }
     
 private:
@@ -329,7 +331,7 @@ void testAStar() {
     int result1 = solver.calculateMinimumHP(dungeon1);
     int result1_fwd = forwardSolver.calculateMinimumHP(dungeon1);
     int result1_adv = advancedSolver.calculateMinimumHP(dungeon1);
-    cout << "Test 1 - Expected: 7, Got (backward): " << result1 
+    cout << "Test 1 - Expected: 4, Got (backward): " << result1 
          << ", Got (forward): " << result1_fwd 
          << ", Got (advanced): " << result1_adv << endl;
     
@@ -360,6 +362,13 @@ void testAStar() {
          << ", Got (forward): " << result4_fwd 
          << ", Got (advanced): " << result4_adv << endl;
     
+    DungeonGameAStarForward traversalSolver(FeasibilityBackend::Traversal);
+    cout << "Test 1 (traversal probes) - Expected: 4, Got: " 
+         << traversalSolver.calculateMinimumHP(dungeon1) << endl;
+    
+    int result1_par = forwardSolver.calculateMinimumHPParallel(dungeon1, 4);
+    cout << "Test 1 (4 parallel lanes) - Expected: 4, Got: " << result1_par << endl;
+    
     cout << "A* Implementation completed!" << endl;
     
     cout << "\n=== Algorithm Analysis ===" << endl;
@@ -3,6 +3,10 @@
 #include <climits>
 #include <algorithm>
 
+#include "forward_sweep.h"
+#include "parallel_health_search.h"
+#include "solver_workspace.h"
+
 using std::vector;
 using std::pair;
 using std::max;
@@ -22,7 +26,10 @@ private:
     vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
     
 public:
-    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+    // The edge list and labels come from `workspace` if given
+    // (solver_workspace.h), so repeated solves with a warm workspace do not
+    // allocate
+    int calculateMinimumHP(vector<vector<int>>& dungeon, Workspace* workspace = nullptr) {
         if (dungeon.empty() || dungeon[0].empty()) {
             return 1;
         }
@@ -30,30 +37,40 @@ public:
         int rows = dungeon.size();
         int cols = dungeon[0].size();
         
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        int edgeCount = rows * (cols - 1) + (rows - 1) * cols;
+        scratch.reserve(Workspace::bytesFor<Edge>(edgeCount) + Workspace::bytesFor<int>(rows * cols));
+        
         // Create edges for the graph
-        vector<Edge> edges;
+        Edge* edges = scratch.allocate<Edge>(edgeCount);
         createEdges(dungeon, edges);
         
         // Use Bellman-Ford to find minimum health needed
-        // We work backwards from princess to start
-        vector<vector<int>> minHealth(rows, vector<int>(cols, INT_MAX));
+        // We work backwards from princess to start; labels are row-major
+        int* minHealthCells = scratch.allocate<int>(rows * cols, INT_MAX);
+        auto minHealth = [minHealthCells, cols](int row, int col) -> int& {
+            return minHealthCells[row * cols + col];
+        };
         
         // Initialize princess room
-        minHealth[rows-1][cols-1] = max(1, 1 - dungeon[rows-1][cols-1]);
+        minHealth(rows-1, cols-1) = max(1, 1 - dungeon[rows-1][cols-1]);
         
         // Relax edges (rows * cols - 1) times
         for (int i = 0; i < rows * cols - 1; i++) {
             bool updated = false;
             
             // Process each edge (in reverse direction for backward algorithm)
-            for (const Edge& edge : edges) {
-                int fromHealth = minHealth[edge.to_row][edge.to_col];
+            for (int e = 0; e < edgeCount; e++) {
+                const Edge& edge = edges[e];
+                int fromHealth = minHealth(edge.to_row, edge.to_col);
                 if (fromHealth != INT_MAX) {
                     // Calculate health needed at source to reach destination
                     int healthNeeded = max(1, fromHealth - dungeon[edge.from_row][edge.from_col]);
                     
-                    if (healthNeeded < minHealth[edge.from_row][edge.from_col]) {
-                        minHealth[edge.from_row][edge.from_col] = healthNeeded;
+                    if (healthNeeded < minHealth(edge.from_row, edge.from_col)) {
+                        minHealth(edge.from_row, edge.from_col) = healthNeeded;
                         updated = true;
                     }
                 }
@@ -63,13 +80,15 @@ public:
             if (!updated) break;
         }
         
-        return minHealth[0][0];
+        return minHealth(0, 0);
     }
     
 private:
-    void createEdges(vector<vector<int>>& dungeon, vector<Edge>& edges) {
+    // Fills edges with the rows * (cols - 1) + (rows - 1) * cols moves
+    void createEdges(vector<vector<int>>& dungeon, Edge* edges) {
         int rows = dungeon.size();
         int cols = dungeon[0].size();
+        int count = 0;
         
         for (int i = 0; i < rows; i++) {
             for (int j = 0; j < cols; j++) {
@@ -80,7 +99,7 @@ private:
                     
                     if (newRow < rows && newCol < cols) {
                         // Edge weight is the value of destination cell
-                        edges.push_back(Edge(i, j, newRow, newCol, dungeon[newRow][newCol]));
+                        edges[count++] = Edge(i, j, newRow, newCol, dungeon[newRow][newCol]);
                     }
                 }
             }
@@ -100,7 +119,8 @@ private:
     vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
     
 public:
-    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+    // Scratch memory comes from `workspace` if given, as in DungeonGameBellmanFord
+    int calculateMinimumHP(vector<vector<int>>& dungeon, Workspace* workspace = nullptr) {
         if (dungeon.empty() || dungeon[0].empty()) {
             return 1;
         }
@@ -113,12 +133,18 @@ public:
         auto getIndex = [cols](int row, int col) { return row * cols + col; };
         auto getCoords = [cols](int idx) { return std::make_pair(idx / cols, idx % cols); };
         
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        int edgeCount = rows * (cols - 1) + (rows - 1) * cols;
+        scratch.reserve(Workspace::bytesFor<Edge>(edgeCount) + Workspace::bytesFor<int>(totalCells));
+        
         // Create edges
-        vector<Edge> edges;
-        createEdges(dungeon, edges, getIndex);
+        Edge* edges = scratch.allocate<Edge>(edgeCount);
+        createEdges(dungeon, edges, cols);
         
         // Bellman-Ford algorithm
-        vector<int> dist(totalCells, INT_MAX);
+        int* dist = scratch.allocate<int>(totalCells, INT_MAX);
         int princessIdx = getIndex(rows - 1, cols - 1);
         
         // Initialize: minimum health needed at princess room
@@ -129,7 +155,8 @@ public:
             bool updated = false;
             
             // Process edges in reverse (for backward propagation)
-            for (const Edge& edge : edges) {
+            for (int e = 0; e < edgeCount; e++) {
+                const Edge& edge = edges[e];
                 if (dist[edge.to_idx] != INT_MAX) {
                     auto [toRow, toCol] = getCoords(edge.to_idx);
                     auto [fromRow, fromCol] = getCoords(edge.from_idx);
@@ -150,10 +177,10 @@ public:
     }
     
 private:
-    void createEdges(vector<vector<int>>& dungeon, vector<Edge>& edges, 
-                    std::function<int(int, int)> getIndex) {
+    // Fills edges with every move, cells by flat index
+    void createEdges(vector<vector<int>>& dungeon, Edge* edges, int cols) {
         int rows = dungeon.size();
-        int cols = dungeon[0].size();
+        int count = 0;
         
         for (int i = 0; i < rows; i++) {
             for (int j = 0; j < cols; j++) {
@@ -162,9 +189,9 @@ private:
                     int newCol = j + dir.second;
                     
                     if (newRow < rows && newCol < cols) {
-                        int fromIdx = getIndex(i, j);
-                        int toIdx = getIndex(newRow, newCol);
-                        edges.push_back(Edge(fromIdx, toIdx, dungeon[newRow][newCol]));
+                        int fromIdx = i * cols + j;
+                        int toIdx = newRow * cols + newCol;
+                        edges[count++] = Edge(fromIdx, toIdx, dungeon[newRow][newCol]);
                     }
                 }
             }
@@ -177,39 +204,39 @@ class DungeonGameBellmanFordForward {
 private:
     vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
     
+    ForwardHealthSearch<vector<int>> search;
+    
 public:
+    explicit DungeonGameBellmanFordForward(FeasibilityBackend backend = FeasibilityBackend::Sweep)
+        : search(backend) {}
+    
     int calculateMinimumHP(vector<vector<int>>& dungeon) {
-        if (dungeon.empty() || dungeon[0].empty()) {
-            return 1;
-        }
-        
-        // Binary search on starting health
-        int left = 1, right = 1000000;
-        
-        while (left < right) {
-            int mid = left + (right - left) / 2;
-            
-            if (canReachPrincess(dungeon, mid)) {
-                right = mid;
-            } else {
-                left = mid + 1;
-            }
-        }
-        
-        return left;
+        return search.minimumHealth(dungeon, [&](int health, vector<int>& scratch) {
+            return canReachPrincess(dungeon, health, scratch);
+        });
+    }
+    
+    int calculateMinimumHPParallel(vector<vector<int>>& dungeon, int lanes = defaultSearchLanes()) {
+        return search.minimumHealthParallel(dungeon, lanes, [&](int health, vector<int>& scratch) {
+            return canReachPrincess(dungeon, health, scratch);
+        });
     }
     
 private:
-    bool canReachPrincess(vector<vector<int>>& dungeon, int startHealth) {
+    bool canReachPrincess(vector<vector<int>>& dungeon, int startHealth, vector<int>& scratch) {
         int rows = dungeon.size();
         int cols = dungeon[0].size();
         
-        // Use Bellman-Ford to find maximum health at each cell
-        vector<vector<int>> maxHealth(rows, vector<int>(cols, INT_MIN));
+        // Use Bellman-Ford to find maximum health at each cell; the labels
+        // are the lane's scratch, row-major
+        scratch.assign(static_cast<size_t>(rows) * cols, INT_MIN);
+        auto maxHealth = [&scratch, cols](int row, int col) -> int& {
+            return scratch[static_cast<size_t>(row) * cols + col];
+        };
         
         // Initialize starting position
-        maxHealth[0][0] = startHealth + dungeon[0][0];
-        if (maxHealth[0][0] <= 0) return false;
+        maxHealth(0, 0) = startHealth + dungeon[0][0];
+        if (maxHealth(0, 0) <= 0) return false;
         
         // Relax edges V-1 times
         for (int iter = 0; iter < rows * cols - 1; iter++) {
@@ -217,7 +244,7 @@ private:
             
             for (int i = 0; i < rows; i++) {
                 for (int j = 0; j < cols; j++) {
-                    if (maxHealth[i][j] == INT_MIN) continue;
+                    if (maxHealth(i, j) == INT_MIN) continue;
                     
                     // Try all neighbors
                     for (auto& dir : directions) {
@@ -225,10 +252,10 @@ private:
                         int newCol = j + dir.second;
                         
                         if (newRow < rows && newCol < cols) {
-                            int newHealth = maxHealth[i][j] + dungeon[newRow][newCol];
+                            int newHealth = maxHealth(i, j) + dungeon[newRow][newCol];
                             
-                            if (newHealth > 0 && newHealth > maxHealth[newRow][newCol]) {
-                                maxHealth[newRow][newCol] = newHealth;
+                            if (newHealth > 0 && newHealth > maxHealth(newRow, newCol)) {
+                                maxHealth(newRow, newCol) = newHealth;
                                 updated = true;
                             }
                         }
@@ -239,7 +266,7 @@ private:
             if (!updated) break;
         }
         
-        return maxHealth[rows-1][cols-1] > 0;
+        return maxHealth(rows-1, cols-1) > 0;
     }
 };
 
@@ -256,7 +283,7 @@ void testBellmanFord() {
     int result1 = solver.calculateMinimumHP(dungeon1);
     int result1_dist = distanceSolver.calculateMinimumHP(dungeon1);
     int result1_fwd = forwardSolver.calculateMinimumHP(dungeon1);
-    cout << "Test 1 - Expected: 7, Got (basic): " << result1 
+    cout << "Test 1 - Expected: 4, Got (basic): " << result1 
          << ", Got (distance): " << result1_dist 
          << ", Got (forward): " << result1_fwd << endl;
     
@@ -287,6 +314,13 @@ void testBellmanFord() {
          << ", Got (distance): " << result4_dist 
          << ", Got (forward): " << result4_fwd << endl;
     
+    DungeonGameBellmanFordForward traversalSolver(FeasibilityBackend::Traversal);
+    cout << "Test 1 (traversal probes) - Expected: 4, Got: " 
+         << traversalSolver.calculateMinimumHP(dungeon1) << endl;
+    
+    int result1_par = forwardSolver.calculateMinimumHPParallel(dungeon1, 4);
+    cout << "Test 1 (4 parallel lanes) - Expected: 4, Got: " << result1_par << endl;
+    
     cout << "Bellman-Ford Implementation completed!" << endl;
     
     cout << "\n=== Algorithm Analysis ===" << endl;
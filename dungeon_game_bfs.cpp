@@ -1,71 +1,65 @@
 #include <iostream>
 #include <vector>
-#include <queue>
 #include <climits>
 #include <algorithm>
 
+#include "search_workspace.h"
+#include "forward_sweep.h"
+#include "parallel_health_search.h"
+
 using std::vector;
-using std::queue;
 using std::pair;
 using std::max;
 using std::min;
 using std::cout;
 using std::endl;
 
-struct State {
-    int row, col, health;
-    
-    State(int r, int c, int h) : row(r), col(c), health(h) {}
-};
-
 class DungeonGameBFS {
 private:
     vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
     
+    ForwardHealthSearch<SearchWorkspace> search;
+    
 public:
+    explicit DungeonGameBFS(FeasibilityBackend backend = FeasibilityBackend::Sweep)
+        : search(backend) {}
+    
     int calculateMinimumHP(vector<vector<int>>& dungeon) {
-        if (dungeon.empty() || dungeon[0].empty()) {
-            return 1;
-        }
-        
-        int rows = dungeon.size();
-        int cols = dungeon[0].size();
-        
-        // BFS approach: try different starting health values
-        // Binary search on the answer
-        int left = 1, right = 1000000;
-        
-        while (left < right) {
-            int mid = left + (right - left) / 2;
-            
-            if (canReachPrincess(dungeon, mid)) {
-                right = mid;
-            } else {
-                left = mid + 1;
-            }
-        }
-        
-        return left;
+        return search.minimumHealth(dungeon, [&](int health, SearchWorkspace& ws) {
+            return canReachPrincess(dungeon, health, ws);
+        });
+    }
+    
+    int calculateMinimumHPParallel(vector<vector<int>>& dungeon, int lanes = defaultSearchLanes()) {
+        return search.minimumHealthParallel(dungeon, lanes, [&](int health, SearchWorkspace& ws) {
+            return canReachPrincess(dungeon, health, ws);
+        });
     }
     
 private:
-    bool canReachPrincess(vector<vector<int>>& dungeon, int startHealth) {
+    bool canReachPrincess(vector<vector<int>>& dungeon, int startHealth,
+                          SearchWorkspace& ws) {
         int rows = dungeon.size();
         int cols = dungeon[0].size();
         
         // BFS to check if we can reach princess with given starting health
-        queue<State> q;
-        vector<vector<bool>> visited(rows, vector<bool>(cols, false));
+        ws.beginProbe(rows * cols);
         
-        q.push(State(0, 0, startHealth));
-        visited[0][0] = true;
+        ws.pushFrontier(0, startHealth);
         
-        while (!q.empty()) {
-            State current = q.front();
-            q.pop();
+        while (!ws.frontierEmpty()) {
+            PackedState current = ws.popFront();
+            
+            // A healthier copy of this cell was queued after this one
+            if (ws.isDominated(current.cell, current.health)) {
+                continue;
+            }
+            
+            int row = current.cell / cols;
+            int col = current.cell % cols;
             
             // Check current health after entering this cell
-            int currentHealth = current.health + dungeon[current.row][current.col];
+            int currentHealth = current.health + dungeon[row][col];
             
             // Must have positive health
             if (currentHealth <= 0) {
@@ -73,18 +67,22 @@ private:
             }
             
             // Reached princess
-            if (current.row == rows - 1 && current.col == cols - 1) {
+            if (row == rows - 1 && col == cols - 1) {
                 return true;
             }
             
             // Explore neighbors
             for (auto& dir : directions) {
-                int newRow = current.row + dir.first;
-                int newCol = current.col + dir.second;
+                int newRow = row + dir.first;
+                int newCol = col + dir.second;
                 
-                if (newRow < rows && newCol < cols && !visited[newRow][newCol]) {
-                    visited[newRow][newCol] = true;
-                    q.push(State(newRow, newCol, currentHealth));
+                if (newRow < rows && newCol < cols) {
+                    // Re-queue a cell whenever it is reached with more health;
+                    // first-arrival marking would drop a healthier later path
+                    uint32_t next = newRow * cols + newCol;
+                    if (ws.improveBest(next, currentHealth)) {
+                        ws.pushFrontier(next, currentHealth);
+                    }
                 }
             }
         }
@@ -102,7 +100,7 @@ void testBFS() {
     // Test case 1: Basic example
     vector<vector<int>> dungeon1 = {{-3, 5}, {1, -4}};
     int result1 = solver.calculateMinimumHP(dungeon1);
-    cout << "Test 1 - Expected: 7, Got: " << result1 << endl;
+    cout << "Test 1 - Expected: 4, Got: " << result1 << endl;
     
     // Test case 2: Single cell negative
     vector<vector<int>> dungeon2 = {{-5}};
@@ -119,6 +117,13 @@ void testBFS() {
     int result4 = solver.calculateMinimumHP(dungeon4);
     cout << "Test 4 - Expected: 1, Got: " << result4 << endl;
     
+    DungeonGameBFS traversalSolver(FeasibilityBackend::Traversal);
+    cout << "Test 1 (traversal probes) - Expected: 4, Got: " 
+         << traversalSolver.calculateMinimumHP(dungeon1) << endl;
+    
+    int result1_par = solver.calculateMinimumHPParallel(dungeon1, 4);
+    cout << "Test 1 (4 parallel lanes) - Expected: 4, Got: " << result1_par << endl;
+    
     cout << "BFS Implementation completed!" << endl;
 }
 
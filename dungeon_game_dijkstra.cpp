@@ -4,6 +4,11 @@
 #include <climits>
 #include <algorithm>
 
+#include "indexed_heap.h"
+#include "solver_workspace.h"
+#include "forward_sweep.h"
+#include "parallel_health_search.h"
+
 using std::vector;
 using std::priority_queue;
 using std::pair;
@@ -12,23 +17,14 @@ using std::min;
 using std::cout;
 using std::endl;
 
-struct DijkstraState {
-    int row, col, minHealthNeeded;
-    
-    DijkstraState(int r, int c, int h) : row(r), col(c), minHealthNeeded(h) {}
-    
-    // For priority queue (min-heap based on minimum health needed)
-    bool operator>(const DijkstraState& other) const {
-        return minHealthNeeded > other.minHealthNeeded;
-    }
-};
-
 class DungeonGameDijkstra {
 private:
     vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
     
 public:
-    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+    // Scratch memory comes from `workspace` if given (solver_workspace.h),
+    // so repeated solves with a warm workspace do not allocate
+    int calculateMinimumHP(vector<vector<int>>& dungeon, Workspace* workspace = nullptr) {
         if (dungeon.empty() || dungeon[0].empty()) {
             return 1;
         }
@@ -38,46 +34,58 @@ public:
         
         // Dijkstra's algorithm to find minimum health needed
         // We'll work backwards: find minimum health needed to reach princess from each cell
-        vector<vector<int>> minHealth(rows, vector<int>(cols, INT_MAX));
-        priority_queue<DijkstraState, vector<DijkstraState>, std::greater<DijkstraState>> pq;
+        // Cells are addressed by flat index (row * cols + col) and queued at
+        // most once; a better label lowers the queued key in place
+        int cells = rows * cols;
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        scratch.reserve(4 * Workspace::bytesFor<int>(cells));
+        int* minHealth = scratch.allocate<int>(cells, INT_MAX);
+        IndexedDaryHeap<int> pq(cells, scratch);
         
         // Start from princess room - minimum health needed there
+        int princess = (rows - 1) * cols + (cols - 1);
         int princessHealth = max(1, 1 - dungeon[rows-1][cols-1]);
-        minHealth[rows-1][cols-1] = princessHealth;
-        pq.push(DijkstraState(rows-1, cols-1, princessHealth));
+        minHealth[princess] = princessHealth;
+        pq.push(princess, princessHealth);
         
         // Reverse directions (left, up) since we're working backwards
-        vector<pair<int, int>> reverseDirections = {{0, -1}, {-1, 0}};
+        const pair<int, int> reverseDirections[] = {{0, -1}, {-1, 0}};
         
         while (!pq.empty()) {
-            DijkstraState current = pq.top();
-            pq.pop();
+            int current = pq.pop();
             
-            // Skip if we've already found a better path to this cell
-            if (current.minHealthNeeded > minHealth[current.row][current.col]) {
-                continue;
-            }
+            int row = current / cols;
+            int col = current % cols;
             
             // Explore neighbors (cells that can reach current cell)
             for (auto& dir : reverseDirections) {
-                int newRow = current.row + dir.first;
-                int newCol = current.col + dir.second;
+                int newRow = row + dir.first;
+                int newCol = col + dir.second;
                 
                 // Check bounds
-                if (newRow >= 0 && newRow < rows && newCol >= 0 && newCol < cols) {
-                    // Calculate minimum health needed at (newRow, newCol) to reach princess
-                    int healthNeeded = max(1, current.minHealthNeeded - dungeon[newRow][newCol]);
+                if (newRow < 0 || newCol < 0) {
+                    continue;
+                }
+                
+                int next = newRow * cols + newCol;
+                
+                // Calculate minimum health needed at (newRow, newCol) to reach princess
+                int healthNeeded = max(1, minHealth[current] - dungeon[newRow][newCol]);
+                
+                // If we found a better path to this cell
+                if (healthNeeded < minHealth[next]) {
+                    minHealth[next] = healthNeeded;
                     
-                    // If we found a better path to this cell
-                    if (healthNeeded < minHealth[newRow][newCol]) {
-                        minHealth[newRow][newCol] = healthNeeded;
-                        pq.push(DijkstraState(newRow, newCol, healthNeeded));
-                    }
+                    // max(1, h - d) is not monotone in the path, so a cell already
+                    // popped can still get a better label; it is then queued again
+                    pq.pushOrDecrease(next, healthNeeded);
                 }
             }
         }
         
-        return minHealth[0][0];
+        return minHealth[0];
     }
 };
 
@@ -97,26 +105,22 @@ private:
         }
     };
     
+    ForwardHealthSearch<NoLaneScratch> search;
+    
 public:
+    explicit DungeonGameDijkstraForward(FeasibilityBackend backend = FeasibilityBackend::Sweep)
+        : search(backend) {}
+    
     int calculateMinimumHP(vector<vector<int>>& dungeon) {
-        if (dungeon.empty() || dungeon[0].empty()) {
-            return 1;
-        }
-        
-        // Binary search on the starting health
-        int left = 1, right = 1000000;
-        
-        while (left < right) {
-            int mid = left + (right - left) / 2;
-            
-            if (canReachWithStartingHealth(dungeon, mid)) {
-                right = mid;
-            } else {
-                left = mid + 1;
-            }
-        }
-        
-        return left;
+        return search.minimumHealth(dungeon, [&](int health, NoLaneScratch&) {
+            return canReachWithStartingHealth(dungeon, health);
+        });
+    }
+    
+    int calculateMinimumHPParallel(vector<vector<int>>& dungeon, int lanes = defaultSearchLanes()) {
+        return search.minimumHealthParallel(dungeon, lanes, [&](int health, NoLaneScratch&) {
+            return canReachWithStartingHealth(dungeon, health);
+        });
     }
     
 private:
@@ -180,7 +184,7 @@ void testDijkstra() {
     vector<vector<int>> dungeon1 = {{-3, 5}, {1, -4}};
     int result1 = solver.calculateMinimumHP(dungeon1);
     int result1_fwd = forwardSolver.calculateMinimumHP(dungeon1);
-    cout << "Test 1 - Expected: 7, Got (backward): " << result1 
+    cout << "Test 1 - Expected: 4, Got (backward): " << result1 
          << ", Got (forward): " << result1_fwd << endl;
     
     // Test case 2: Single cell negative
@@ -204,6 +208,13 @@ void testDijkstra() {
     cout << "Test 4 - Expected: 1, Got (backward): " << result4 
          << ", Got (forward): " << result4_fwd << endl;
     
+    DungeonGameDijkstraForward traversalSolver(FeasibilityBackend::Traversal);
+    cout << "Test 1 (traversal probes) - Expected: 4, Got: " 
+         << traversalSolver.calculateMinimumHP(dungeon1) << endl;
+    
+    int result1_par = forwardSolver.calculateMinimumHPParallel(dungeon1, 4);
+    cout << "Test 1 (4 parallel lanes) - Expected: 4, Got: " << result1_par << endl;
+    
     cout << "Dijkstra Implementation completed!" << endl;
     
     cout << "\n=== Algorithm Analysis ===" << endl;
@@ -0,0 +1,286 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "dungeon_generator.h"
+#include "dungeon_file.h"
+#include "dungeon_text.h"
+#include "dungeon_kernels.h"
+
+using std::vector;
+using std::string;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/**
+ * Writes benchmark inputs as memory-mapped .dgrid files
+ *
+ *   dungeon_generate --family corridor --size 31623 --out corridor_1g.dgrid
+ *
+ * The file is sized up front and mapped, and the generator threads write
+ * their bands of rows straight into the mapping, so nothing is built in a
+ * vector first and a 1G-cell (4 GB) input is as fast as the page cache.
+ * The same family, shape and seed produce the same bytes on any machine
+ * with any thread count; --verify regenerates random tiles on their own
+ * and compares them with the file.
+ *
+ * --text writes one line of space-separated values per row instead, the
+ * input dungeon_load parses.
+ *
+ * --solve reads the file back (through the mapping, or the text loader),
+ * solves it with the streaming kernel and, beside it, with the same
+ * recurrence in 64-bit arithmetic, so the extreme family's int32 overflow
+ * shows up as two different answers.
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+struct GenerateConfig {
+    DungeonFamily family = DungeonFamily::Uniform;
+    int rows = 1000;
+    int cols = 1000;
+    uint64_t seed = 1;
+    bool lowGiven = false;   // either bound alone keeps the family's other one
+    bool highGiven = false;
+    int low = 0;
+    int high = 0;
+    int threads = 0;
+    string outPath;
+    bool text = false;
+    int verifyTiles = 0;
+    bool solve = false;
+};
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Regenerates `tiles` tiles at pseudo-random places, one at a time, and
+// counts the cells that differ from the rows read back
+template<typename RowSource>
+size_t verifyTiles(const DungeonGenerator& generator, int rows, int cols, RowSource rowSource, int tiles) {
+    const int side = 64;
+    vector<int> tile(side * side);
+    size_t mismatches = 0;
+    for (int t = 0; t < tiles; t++) {
+        uint64_t draw = counterRandom(0x7469766572696679ull, t);
+        int rowBegin = static_cast<int>((draw >> 32) % static_cast<uint64_t>(rows));
+        int colBegin = static_cast<int>((draw & 0xffffffffu) % static_cast<uint64_t>(cols));
+        int rowEnd = std::min(rows, rowBegin + side);
+        int colEnd = std::min(cols, colBegin + side);
+        generator.fillTile(rowBegin, rowEnd, colBegin, colEnd, &tile[0], side);
+        for (int i = rowBegin; i < rowEnd; i++) {
+            const int* row = rowSource(i);
+            for (int j = colBegin; j < colEnd; j++) {
+                if (tile[(i - rowBegin) * side + (j - colBegin)] != row[j]) {
+                    mismatches++;
+                }
+            }
+        }
+    }
+    return mismatches;
+}
+
+// The recurrence in 64 bits: the reference for int32 overflow
+template<typename RowSource>
+long long solveWide(int rows, int cols, RowSource rowSource) {
+    vector<long long> dp(cols + 1, LLONG_MAX);
+    dp[cols - 1] = 1;
+    for (int i = rows - 1; i >= 0; i--) {
+        const int* row = rowSource(i);
+        for (int j = cols - 1; j >= 0; j--) {
+            dp[j] = std::max(1LL, std::min(dp[j], dp[j + 1]) - row[j]);
+        }
+    }
+    return dp[0];
+}
+
+// Text output: the threads format their share of a batch of rows, then the
+// batch is written in order
+static bool writeText(const DungeonGenerator& generator, const string& path, int threads, size_t& bytes) {
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) {
+        return false;
+    }
+    const GeneratorSpec& spec = generator.generatorSpec();
+    threads = textThreads(threads);
+    const int rowsPerThread = 64;
+    vector<string> text(threads);
+    bytes = 0;
+    bool written = true;
+    for (int batch = 0; batch < spec.rows && written; batch += threads * rowsPerThread) {
+        auto format = [&](int t) {
+            vector<int> row(spec.cols);
+            text[t].clear();
+            int begin = std::min(spec.rows, batch + t * rowsPerThread);
+            int end = std::min(spec.rows, begin + rowsPerThread);
+            for (int i = begin; i < end; i++) {
+                generator.fillTile(i, i + 1, 0, spec.cols, &row[0], spec.cols);
+                appendDungeonTextRow(text[t], &row[0], spec.cols);
+            }
+        };
+        vector<std::thread> workers;
+        for (int t = 1; t < threads; t++) {
+            workers.push_back(std::thread(format, t));
+        }
+        format(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const string& part : text) {
+            written = written && std::fwrite(part.data(), 1, part.size(), out) == part.size();
+            bytes += part.size();
+        }
+    }
+    return std::fclose(out) == 0 && written;
+}
+
+static void printUsage() {
+    cout << "Usage: dungeon_generate --out PATH [options]\n"
+         << "  --family NAME        uniform, corridor, stale, decoy or extreme (default uniform)\n"
+         << "  --rows N, --cols N   grid shape (default 1000 x 1000)\n"
+         << "  --size N             N x N\n"
+         << "  --seed S             generator seed (default 1)\n"
+         << "  --low L, --high H    value range (default: the family's own)\n"
+         << "  --threads N          generator threads (default: hardware threads)\n"
+         << "  --out PATH           .dgrid file to write\n"
+         << "  --text               write space-separated text instead of .dgrid\n"
+         << "  --verify N           regenerate N random 64x64 tiles and compare with the file\n"
+         << "  --solve              solve the written file, in int32 and in 64 bits\n";
+}
+
+int main(int argc, char** argv) {
+    GenerateConfig config;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--family" && hasValue) {
+            if (!parseDungeonFamily(argv[++i], config.family)) {
+                cerr << "Unknown family " << argv[i] << endl;
+                return 1;
+            }
+        } else if (arg == "--rows" && hasValue) {
+            config.rows = std::atoi(argv[++i]);
+        } else if (arg == "--cols" && hasValue) {
+            config.cols = std::atoi(argv[++i]);
+        } else if (arg == "--size" && hasValue) {
+            config.rows = config.cols = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--low" && hasValue) {
+            config.low = std::atoi(argv[++i]);
+            config.lowGiven = true;
+        } else if (arg == "--high" && hasValue) {
+            config.high = std::atoi(argv[++i]);
+            config.highGiven = true;
+        } else if (arg == "--threads" && hasValue) {
+            config.threads = std::atoi(argv[++i]);
+        } else if (arg == "--out" && hasValue) {
+            config.outPath = argv[++i];
+        } else if (arg == "--verify" && hasValue) {
+            config.verifyTiles = std::atoi(argv[++i]);
+        } else if (arg == "--text") {
+            config.text = true;
+        } else if (arg == "--solve") {
+            config.solve = true;
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (config.outPath.empty() || config.rows <= 0 || config.cols <= 0) {
+        printUsage();
+        return 1;
+    }
+
+    GeneratorSpec spec = GeneratorSpec::make(config.family, config.rows, config.cols, config.seed);
+    if (config.lowGiven) spec.low = config.low;
+    if (config.highGiven) spec.high = config.high;
+    if (spec.low > spec.high) {
+        cerr << "--low is above --high" << endl;
+        return 1;
+    }
+    DungeonGenerator generator(spec);
+
+    double cells = static_cast<double>(spec.rows) * spec.cols;
+    double bytes = cells * sizeof(int32_t);
+    Clock::time_point start = Clock::now();
+    if (config.text) {
+        size_t textBytes = 0;
+        if (!writeText(generator, config.outPath, config.threads, textBytes)) {
+            cerr << "Cannot write " << config.outPath << endl;
+            return 1;
+        }
+        bytes = static_cast<double>(textBytes);
+    } else {
+        DungeonFileHeader header = makeDungeonFileHeader(spec.rows, spec.cols);
+        header.family = static_cast<uint32_t>(spec.family);
+        header.low = spec.low;
+        header.high = spec.high;
+        header.seed = spec.seed;
+
+        MappedDungeonFile file;
+        if (!file.create(config.outPath, header)) {
+            cerr << "Cannot create " << file.error() << endl;
+            return 1;
+        }
+        generator.generateInto(file.data(), config.threads);
+    }
+    double seconds = secondsSince(start);
+    cout << "Wrote " << spec.rows << " x " << spec.cols << " " << dungeonFamilyName(spec.family)
+         << " (seed " << spec.seed << ", values " << spec.low << ".." << spec.high << ") to "
+         << config.outPath << endl;
+    cout << std::fixed << std::setprecision(3) << "  " << seconds << " s, "
+         << std::setprecision(1) << cells / seconds / 1e6 << " Mcells/s, "
+         << std::setprecision(2) << bytes / seconds / 1e9 << " GB/s" << endl;
+    cout.unsetf(std::ios::fixed);
+
+    if (config.verifyTiles <= 0 && !config.solve) {
+        return 0;
+    }
+
+    // Everything below reads the file back as a consumer would
+    MappedDungeonFile file;
+    DungeonGrid parsed;
+    string error;
+    if (config.text ? !loadDungeonText(config.outPath, parsed, &error, config.threads)
+                    : !file.open(config.outPath)) {
+        cerr << "Cannot read back " << (config.text ? error : file.error()) << endl;
+        return 1;
+    }
+    int rows = config.text ? parsed.rows : file.rows();
+    int cols = config.text ? parsed.cols : file.cols();
+    auto rowSource = [&](int i) { return config.text ? parsed.row(i) : file.row(i); };
+
+    int status = 0;
+    if (config.verifyTiles > 0) {
+        size_t mismatches = verifyTiles(generator, rows, cols, rowSource, config.verifyTiles);
+        cout << "Verify: " << config.verifyTiles << " tiles regenerated, " << mismatches
+             << " cells differ" << endl;
+        if (mismatches > 0) {
+            status = 1;
+        }
+    }
+
+    if (config.solve) {
+        start = Clock::now();
+        int answer = DungeonKernels::streaming(rows, cols, rowSource);
+        seconds = secondsSince(start);
+        long long wide = solveWide(rows, cols, rowSource);
+        cout << "Minimum HP: " << answer << " (streaming, " << std::fixed << std::setprecision(3)
+             << seconds << " s)";
+        cout.unsetf(std::ios::fixed);
+        if (wide != answer) {
+            cout << "; 64-bit recurrence gives " << wide << ", int32 overflowed";
+        }
+        cout << endl;
+    }
+    return status;
+}
@@ -0,0 +1,289 @@
+#ifndef DUNGEON_GAME_DUNGEON_GENERATOR_H
+#define DUNGEON_GAME_DUNGEON_GENERATOR_H
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <climits>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#include "dungeon_grid.h"
+
+// Input distributions; every family but Uniform targets one solver's
+// weak spot
+enum class DungeonFamily : uint32_t {
+    Uniform,   // independent values in [low, high]
+    Corridor,  // diagonal corridors of damage between walls; large answers
+    Stale,     // walled-in potions; Dijkstra keeps reopening settled cells
+    Decoy,     // a cheap pocket next to the princess that is walled off
+               // from the knight; A* floods it before the real route
+    Extreme,   // damage and potions near 2^31; sums overflow int32
+    Count
+};
+
+inline const char* dungeonFamilyName(DungeonFamily family) {
+    switch (family) {
+        case DungeonFamily::Uniform:  return "uniform";
+        case DungeonFamily::Corridor: return "corridor";
+        case DungeonFamily::Stale:    return "stale";
+        case DungeonFamily::Decoy:    return "decoy";
+        case DungeonFamily::Extreme:  return "extreme";
+        default:                      return "unknown";
+    }
+}
+
+inline bool parseDungeonFamily(const std::string& name, DungeonFamily& family) {
+    for (uint32_t f = 0; f < static_cast<uint32_t>(DungeonFamily::Count); f++) {
+        if (name == dungeonFamilyName(static_cast<DungeonFamily>(f))) {
+            family = static_cast<DungeonFamily>(f);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Output number `counter` of the SplitMix64 stream seeded with `key`,
+// computed directly instead of by stepping through the ones before it
+inline uint64_t counterRandom(uint64_t key, uint64_t counter) {
+    uint64_t z = key + (counter + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Maps a random word to [low, high] with a multiply instead of a modulo;
+// the bias is at most span / 2^32, far below anything a benchmark sees
+inline int uniformValue(uint64_t random, int low, int high) {
+    uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(high) - low + 1);
+    return static_cast<int>(low + static_cast<int64_t>(((random >> 32) * span) >> 32));
+}
+
+struct GeneratorSpec {
+    DungeonFamily family = DungeonFamily::Uniform;
+    int rows = 0;
+    int cols = 0;
+    uint64_t seed = 1;
+    int low = -10;   // value range; its meaning per family is in defaultRange
+    int high = 10;
+
+    // The range each family is meant to be run with
+    static void defaultRange(DungeonFamily family, int& low, int& high) {
+        switch (family) {
+            case DungeonFamily::Corridor: low = -1000; high = -1; break;
+            case DungeonFamily::Extreme:  low = -(3 << 29); high = INT_MAX; break;
+            default:                      low = -10; high = 10; break;
+        }
+    }
+
+    static GeneratorSpec make(DungeonFamily family, int rows, int cols, uint64_t seed) {
+        GeneratorSpec spec;
+        spec.family = family;
+        spec.rows = rows;
+        spec.cols = cols;
+        spec.seed = seed;
+        defaultRange(family, spec.low, spec.high);
+        return spec;
+    }
+};
+
+/**
+ * Deterministic, parallel dungeon generator
+ *
+ * Cell (i, j) is a pure function of (family, seed, i, j): the random word
+ * for it is counterRandom(key, i * cols + j), so any tile can be produced
+ * on its own, by any thread, in any order, and the same spec gives the
+ * same grid on every platform. generateInto splits the rows across
+ * threads; it is how dungeon_generate fills a memory-mapped file.
+ *
+ * Families, with low / high as set by GeneratorSpec::defaultRange:
+ *
+ *   uniform   every cell in [low, high] (default -10..10, what
+ *             generateRandomDungeon produced)
+ *   corridor  bands parallel to the knight-princess diagonal, separated by
+ *             walls no move can step over. Corridor cells are damage in
+ *             [low, min(high, -1)] (default -1000..-1), so the answer is
+ *             about |mean| * (rows + cols): from 1000 x 1000 up it is above
+ *             the 10^6 bound of the binary-search solvers, and every probe
+ *             runs a long way down the corridors before it dies
+ *   stale     damage in [low, -1]; one cell in 32 is a potion that resets
+ *             the need to 1, guarded by walls on its right and below. The
+ *             backward search reaches each potion only after it has
+ *             settled the region above and left of it through the cheaper
+ *             cells, and the potion then lowers all of those labels again;
+ *             the nearer the potion, the later and the lower. Dijkstra
+ *             pops each cell about side / 7 times (140 at 1000 x 1000)
+ *   decoy     the half of the grid above the diagonal is potions in
+ *             [1, high], the half below is damage in [low, -1]. Near the
+ *             knight the potion half is walled off, from him and from the
+ *             damage half, so the cheap region the search (and A*'s
+ *             distance-to-knight heuristic) favours is a dead end
+ *   extreme   anti-diagonals of potions in [high / 2, high], then two of
+ *             damage in [low, low / 2] (default low -1.5 * 2^30, high
+ *             INT_MAX). Health after a potion, and the need after two
+ *             hits, are past INT_MAX, and two hits outweigh a potion, so
+ *             beyond a few dozen cells the answer itself needs 64 bits; a
+ *             kernel that wraps returns a small, plausible wrong answer
+ *
+ * Walls are damage larger than any path of ordinary cells costs, so the
+ * answer never crosses one when another route exists.
+ */
+class DungeonGenerator {
+private:
+    GeneratorSpec spec;
+    uint64_t key;
+    int64_t wall;        // wall damage (positive)
+    int64_t potion;      // stale potion value, worth a wall and a path
+    int64_t bandWidth;   // corridor: key-space width of one wall + corridor
+    int64_t reach;       // largest key change of one move
+    int64_t decoyGate;   // decoy: cells with i + j below this are walled off
+    int damageLow;       // damage range of corridor / stale / decoy
+    int damageHigh;
+
+    // Position across the knight-princess diagonal: 0 for both of them,
+    // + (cols - 1) for a move down, - (rows - 1) for a move right
+    int64_t diagonalKey(int i, int j) const {
+        return static_cast<int64_t>(i) * (spec.cols - 1) - static_cast<int64_t>(j) * (spec.rows - 1);
+    }
+
+    bool isPotion(int i, int j) const {
+        return (randomAt(i, j) & (kPotionEvery - 1)) == 0 && (i | j) != 0;
+    }
+
+    static int64_t floorMod(int64_t a, int64_t b) {
+        int64_t m = a % b;
+        return m < 0 ? m + b : m;
+    }
+
+public:
+    // Corridors across the grid, counting the main one
+    static const int kCorridors = 8;
+    static const int kPotionEvery = 32;
+
+    explicit DungeonGenerator(const GeneratorSpec& generatorSpec) : spec(generatorSpec) {
+        key = counterRandom(spec.seed, static_cast<uint64_t>(spec.family));
+        reach = std::max<int64_t>(1, std::max(spec.rows, spec.cols) - 1);
+        damageHigh = std::min(spec.high, -1);
+        damageLow = std::min(spec.low, damageHigh);
+
+        // A path has rows + cols - 1 cells; no route of ordinary cells
+        // costs more than that many of the worst damage
+        int64_t pathLength = static_cast<int64_t>(spec.rows) + spec.cols - 1;
+        int64_t worstPath = pathLength * -static_cast<int64_t>(damageLow);
+        // Capped so the few walls a dead-end cell is forced through stay in int32
+        wall = std::min<int64_t>(worstPath + 1, (INT_MAX / 4) / kCorridors);
+        potion = std::min<int64_t>(wall + worstPath + 1, INT_MAX / 4);
+
+        // The diagonal keys span (rows-1)(cols-1) either way; split that
+        // into kCorridors bands, each at least wide enough for a path to
+        // stay inside by alternating moves
+        int64_t keySpan = 2 * static_cast<int64_t>(std::max(spec.rows - 1, 1)) * std::max(spec.cols - 1, 1);
+        bandWidth = std::max(keySpan / kCorridors, 4 * reach);
+        decoyGate = (static_cast<int64_t>(spec.rows) + spec.cols) / 4;
+    }
+
+    const GeneratorSpec& generatorSpec() const { return spec; }
+
+    uint64_t randomAt(int i, int j) const {
+        return counterRandom(key, static_cast<uint64_t>(i) * spec.cols + j);
+    }
+
+    int cell(int i, int j) const {
+        uint64_t random = randomAt(i, j);
+        switch (spec.family) {
+            case DungeonFamily::Corridor: {
+                // Wall where the key is within one move's reach of a band
+                // edge; the main corridor is centred on key 0
+                int64_t offset = floorMod(diagonalKey(i, j) + bandWidth / 2, bandWidth);
+                if (offset < reach) {
+                    return static_cast<int>(-wall);
+                }
+                return uniformValue(random, damageLow, damageHigh);
+            }
+            case DungeonFamily::Stale:
+                if (isPotion(i, j)) {
+                    return static_cast<int>(potion);
+                }
+                if ((j > 0 && isPotion(i, j - 1)) || (i > 0 && isPotion(i - 1, j))) {
+                    return static_cast<int>(-wall);
+                }
+                return uniformValue(random, damageLow, damageHigh);
+            case DungeonFamily::Decoy: {
+                int64_t k = diagonalKey(i, j);
+                if (k >= 0) {
+                    return uniformValue(random, damageLow, damageHigh);
+                }
+                // The pocket: its start and its edge along the diagonal
+                // are walls in the half of the grid nearer the knight
+                bool nearKnight = static_cast<int64_t>(i) + j < 2 * decoyGate;
+                if (static_cast<int64_t>(i) + j < decoyGate || (nearKnight && k >= -reach)) {
+                    return static_cast<int>(-wall);
+                }
+                return uniformValue(random, 1, std::max(spec.high, 1));
+            }
+            case DungeonFamily::Extreme:
+                // A potion anti-diagonal (the knight's), then two of heavy
+                // damage: every path takes two hits in a row
+                if ((i + j) % 3 == 0) {
+                    return uniformValue(random, spec.high > 0 ? spec.high / 2 : spec.high, spec.high);
+                }
+                return uniformValue(random, spec.low, spec.low < 0 ? spec.low / 2 : spec.low);
+            default:
+                return uniformValue(random, spec.low, spec.high);
+        }
+    }
+
+    // Writes cells [colBegin, colEnd) of rows [rowBegin, rowEnd) to out,
+    // whose rows are `stride` ints apart
+    void fillTile(int rowBegin, int rowEnd, int colBegin, int colEnd, int* out, size_t stride) const {
+        for (int i = rowBegin; i < rowEnd; i++) {
+            int* row = out + static_cast<size_t>(i - rowBegin) * stride;
+            if (spec.family == DungeonFamily::Uniform) {
+                // The common case without the per-cell switch
+                uint64_t base = static_cast<uint64_t>(i) * spec.cols;
+                for (int j = colBegin; j < colEnd; j++) {
+                    row[j - colBegin] = uniformValue(counterRandom(key, base + j), spec.low, spec.high);
+                }
+            } else {
+                for (int j = colBegin; j < colEnd; j++) {
+                    row[j - colBegin] = cell(i, j);
+                }
+            }
+        }
+    }
+
+    // Fills rows * cols row-major cells with `threads` threads (0: one per
+    // hardware thread), each taking a contiguous band of rows
+    void generateInto(int* cells, int threads = 0) const {
+        if (threads <= 0) {
+            unsigned int hardware = std::thread::hardware_concurrency();
+            threads = hardware > 0 ? static_cast<int>(hardware) : 1;
+        }
+        threads = std::max(1, std::min(threads, spec.rows));
+
+        auto band = [this, cells, threads](int t) {
+            int begin = static_cast<int>(static_cast<int64_t>(spec.rows) * t / threads);
+            int end = static_cast<int>(static_cast<int64_t>(spec.rows) * (t + 1) / threads);
+            fillTile(begin, end, 0, spec.cols, cells + static_cast<size_t>(begin) * spec.cols, spec.cols);
+        };
+        std::vector<std::thread> workers;
+        for (int t = 1; t < threads; t++) {
+            workers.push_back(std::thread(band, t));
+        }
+        band(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    DungeonGrid generate(int threads = 0) const {
+        DungeonGrid grid(spec.rows, spec.cols);
+        if (!grid.empty()) {
+            generateInto(&grid.cells[0], threads);
+        }
+        return grid;
+    }
+};
+
+#endif // DUNGEON_GAME_DUNGEON_GENERATOR_H
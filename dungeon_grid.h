@@ -0,0 +1,58 @@
+#ifndef DUNGEON_GAME_DUNGEON_GRID_H
+#define DUNGEON_GAME_DUNGEON_GRID_H
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * Flat row-major dungeon storage
+ *
+ * The solver classes take vector<vector<int>>, which costs one heap block
+ * per row and a pointer chase per access. The kernels in dungeon_kernels.h
+ * work on this contiguous layout instead; fromNested/toNested convert
+ * between the two.
+ */
+struct DungeonGrid {
+    int rows = 0;
+    int cols = 0;
+    std::vector<int> cells;
+
+    DungeonGrid() {}
+
+    DungeonGrid(int r, int c, int fill = 0)
+        : rows(r), cols(c), cells(static_cast<size_t>(r) * c, fill) {}
+
+    static DungeonGrid fromNested(const std::vector<std::vector<int>>& dungeon) {
+        DungeonGrid grid;
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return grid;
+        }
+
+        grid.rows = dungeon.size();
+        grid.cols = dungeon[0].size();
+        grid.cells.reserve(grid.size());
+        for (const auto& row : dungeon) {
+            grid.cells.insert(grid.cells.end(), row.begin(), row.end());
+        }
+        return grid;
+    }
+
+    std::vector<std::vector<int>> toNested() const {
+        std::vector<std::vector<int>> dungeon(rows);
+        for (int i = 0; i < rows; i++) {
+            dungeon[i].assign(row(i), row(i) + cols);
+        }
+        return dungeon;
+    }
+
+    bool empty() const { return rows == 0 || cols == 0; }
+    size_t size() const { return static_cast<size_t>(rows) * cols; }
+
+    int* row(int i) { return &cells[static_cast<size_t>(i) * cols]; }
+    const int* row(int i) const { return &cells[static_cast<size_t>(i) * cols]; }
+
+    int& at(int i, int j) { return cells[static_cast<size_t>(i) * cols + j]; }
+    int at(int i, int j) const { return cells[static_cast<size_t>(i) * cols + j]; }
+};
+
+#endif // DUNGEON_GAME_DUNGEON_GRID_H
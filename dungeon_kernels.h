@@ -0,0 +1,485 @@
+#ifndef DUNGEON_GAME_DUNGEON_KERNELS_H
+#define DUNGEON_GAME_DUNGEON_KERNELS_H
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <limits>
+#include <climits>
+#include <cstdint>
+#include <algorithm>
+
+#include "dungeon_grid.h"
+#include "solver_workspace.h"
+#include "span_trace.h"
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Bottom-up minimum-HP kernels over a flat DungeonGrid
+ *
+ * All kernels compute the same recurrence as DungeonGameOptimized:
+ *
+ *     need(i, j) = max(1, min(need(i, j+1), need(i+1, j)) - dungeon[i][j])
+ *
+ * and differ only in evaluation order, parallelism and memory:
+ *
+ *   scalar1D      one O(cols) row buffer, bottom-up, right-to-left
+ *   streaming     scalar1D fed one row at a time (rows bottom to top), for
+ *                 inputs that are not in memory
+ *   wavefront<T>  anti-diagonal order with SIMD lanes of int16 or int32;
+ *                 copies the grid to diagonal-major order first
+ *   tiledParallel tiles swept in anti-diagonal waves across threads;
+ *                 only tile edges are stored
+ *   fullTable     full O(rows × cols) table, the only kernel that can
+ *                 reconstruct the optimal path
+ *   batch         many independent grids across threads
+ *
+ * Every kernel returns 1 for an empty grid, like the solver classes.
+ *
+ * Each kernel optionally takes a Workspace for its scratch memory. Given
+ * one that has seen a grid of the same shape, scalar1D, streaming,
+ * wavefront, fullTable and single-threaded tiledParallel or batch make no
+ * heap allocation at all; with more threads only the std::thread start-up
+ * allocates. Without one, each call sets up and frees a local workspace.
+ */
+class DungeonKernels {
+public:
+    // ---- scalar 1D / streaming ----------------------------------------
+
+    static int scalar1D(const DungeonGrid& grid, Workspace* workspace = nullptr) {
+        if (grid.empty()) {
+            return 1;
+        }
+        return streaming(grid.rows, grid.cols, [&grid](int i) { return grid.row(i); }, workspace);
+    }
+
+    // Variant that reuses the caller's row buffer across calls
+    static int scalar1D(const DungeonGrid& grid, std::vector<int>& dp) {
+        if (grid.empty()) {
+            return 1;
+        }
+        return streaming(grid.rows, grid.cols, [&grid](int i) { return grid.row(i); }, dp);
+    }
+
+    // rowSource(i) returns a pointer to row i; it is called for
+    // i = rows - 1 down to 0, so the rows may be produced on demand
+    template<typename RowSource>
+    static int streaming(int rows, int cols, RowSource rowSource, Workspace* workspace = nullptr) {
+        if (rows == 0 || cols == 0) {
+            return 1;
+        }
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+
+        int* dp = scratch.allocate<int>(cols + 1, INT_MAX);
+        dp[cols - 1] = 1;
+        for (int i = rows - 1; i >= 0; i--) {
+            relaxRow(dp, rowSource(i), cols);
+        }
+        return dp[0];
+    }
+
+    template<typename RowSource>
+    static int streaming(int rows, int cols, RowSource rowSource, std::vector<int>& dp) {
+        if (rows == 0 || cols == 0) {
+            return 1;
+        }
+
+        // dp holds the row below; the virtual row under the grid is INT_MAX
+        // except below the princess, where 1 makes her room max(1, 1 - d)
+        dp.assign(cols + 1, INT_MAX);
+        dp[cols - 1] = 1;
+
+        for (int i = rows - 1; i >= 0; i--) {
+            relaxRow(&dp[0], rowSource(i), cols);
+        }
+        return dp[0];
+    }
+
+    // ---- anti-diagonal wavefront --------------------------------------
+
+    // True if every intermediate value of the recurrence fits in int16:
+    // need(i, j) <= 1 + (path length) * (largest damage)
+    static bool fitsInt16(const DungeonGrid& grid) {
+        if (grid.empty()) {
+            return true;
+        }
+        int lowest = 0, highest = 0;
+        for (int value : grid.cells) {
+            lowest = std::min(lowest, value);
+            highest = std::max(highest, value);
+        }
+        return fitsInt16(grid.rows, grid.cols, lowest, highest);
+    }
+
+    static bool fitsInt16(int rows, int cols, int lowest, int highest) {
+        const long long limit = 30000;
+        long long worstNeed = 1 + static_cast<long long>(rows + cols - 1) * std::max(0, -lowest);
+        return highest <= limit && -static_cast<long long>(lowest) <= limit && worstNeed <= limit;
+    }
+
+    // T is int16_t (caller must check fitsInt16) or int32_t
+    template<typename T>
+    static int wavefront(const DungeonGrid& grid, Workspace* workspace = nullptr) {
+        if (grid.empty()) {
+            return 1;
+        }
+
+        int rows = grid.rows;
+        int cols = grid.cols;
+        int diagonals = rows + cols - 1;
+
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        scratch.reserve(Workspace::bytesFor<size_t>(diagonals + 1) +
+                        Workspace::bytesFor<T>(grid.size()) + 2 * Workspace::bytesFor<T>(rows + 1));
+
+        // Diagonal-major copy: diagonal d holds rows firstRow(d)..lastRow(d)
+        size_t* offset = scratch.allocate<size_t>(diagonals + 1);
+        offset[0] = 0;
+        for (int d = 0; d < diagonals; d++) {
+            offset[d + 1] = offset[d] + (lastRow(d, rows) - firstRow(d, cols) + 1);
+        }
+        T* values = scratch.allocate<T>(grid.size());
+        for (int i = 0; i < rows; i++) {
+            const int* row = grid.row(i);
+            for (int j = 0; j < cols; j++) {
+                int d = i + j;
+                values[offset[d] + (i - firstRow(d, cols))] = static_cast<T>(row[j]);
+            }
+        }
+
+        // next[i] = need on diagonal d + 1 at row i; cur[i] = row i of d.
+        // The right neighbour of row i is next[i], the one below next[i + 1].
+        const T infinity = std::numeric_limits<T>::max();
+        T* next = scratch.allocate<T>(rows + 1, infinity);
+        T* cur = scratch.allocate<T>(rows + 1, infinity);
+        next[rows - 1] = 1;  // virtual right neighbour of the princess
+
+        for (int d = diagonals - 1; d >= 0; d--) {
+            int lo = firstRow(d, cols);
+            int hi = lastRow(d, rows);
+            sweepBackward(next, cur, values + offset[d] - lo, lo, hi);
+            std::swap(next, cur);
+        }
+        return next[0];
+    }
+
+    // ---- tiled, multithreaded -----------------------------------------
+
+    static int tiledParallel(const DungeonGrid& grid, int tileRows, int tileCols, int threads,
+                             Workspace* workspace = nullptr) {
+        if (grid.empty()) {
+            return 1;
+        }
+
+        int rows = grid.rows;
+        int cols = grid.cols;
+        tileRows = std::max(1, std::min(tileRows, rows));
+        tileCols = std::max(1, std::min(tileCols, cols));
+        int bands = (rows + tileRows - 1) / tileRows;
+        int strips = (cols + tileCols - 1) / tileCols;
+
+        int waves = bands + strips - 1;
+        threads = std::max(1, threads);
+
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        size_t bandBytes = Workspace::bytesFor<int>(static_cast<size_t>(bands + 1) * cols);
+        size_t stripBytes = Workspace::bytesFor<int>(static_cast<size_t>(strips + 1) * rows);
+        size_t rowBytes = Workspace::bytesFor<int>(tileCols + 1);
+        scratch.reserve(bandBytes + stripBytes + threads * rowBytes);
+
+        // bandTop[b] = need along the top row of band b (band `bands` is the
+        // virtual row under the grid); stripLeft[s] = need down the left
+        // column of strip s (strip `strips` is the virtual column)
+        int* bandTop = scratch.allocate<int>(static_cast<size_t>(bands + 1) * cols, INT_MAX);
+        int* stripLeft = scratch.allocate<int>(static_cast<size_t>(strips + 1) * rows, INT_MAX);
+        bandTop[static_cast<size_t>(bands) * cols + cols - 1] = 1;
+
+        TileContext context = { &grid, tileRows, tileCols, bandTop, stripLeft };
+
+        if (threads == 1) {
+            int* dp = scratch.allocate<int>(tileCols + 1);
+            for (int wave = 0; wave < waves; wave++) {
+                for (int t = 0; t < tilesInWave(wave, bands, strips); t++) {
+                    solveTile(context, wave, t, bands, strips, dp);
+                }
+            }
+            return bandTop[0];
+        }
+
+        // One row buffer per worker, each on its own cache lines
+        int* rowBuffers = scratch.allocate<int>(threads * rowBytes / sizeof(int));
+        size_t rowStride = rowBytes / sizeof(int);
+
+        // Tiles on one wave are independent; a barrier separates waves
+        WaveBarrier barrier(threads);
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (int worker = 0; worker < threads; worker++) {
+            workers.push_back(std::thread([&, worker]() {
+                int* dp = rowBuffers + worker * rowStride;
+                for (int wave = 0; wave < waves; wave++) {
+                    int count = tilesInWave(wave, bands, strips);
+                    for (int t = worker; t < count; t += threads) {
+                        solveTile(context, wave, t, bands, strips, dp);
+                    }
+                    SpanScope wait(SpanKind::WaveBarrier, cellRange(0, 0, 0, 0), wave);
+                    barrier.wait();
+                }
+            }));
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return bandTop[0];
+    }
+
+    // ---- full table with path -----------------------------------------
+
+    // path, if given, receives the optimal moves as 'R' / 'D' characters
+    static int fullTable(const DungeonGrid& grid, std::string* path, Workspace* workspace = nullptr) {
+        if (grid.empty()) {
+            if (path) path->clear();
+            return 1;
+        }
+
+        int rows = grid.rows;
+        int cols = grid.cols;
+        size_t stride = cols + 1;
+
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+
+        // Padded like DungeonGameIterative: extra row and column of INT_MAX
+        int* need = scratch.allocate<int>((rows + 1) * stride, INT_MAX);
+        need[rows * stride + cols - 1] = 1;
+        for (int i = rows - 1; i >= 0; i--) {
+            int* dp = &need[i * stride];
+            const int* below = dp + stride;
+            const int* row = grid.row(i);
+            for (int j = cols - 1; j >= 0; j--) {
+                dp[j] = std::max(1, std::min(dp[j + 1], below[j]) - row[j]);
+            }
+        }
+
+        if (path) {
+            path->clear();
+            path->reserve(rows + cols - 2);
+            int i = 0, j = 0;
+            while (i != rows - 1 || j != cols - 1) {
+                size_t cell = i * stride + j;
+                if (need[cell + 1] <= need[cell + stride]) {
+                    path->push_back('R');
+                    j++;
+                } else {
+                    path->push_back('D');
+                    i++;
+                }
+            }
+        }
+        return need[0];
+    }
+
+    // ---- batch of independent grids ------------------------------------
+
+    static void batch(const std::vector<DungeonGrid>& grids, std::vector<int>& results, int threads,
+                      Workspace* workspace = nullptr) {
+        results.assign(grids.size(), 1);
+        threads = std::max(1, std::min<int>(threads, grids.size()));
+
+        int widest = 0;
+        size_t cells = 0;
+        for (const auto& grid : grids) {
+            widest = std::max(widest, grid.cols);
+            cells += grid.size();
+        }
+        SpanScope span(SpanKind::Batch, cellRange(0, 0, 0, 0), static_cast<int32_t>(grids.size()),
+                       static_cast<int64_t>(cells));
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        size_t rowStride = Workspace::bytesFor<int>(widest + 1) / sizeof(int);
+        int* rowBuffers = scratch.allocate<int>(threads * rowStride);
+
+        // One row buffer per thread, reused for every grid it takes
+        std::atomic<size_t> nextGrid(0);
+        auto drain = [&](int worker) {
+            int* dp = rowBuffers + worker * rowStride;
+            for (size_t k = nextGrid++; k < grids.size(); k = nextGrid++) {
+                const DungeonGrid& grid = grids[k];
+                SpanScope gridSpan(SpanKind::BatchGrid, cellRange(0, grid.rows, 0, grid.cols),
+                                   static_cast<int32_t>(k));
+                if (!grid.empty()) {
+                    std::fill(dp, dp + grid.cols + 1, INT_MAX);
+                    dp[grid.cols - 1] = 1;
+                    for (int i = grid.rows - 1; i >= 0; i--) {
+                        relaxRow(dp, grid.row(i), grid.cols);
+                    }
+                    results[k] = dp[0];
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (int worker = 1; worker < threads; worker++) {
+            workers.push_back(std::thread(drain, worker));
+        }
+        drain(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // ---- inner loops; public so the roofline probes time these exact loops
+
+    // One row of the 1D DP: dp[0..cols) is the row below on entry and this
+    // row on exit; dp[cols] is the right neighbour of the last column
+    static void relaxRow(int* dp, const int* row, int cols) {
+        for (int j = cols - 1; j >= 0; j--) {
+            dp[j] = std::max(1, std::min(dp[j], dp[j + 1]) - row[j]);
+        }
+    }
+
+    // cur[i] = max(1, min(next[i], next[i + 1]) - values[i]) for i in [lo, hi]
+    static void sweepBackward(const int32_t* next, int32_t* cur, const int32_t* values,
+                              int lo, int hi) {
+        int i = lo;
+#if defined(__AVX2__)
+        const __m256i one = _mm256_set1_epi32(1);
+        for (; i + 8 <= hi + 1; i += 8) {
+            __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(next + i));
+            __m256i down = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(next + i + 1));
+            __m256i cell = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            __m256i need = _mm256_sub_epi32(_mm256_min_epi32(right, down), cell);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(cur + i), _mm256_max_epi32(need, one));
+        }
+#endif
+        for (; i <= hi; i++) {
+            cur[i] = std::max(1, std::min(next[i], next[i + 1]) - values[i]);
+        }
+    }
+
+    static void sweepBackward(const int16_t* next, int16_t* cur, const int16_t* values,
+                              int lo, int hi) {
+        int i = lo;
+#if defined(__AVX2__)
+        const __m256i one = _mm256_set1_epi16(1);
+        for (; i + 16 <= hi + 1; i += 16) {
+            __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(next + i));
+            __m256i down = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(next + i + 1));
+            __m256i cell = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            __m256i need = _mm256_subs_epi16(_mm256_min_epi16(right, down), cell);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(cur + i), _mm256_max_epi16(need, one));
+        }
+#elif defined(__SSE2__)
+        const __m128i one = _mm_set1_epi16(1);
+        for (; i + 8 <= hi + 1; i += 8) {
+            __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i*>(next + i));
+            __m128i down = _mm_loadu_si128(reinterpret_cast<const __m128i*>(next + i + 1));
+            __m128i cell = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+            __m128i need = _mm_subs_epi16(_mm_min_epi16(right, down), cell);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cur + i), _mm_max_epi16(need, one));
+        }
+#endif
+        for (; i <= hi; i++) {
+            int need = std::min(next[i], next[i + 1]) - values[i];
+            cur[i] = static_cast<int16_t>(std::max(1, need));
+        }
+    }
+
+private:
+    struct TileContext {
+        const DungeonGrid* grid;
+        int tileRows;
+        int tileCols;
+        int* bandTop;
+        int* stripLeft;
+    };
+
+    // Reusable barrier (C++11 has no std::barrier)
+    class WaveBarrier {
+    private:
+        std::mutex lock;
+        std::condition_variable released;
+        int parties;
+        int waiting = 0;
+        unsigned long generation = 0;
+
+    public:
+        explicit WaveBarrier(int count) : parties(count) {}
+
+        void wait() {
+            std::unique_lock<std::mutex> guard(lock);
+            unsigned long arrived = generation;
+            if (++waiting == parties) {
+                waiting = 0;
+                generation++;
+                released.notify_all();
+                return;
+            }
+            released.wait(guard, [&]() { return generation != arrived; });
+        }
+    };
+
+    static int firstRow(int d, int cols) {
+        return std::max(0, d - cols + 1);
+    }
+
+    static int lastRow(int d, int rows) {
+        return std::min(d, rows - 1);
+    }
+
+    // Wave w counts tiles from the bottom-right corner: band + strip offsets
+    // from the last tile sum to w
+    static int tilesInWave(int wave, int bands, int strips) {
+        int first = std::max(0, wave - (strips - 1));
+        int last = std::min(wave, bands - 1);
+        return last - first + 1;
+    }
+
+    static void solveTile(const TileContext& context, int wave, int index,
+                          int bands, int strips, int* dp) {
+        const DungeonGrid& grid = *context.grid;
+        int fromBottom = std::max(0, wave - (strips - 1)) + index;
+        int band = bands - 1 - fromBottom;
+        int strip = strips - 1 - (wave - fromBottom);
+
+        int r0 = band * context.tileRows;
+        int r1 = std::min(grid.rows, r0 + context.tileRows);
+        int c0 = strip * context.tileCols;
+        int c1 = std::min(grid.cols, c0 + context.tileCols);
+        int width = c1 - c0;
+        SpanScope span(SpanKind::Tile, cellRange(r0, r1, c0, c1), band, strip);
+
+        int* bandTop = context.bandTop;
+        int* stripLeft = context.stripLeft;
+        size_t below = static_cast<size_t>(band + 1) * grid.cols + c0;
+        size_t right = static_cast<size_t>(strip + 1) * grid.rows;
+        size_t left = static_cast<size_t>(strip) * grid.rows;
+
+        std::copy(bandTop + below, bandTop + below + width, dp);
+
+        for (int i = r1 - 1; i >= r0; i--) {
+            dp[width] = stripLeft[right + i];
+            relaxRow(dp, grid.row(i) + c0, width);
+            stripLeft[left + i] = dp[0];
+        }
+
+        std::copy(dp, dp + width, bandTop + static_cast<size_t>(band) * grid.cols + c0);
+    }
+};
+
+#endif // DUNGEON_GAME_DUNGEON_KERNELS_H
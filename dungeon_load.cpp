@@ -0,0 +1,266 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+
+#include "dungeon_text.h"
+#include "dungeon_text_index.h"
+#include "dungeon_kernels.h"
+#include "kernel_timing.h"
+
+using std::vector;
+using std::string;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/**
+ * Text dungeon loader and its throughput benchmark
+ *
+ *   dungeon_load dump.txt --threads 8 --repeat 5 --solve
+ *
+ * Maps the file and times the two passes of dungeon_text.h, scan and
+ * parse, best of --repeat runs, in GB/s of text. The first run also pulls
+ * the file into the page cache, so the figures are for parsing, not the
+ * disk. --scaling measures 1, 2, 4 ... threads up to --threads. --solve
+ * times scalar1D on the parsed grid, for the ratio of load to solve time.
+ *
+ * --out PATH writes the parsed grid as .dgrid straight from the text, and
+ * --check PATH compares the parse with an existing .dgrid (exit status 1
+ * when they differ).
+ *
+ *   dungeon_load huge.txt --stream --stride 64 --block-kb 8192
+ *
+ * --stream never holds the grid: it solves bottom up through the row index
+ * of dungeon_text_index.h (FILE.drows, built first if missing or stale),
+ * reading and parsing one block of rows at a time, and reports the blocks'
+ * memory beside the solve time. --check then compares the answer with the
+ * .dgrid's. --index only (re)builds the row index.
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+struct LoadConfig {
+    string textPath;
+    int threads = 0;
+    int repeat = 3;
+    bool scaling = false;
+    bool solve = false;
+    string outPath;
+    string checkPath;
+    bool index = false;
+    bool stream = false;
+    int stride = 64;
+    size_t blockBytes = 8 << 20;
+};
+
+struct LoadTiming {
+    double scanNs = 0;
+    double parseNs = 0;
+};
+
+// Best scan and parse times over `repeat` runs into grid
+static LoadTiming timeLoad(const FileMapping& text, int threads, int repeat, DungeonGrid& grid, string& error) {
+    LoadTiming timing;
+    TextGridLayout layout;
+    timing.scanNs = bestTimeNs([&]() {
+        layout = scanDungeonText(text.data(), text.size(), threads);
+    }, 0, repeat);
+    grid = DungeonGrid(layout.rows, layout.cols);
+    bool parsed = true;
+    timing.parseNs = bestTimeNs([&]() {
+        parsed = grid.empty() ? layout.error.empty()
+                              : parseDungeonText(text.data(), layout, &grid.cells[0], &error, threads);
+    }, 0, repeat);
+    if (!parsed && error.empty()) {
+        error = layout.error;
+    }
+    return parsed ? timing : LoadTiming();
+}
+
+static void printTimingRow(int threads, const LoadTiming& timing, size_t bytes) {
+    double total = timing.scanNs + timing.parseNs;
+    cout << std::right << std::setw(8) << threads << std::fixed << std::setprecision(2)
+         << std::setw(12) << timing.scanNs / 1e6 << std::setw(12) << timing.parseNs / 1e6
+         << std::setw(12) << total / 1e6 << std::setw(10) << bytes / total << endl;
+    cout.unsetf(std::ios::fixed);
+}
+
+// --index and --stream: the text is never loaded whole
+static int streamText(const LoadConfig& config) {
+    TextRowIndex index;
+    string error;
+    bool built = false;
+    Clock::time_point start = Clock::now();
+    bool indexed = config.index ? buildTextRowIndex(config.textPath, config.stride, index, &error, config.threads) &&
+                                      writeTextRowIndex(textRowIndexPath(config.textPath), index, &error)
+                                : openTextRowIndex(config.textPath, config.stride, index, built, &error, config.threads);
+    if (!indexed) {
+        cerr << "Cannot index " << error << endl;
+        return 1;
+    }
+    double indexMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    cout << "Row index: " << index.rows << " x " << index.cols << ", every " << index.stride << " rows, "
+         << sizeof(TextRowIndexHeader) + index.offsets.size() * sizeof(uint64_t) << " bytes";
+    if (config.index || built) {
+        cout << ", built in " << std::fixed << std::setprecision(1) << indexMs << " ms";
+        cout.unsetf(std::ios::fixed);
+    }
+    cout << endl;
+    if (!config.stream) {
+        return 0;
+    }
+
+    ReverseTextRowReader reader;
+    if (!reader.open(config.textPath, index, config.blockBytes)) {
+        cerr << "Cannot open " << reader.error() << endl;
+        return 1;
+    }
+    start = Clock::now();
+    int answer = DungeonKernels::streaming(reader.rows(), reader.cols(), [&reader](int i) { return reader.row(i); });
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    if (reader.failed()) {
+        cerr << config.textPath << ": " << reader.error() << endl;
+        return 1;
+    }
+    cout << "Minimum HP: " << answer << " (streamed bottom up in " << std::fixed << std::setprecision(2)
+         << seconds * 1e3 << " ms, " << reader.bytesRead() / seconds / 1e9 << " GB/s of text, "
+         << reader.bufferBytes() / 1024 << " KB of blocks)" << endl;
+    cout.unsetf(std::ios::fixed);
+
+    if (!config.checkPath.empty()) {
+        MappedDungeonFile reference;
+        if (!reference.open(config.checkPath)) {
+            cerr << "Cannot open " << reference.error() << endl;
+            return 1;
+        }
+        int expected = DungeonKernels::streaming(reference.rows(), reference.cols(),
+                                                 [&reference](int i) { return reference.row(i); });
+        bool same = reference.rows() == reader.rows() && reference.cols() == reader.cols() && expected == answer;
+        cout << "Check against " << config.checkPath << ": " << (same ? "same answer" : "DIFFERENT") << endl;
+        return same ? 0 : 1;
+    }
+    return 0;
+}
+
+static void printUsage() {
+    cout << "Usage: dungeon_load FILE [options]\n"
+         << "  --threads N     loader threads (default: hardware threads)\n"
+         << "  --repeat N      timed runs, best reported (default 3)\n"
+         << "  --scaling       also time 1, 2, 4 ... threads\n"
+         << "  --solve         time scalar1D on the parsed grid\n"
+         << "  --out PATH      convert to a .dgrid file\n"
+         << "  --check PATH    compare the parse with a .dgrid file\n"
+         << "  --index         build the row index FILE.drows\n"
+         << "  --stride K      index every K-th row (default 64)\n"
+         << "  --stream        solve bottom up through the row index, one block in memory\n"
+         << "  --block-kb N    text per streamed block (default 8192)\n";
+}
+
+int main(int argc, char** argv) {
+    LoadConfig config;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--threads" && hasValue) {
+            config.threads = std::atoi(argv[++i]);
+        } else if (arg == "--repeat" && hasValue) {
+            config.repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--scaling") {
+            config.scaling = true;
+        } else if (arg == "--solve") {
+            config.solve = true;
+        } else if (arg == "--out" && hasValue) {
+            config.outPath = argv[++i];
+        } else if (arg == "--check" && hasValue) {
+            config.checkPath = argv[++i];
+        } else if (arg == "--index") {
+            config.index = true;
+        } else if (arg == "--stride" && hasValue) {
+            config.stride = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--stream") {
+            config.stream = true;
+        } else if (arg == "--block-kb" && hasValue) {
+            config.blockBytes = static_cast<size_t>(std::max(1, std::atoi(argv[++i]))) << 10;
+        } else if (config.textPath.empty() && !arg.empty() && arg[0] != '-') {
+            config.textPath = arg;
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (config.textPath.empty()) {
+        printUsage();
+        return 1;
+    }
+    config.threads = textThreads(config.threads);
+    if (config.index || config.stream) {
+        return streamText(config);
+    }
+
+    FileMapping text;
+    if (!text.openRead(config.textPath)) {
+        cerr << "Cannot open " << text.error() << endl;
+        return 1;
+    }
+
+    vector<int> threadCounts;
+    if (config.scaling) {
+        for (int t = 1; t < config.threads; t *= 2) {
+            threadCounts.push_back(t);
+        }
+    }
+    threadCounts.push_back(config.threads);
+
+    cout << std::right << std::setw(8) << "Threads" << std::setw(12) << "Scan (ms)" << std::setw(12)
+         << "Parse (ms)" << std::setw(12) << "Total (ms)" << std::setw(10) << "GB/s" << endl;
+    cout << string(54, '-') << endl;
+    DungeonGrid grid;
+    LoadTiming timing;
+    for (int threads : threadCounts) {
+        string error;
+        timing = timeLoad(text, threads, config.repeat, grid, error);
+        if (!error.empty()) {
+            cerr << config.textPath << ": " << error << endl;
+            return 1;
+        }
+        printTimingRow(threads, timing, text.size());
+    }
+    cout << grid.rows << " x " << grid.cols << " from " << std::fixed << std::setprecision(1)
+         << text.size() / 1e6 << " MB of text" << endl;
+    cout.unsetf(std::ios::fixed);
+
+    if (config.solve && !grid.empty()) {
+        double solveNs = bestTimeNs([&]() { DungeonKernels::scalar1D(grid); }, 0, config.repeat);
+        cout << "Minimum HP: " << DungeonKernels::scalar1D(grid) << " (scalar1d " << std::fixed
+             << std::setprecision(2) << solveNs / 1e6 << " ms; load / solve = "
+             << (timing.scanNs + timing.parseNs) / solveNs << ")" << endl;
+        cout.unsetf(std::ios::fixed);
+    }
+
+    int status = 0;
+    if (!config.checkPath.empty()) {
+        MappedDungeonFile reference;
+        if (!reference.open(config.checkPath)) {
+            cerr << "Cannot open " << reference.error() << endl;
+            return 1;
+        }
+        bool same = reference.rows() == grid.rows && reference.cols() == grid.cols &&
+                    std::equal(grid.cells.begin(), grid.cells.end(), reference.data());
+        cout << "Check against " << config.checkPath << ": " << (same ? "identical" : "DIFFERENT") << endl;
+        status = same ? 0 : 1;
+    }
+
+    if (!config.outPath.empty()) {
+        string error;
+        if (!convertDungeonText(config.textPath, config.outPath, &error, config.threads)) {
+            cerr << "Cannot convert: " << error << endl;
+            return 1;
+        }
+        cout << "Wrote " << config.outPath << endl;
+    }
+    return status;
+}
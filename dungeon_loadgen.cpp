@@ -0,0 +1,323 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+#include "adaptive_solver.h"
+#include "latency_histogram.h"
+
+using std::vector;
+using std::string;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/**
+ * Load generator: tail latency and throughput under concurrent solves
+ *
+ * N client threads share one AdaptiveDungeonSolver and submit grids drawn
+ * from a size mix (default 90% 32x32, 9% 1000x1000, 1% 10000x10000).
+ *
+ *   open-loop    each client keeps a fixed send schedule (rate / clients
+ *                per second) that a slow reply does not push back. A client
+ *                still blocks in solve(), so it never has two requests in
+ *                flight: after a slow solve its next requests go out late,
+ *                back to back. Response time runs from the intended send
+ *                time (wrk2-style), so that lateness is counted
+ *   closed-loop  each client waits for its reply before the next request,
+ *                paced to the target rate if one is given; a reply that
+ *                overruns the pacing interval is recorded together with
+ *                the requests it held back (coordinated-omission
+ *                correction, as HdrHistogram's expected-interval recording)
+ *
+ * The held-back requests would have been drawn from the whole mix, so in
+ * closed-loop mode the correction goes into the overall response
+ * histogram only; per-size rows report the replies actually received.
+ *
+ * Service time is the solve alone. Samples scheduled during the warmup are
+ * dropped, and throughput counts solves completed in the measured window.
+ */
+
+struct SizeWeight {
+    int size;
+    double weight;
+};
+
+struct LoadConfig {
+    vector<SizeWeight> mix = {{32, 90}, {1000, 9}, {10000, 1}};
+    int clients = 0;
+    double rate = 0;        // solves per second over all clients; 0 = unpaced
+    bool openLoop = false;
+    double seconds = 10;
+    double warmupSeconds = 1;
+    int solverThreads = 1;  // per solve; clients already run in parallel
+    string jsonPath;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+// Histograms of one client, merged after the run
+struct ClientResult {
+    vector<LatencyHistogram> service;   // per mix entry
+    vector<LatencyHistogram> response;
+    LatencyHistogram allResponse;       // with the closed-loop correction
+    uint64_t completed = 0;             // solves finished inside the window
+    uint64_t behindSchedule = 0;        // open-loop: started late by > 1 ms
+
+    explicit ClientResult(size_t sizes) : service(sizes), response(sizes) {}
+};
+
+static uint64_t nanosBetween(Clock::time_point from, Clock::time_point to) {
+    return to > from ? static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count()) : 0;
+}
+
+static void runClient(const LoadConfig& config, const AdaptiveDungeonSolver& solver,
+                      const vector<DungeonGrid>& grids, Clock::time_point start,
+                      int client, ClientResult& result) {
+    Workspace workspace;
+    auto warmupEnd = start + std::chrono::nanoseconds(static_cast<long long>(config.warmupSeconds * 1e9));
+    auto end = warmupEnd + std::chrono::nanoseconds(static_cast<long long>(config.seconds * 1e9));
+
+    // Each client paces its share of the rate; stagger their first slots
+    uint64_t intervalNs = config.rate > 0 ? static_cast<uint64_t>(1e9 * config.clients / config.rate) : 0;
+    Clock::time_point next = start + std::chrono::nanoseconds(intervalNs * client / config.clients);
+
+    double totalWeight = 0;
+    for (const auto& entry : config.mix) {
+        totalWeight += entry.weight;
+    }
+    uint64_t state = 0x9E3779B97F4A7C15ull * (client + 1);
+
+    for (;;) {
+        Clock::time_point intended = intervalNs > 0 ? next : Clock::now();
+        if (intended >= end) {
+            break;
+        }
+        if (intervalNs > 0) {
+            std::this_thread::sleep_until(intended);
+        }
+
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        double draw = (state >> 11) * (1.0 / 9007199254740992.0) * totalWeight;
+        size_t k = 0;
+        while (k + 1 < config.mix.size() && draw >= config.mix[k].weight) {
+            draw -= config.mix[k].weight;
+            k++;
+        }
+
+        Clock::time_point sent = Clock::now();
+        volatile int answer = solver.solve(grids[k], SolveOptions(), &workspace).minimumHP;
+        (void)answer;
+        Clock::time_point done = Clock::now();
+
+        if (intervalNs > 0) {
+            next += std::chrono::nanoseconds(intervalNs);
+            // Closed loop: a late reply moves the schedule instead of
+            // bursting to catch up; the correction accounts for the gap
+            if (!config.openLoop && next < done) {
+                next = done;
+            }
+        }
+
+        if (intended < warmupEnd) {
+            continue;
+        }
+        uint64_t serviceNs = nanosBetween(sent, done);
+        result.service[k].record(serviceNs);
+        if (config.openLoop) {
+            uint64_t responseNs = nanosBetween(intended, done);
+            result.response[k].record(responseNs);
+            result.allResponse.record(responseNs);
+            if (nanosBetween(intended, sent) > 1000000) {
+                result.behindSchedule++;
+            }
+        } else {
+            result.response[k].record(serviceNs);
+            result.allResponse.recordWithExpectedInterval(serviceNs, intervalNs);
+        }
+        if (done <= end) {
+            result.completed++;
+        }
+    }
+}
+
+static bool parseMix(const string& text, vector<SizeWeight>& mix) {
+    mix.clear();
+    std::stringstream list(text);
+    string item;
+    while (std::getline(list, item, ',')) {
+        size_t colon = item.find(':');
+        SizeWeight entry;
+        entry.size = std::atoi(item.substr(0, colon).c_str());
+        entry.weight = colon == string::npos ? 1 : std::atof(item.substr(colon + 1).c_str());
+        if (entry.size < 1 || entry.weight <= 0) {
+            return false;
+        }
+        mix.push_back(entry);
+    }
+    return !mix.empty();
+}
+
+static void printRow(const string& label, double share, const LatencyHistogram& service,
+                     const LatencyHistogram& response) {
+    cout << std::left << std::setw(13) << label << std::right << std::fixed << std::setprecision(1)
+         << std::setw(7) << share << std::setw(10) << service.count() << std::setprecision(1)
+         << std::setw(11) << service.percentile(0.5) / 1e3
+         << std::setw(11) << service.percentile(0.99) / 1e3
+         << std::setw(11) << response.percentile(0.5) / 1e3
+         << std::setw(11) << response.percentile(0.99) / 1e3
+         << std::setw(12) << response.percentile(0.999) / 1e3
+         << std::setw(12) << response.max() / 1e3 << endl;
+    cout.unsetf(std::ios::fixed);
+}
+
+static void writeJsonLatency(std::ostream& out, const LatencyHistogram& histogram) {
+    out << "{\"count\": " << histogram.count() << ", \"p50_ns\": " << histogram.percentile(0.5)
+        << ", \"p90_ns\": " << histogram.percentile(0.9) << ", \"p99_ns\": " << histogram.percentile(0.99)
+        << ", \"p999_ns\": " << histogram.percentile(0.999) << ", \"max_ns\": " << histogram.max() << "}";
+}
+
+static void printUsage() {
+    cout << "Usage: dungeon_loadgen [options]\n"
+         << "  --mix N:W,N:W,...    grid sizes (N x N) and weights (default 32:90,1000:9,10000:1)\n"
+         << "  --clients N          client threads (default: hardware threads)\n"
+         << "  --rate R             target solves per second over all clients (0: as fast as possible)\n"
+         << "  --open-loop          time responses from a fixed send schedule (needs --rate)\n"
+         << "  --closed-loop        wait for each reply (default)\n"
+         << "  --seconds S          measured time (default 10)\n"
+         << "  --warmup S           unmeasured lead-in (default 1)\n"
+         << "  --solver-threads N   threads per solve for the tiled kernel (default 1)\n"
+         << "  --json PATH          also write the results as JSON\n";
+}
+
+int main(int argc, char** argv) {
+    LoadConfig config;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--mix" && hasValue) {
+            if (!parseMix(argv[++i], config.mix)) {
+                cerr << "Bad --mix " << argv[i] << endl;
+                return 1;
+            }
+        } else if (arg == "--clients" && hasValue) {
+            config.clients = std::atoi(argv[++i]);
+        } else if (arg == "--rate" && hasValue) {
+            config.rate = std::atof(argv[++i]);
+        } else if (arg == "--open-loop") {
+            config.openLoop = true;
+        } else if (arg == "--closed-loop") {
+            config.openLoop = false;
+        } else if (arg == "--seconds" && hasValue) {
+            config.seconds = std::atof(argv[++i]);
+        } else if (arg == "--warmup" && hasValue) {
+            config.warmupSeconds = std::atof(argv[++i]);
+        } else if (arg == "--solver-threads" && hasValue) {
+            config.solverThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--json" && hasValue) {
+            config.jsonPath = argv[++i];
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (config.clients <= 0) {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        config.clients = hardware > 0 ? static_cast<int>(hardware) : 1;
+    }
+    if (config.openLoop && config.rate <= 0) {
+        cerr << "--open-loop needs --rate" << endl;
+        return 1;
+    }
+
+    // Setup, unmeasured: one shared read-only grid per size
+    vector<DungeonGrid> grids;
+    double totalWeight = 0;
+    for (const auto& entry : config.mix) {
+        grids.push_back(syntheticGrid(entry.size, entry.size, static_cast<uint32_t>(entry.size)));
+        totalWeight += entry.weight;
+    }
+    AdaptiveDungeonSolver solver(config.solverThreads);
+
+    vector<ClientResult> results(config.clients, ClientResult(config.mix.size()));
+    vector<std::thread> clients;
+    Clock::time_point start = Clock::now() + std::chrono::milliseconds(10);
+    for (int client = 0; client < config.clients; client++) {
+        clients.push_back(std::thread(runClient, std::cref(config), std::cref(solver), std::cref(grids),
+                                      start, client, std::ref(results[client])));
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+
+    // Merge the clients
+    vector<LatencyHistogram> service(config.mix.size()), response(config.mix.size());
+    LatencyHistogram allService, allResponse;
+    uint64_t completed = 0, behind = 0;
+    for (const auto& result : results) {
+        for (size_t k = 0; k < config.mix.size(); k++) {
+            service[k].merge(result.service[k]);
+            response[k].merge(result.response[k]);
+            allService.merge(result.service[k]);
+        }
+        allResponse.merge(result.allResponse);
+        completed += result.completed;
+        behind += result.behindSchedule;
+    }
+    double throughput = completed / config.seconds;
+
+    cout << (config.openLoop ? "Open" : "Closed") << "-loop, " << config.clients << " clients, target "
+         << (config.rate > 0 ? std::to_string(static_cast<long long>(config.rate)) + "/s" : string("unpaced"))
+         << ", achieved " << std::fixed << std::setprecision(1) << throughput << "/s over "
+         << config.seconds << " s" << endl;
+    cout.unsetf(std::ios::fixed);
+    if (config.openLoop) {
+        cout << "Requests started > 1 ms behind schedule: " << behind << endl;
+    }
+    cout << std::left << std::setw(13) << "Grid" << std::right << std::setw(7) << "Mix %"
+         << std::setw(10) << "Solves" << std::setw(11) << "svc p50" << std::setw(11) << "svc p99"
+         << std::setw(11) << "resp p50" << std::setw(11) << "resp p99" << std::setw(12) << "resp p999"
+         << std::setw(12) << "resp max" << "   (us)" << endl;
+    cout << string(98, '-') << endl;
+    for (size_t k = 0; k < config.mix.size(); k++) {
+        string label = std::to_string(config.mix[k].size) + "x" + std::to_string(config.mix[k].size);
+        printRow(label, 100 * config.mix[k].weight / totalWeight, service[k], response[k]);
+    }
+    printRow("all", 100, allService, allResponse);
+    if (!config.openLoop && config.rate <= 0) {
+        cout << "Unpaced closed loop: response = service, nothing to correct" << endl;
+    }
+
+    if (!config.jsonPath.empty()) {
+        std::ofstream out(config.jsonPath);
+        out << "{\n  \"mode\": \"" << (config.openLoop ? "open" : "closed") << "\",\n"
+            << "  \"clients\": " << config.clients << ",\n  \"target_rate\": " << config.rate << ",\n"
+            << "  \"achieved_rate\": " << throughput << ",\n  \"seconds\": " << config.seconds << ",\n"
+            << "  \"sizes\": [";
+        for (size_t k = 0; k < config.mix.size(); k++) {
+            out << (k ? ",\n" : "\n") << "    {\"size\": " << config.mix[k].size
+                << ", \"weight\": " << config.mix[k].weight << ", \"service\": ";
+            writeJsonLatency(out, service[k]);
+            out << ", \"response\": ";
+            writeJsonLatency(out, response[k]);
+            out << "}";
+        }
+        out << "\n  ],\n  \"service\": ";
+        writeJsonLatency(out, allService);
+        out << ",\n  \"response\": ";
+        writeJsonLatency(out, allResponse);
+        out << "\n}\n";
+        if (!out) {
+            cerr << "Cannot write " << config.jsonPath << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
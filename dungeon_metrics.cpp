@@ -0,0 +1,212 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+
+#include "solve_metrics.h"
+#include "alloc_hooks.h"
+
+using std::vector;
+using std::string;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/**
+ * Service-style workload with solve latency metrics
+ *
+ * Worker threads solve a mix of grid sizes through MeteredDungeonSolver
+ * for a fixed time, each with its own Workspace, as a request handler
+ * would. At the end it prints p50 / p99 / p999 per kernel and size class
+ * and writes the Prometheus snapshot. While it runs, SIGUSR1 writes an
+ * intermediate snapshot to the same place:
+ *
+ *   dungeon_metrics --seconds 60 --prometheus /var/lib/node_exporter/dungeon.prom &
+ *   kill -USR1 %1
+ *
+ * --chrome-trace records a span per solve, tile and barrier wait and
+ * writes them as Chrome trace JSON for Perfetto when the run ends.
+ */
+
+static volatile std::sig_atomic_t dumpRequested = 0;
+
+static void requestDump(int) {
+    dumpRequested = 1;
+}
+
+struct WorkloadConfig {
+    vector<int> sizes = {16, 64, 256, 1024};
+    int threads = 0;
+    double seconds = 2;
+    string prometheusPath;  // empty: table only; "-": stdout
+    string tuningPath;
+    string chromeTracePath;
+};
+
+static void runWorker(const MeteredDungeonSolver& solver, const vector<DungeonGrid>& grids,
+                      const std::atomic<bool>& stop, int worker) {
+    Workspace workspace;
+    uint32_t state = 2654435761u * (worker + 1);
+    while (!stop.load(std::memory_order_relaxed)) {
+        // Small grids dominate, as in a request mix: grid k is picked with
+        // weight proportional to 1 / 4^k
+        state = state * 1664525u + 1013904223u;
+        uint32_t draw = state >> 8;
+        size_t k = 0;
+        while (k + 1 < grids.size() && (draw & 3) == 0) {
+            draw >>= 2;
+            k++;
+        }
+
+        // Half the requests declare their value range, which lets the
+        // adaptive solver use int16 lanes; the rest fall back to int32
+        SolveOptions options;
+        if (state & 0x80000000u) {
+            options.valueRangeKnown = true;
+            options.minValue = -10;
+            options.maxValue = 10;
+        }
+        solver.solve(grids[k], options, &workspace);
+    }
+}
+
+static void printLatencyTable(const MetricsSnapshot& snapshot) {
+    cout << std::left << std::setw(13) << "Kernel" << std::setw(8) << "Class" << std::right
+         << std::setw(10) << "Solves" << std::setw(12) << "p50 (us)" << std::setw(12) << "p99 (us)"
+         << std::setw(12) << "p999 (us)" << std::setw(12) << "max (us)" << std::setw(12)
+         << "allocs" << endl;
+    cout << string(91, '-') << endl;
+    for (const auto& series : snapshot.series) {
+        const LatencyHistogram& latency = series.latency;
+        cout << std::left << std::setw(13) << kernelName(series.kernel)
+             << std::setw(8) << sizeClassName(series.sizeClass) << std::right
+             << std::setw(10) << latency.count() << std::fixed << std::setprecision(2)
+             << std::setw(12) << latency.percentile(0.5) / 1e3
+             << std::setw(12) << latency.percentile(0.99) / 1e3
+             << std::setw(12) << latency.percentile(0.999) / 1e3
+             << std::setw(12) << latency.max() / 1e3
+             << std::setw(12) << series.allocations << endl;
+        cout.unsetf(std::ios::fixed);
+    }
+    cout << "int16 -> int32 widened solves: " << snapshot.int16Widened << endl;
+}
+
+static void printUsage() {
+    cout << "Usage: dungeon_metrics [options]\n"
+         << "  --sizes N,N,...      square grid sizes in the mix (default 16,64,256,1024)\n"
+         << "  --threads N          worker threads (default: hardware threads)\n"
+         << "  --seconds S          run time (default 2)\n"
+         << "  --prometheus PATH    write the Prometheus snapshot to PATH, or - for stdout\n"
+         << "  --tuning PATH        AutoTuner profile for the adaptive solver\n"
+         << "  --chrome-trace PATH  write a Perfetto / chrome://tracing timeline\n";
+}
+
+int main(int argc, char** argv) {
+    WorkloadConfig config;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sizes" && hasValue) {
+            config.sizes.clear();
+            std::stringstream list(argv[++i]);
+            string item;
+            while (std::getline(list, item, ',')) {
+                if (!item.empty()) config.sizes.push_back(std::atoi(item.c_str()));
+            }
+        } else if (arg == "--threads" && hasValue) {
+            config.threads = std::atoi(argv[++i]);
+        } else if (arg == "--seconds" && hasValue) {
+            config.seconds = std::atof(argv[++i]);
+        } else if (arg == "--prometheus" && hasValue) {
+            config.prometheusPath = argv[++i];
+        } else if (arg == "--tuning" && hasValue) {
+            config.tuningPath = argv[++i];
+        } else if (arg == "--chrome-trace" && hasValue) {
+            config.chromeTracePath = argv[++i];
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (config.sizes.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    AdaptiveDungeonSolver solver(config.threads);
+    if (!config.tuningPath.empty() && !solver.loadTuning(config.tuningPath)) {
+        cerr << "No profile for this CPU in " << config.tuningPath << ", using defaults" << endl;
+    }
+    SolveMetrics metrics;
+    MeteredDungeonSolver metered(solver, metrics);
+
+    vector<DungeonGrid> grids;
+    for (int size : config.sizes) {
+        grids.push_back(syntheticGrid(size, size, static_cast<uint32_t>(size)));
+    }
+
+    SpanTracer timeline;
+    if (!config.chromeTracePath.empty()) {
+        timeline.activate();
+    }
+
+#if defined(SIGUSR1)
+    std::signal(SIGUSR1, requestDump);
+#endif
+
+    std::atomic<bool> stop(false);
+    vector<std::thread> workers;
+    for (int worker = 0; worker < solver.threadCount(); worker++) {
+        workers.push_back(std::thread(runWorker, std::cref(metered), std::cref(grids),
+                                      std::cref(stop), worker));
+    }
+
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::microseconds(static_cast<long long>(config.seconds * 1e6));
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        if (dumpRequested) {
+            dumpRequested = 0;
+            if (!config.prometheusPath.empty() && !metrics.exportPrometheus(config.prometheusPath)) {
+                cerr << "Cannot write " << config.prometheusPath << endl;
+            }
+        }
+    }
+    stop = true;
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    SpanTracer::deactivate();
+
+    MetricsSnapshot snapshot = metrics.snapshot();
+    // Keep stdout parseable when the snapshot goes there
+    if (config.prometheusPath != "-") {
+        printLatencyTable(snapshot);
+    }
+    if (!config.prometheusPath.empty()) {
+        if (!metrics.exportPrometheus(config.prometheusPath)) {
+            cerr << "Cannot write " << config.prometheusPath << endl;
+            return 1;
+        }
+        if (config.prometheusPath != "-") {
+            cout << "Prometheus snapshot written to " << config.prometheusPath << endl;
+        }
+    }
+    if (!config.chromeTracePath.empty()) {
+        if (!timeline.writeChromeJson(config.chromeTracePath)) {
+            cerr << "Cannot write " << config.chromeTracePath << endl;
+            return 1;
+        }
+        if (config.prometheusPath != "-") {
+            cout << timeline.spans() << " spans (" << timeline.dropped() << " dropped) written to "
+                 << config.chromeTracePath << endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,609 @@
+#ifndef DUNGEON_GAME_DUNGEON_READAHEAD_H
+#define DUNGEON_GAME_DUNGEON_READAHEAD_H
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <initializer_list>
+
+#include "dungeon_file.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(IORING_FEAT_SINGLE_MMAP)
+#define DUNGEON_IO_URING 1
+#endif
+#endif
+#endif
+
+/**
+ * Read-ahead for streaming solves of files too large to hold
+ *
+ * A solve that reads a block and then computes on it leaves the disk idle
+ * while it computes and the CPU idle while it reads, so it takes the sum
+ * of the two. BlockReadAhead keeps `depth` blocks of a read plan in
+ * flight and hands them over in plan order; while the consumer works on
+ * one block the next depth - 1 are loading, and the solve takes the larger
+ * of the two instead (depth 2 is double buffering).
+ *
+ *   IoUring   one io_uring, a readv per block; raw syscalls, no liburing
+ *   Threads   depth - 1 threads calling pread
+ *   Sync      pread when the block is asked for: the baseline
+ *
+ * IoUring falls back to Threads where the kernel has no io_uring (before
+ * Linux 5.1, or disabled by seccomp or io_uring_disabled), and direct
+ * falls back to the page cache on file systems without O_DIRECT;
+ * fallback() says which happened. Buffers are page aligned and every read
+ * is widened to whole pages, so any plan works with O_DIRECT.
+ */
+enum class ReadEngine {
+    Sync,
+    Threads,
+    IoUring
+};
+
+inline const char* readEngineName(ReadEngine engine) {
+    switch (engine) {
+        case ReadEngine::Sync:    return "sync";
+        case ReadEngine::Threads: return "threads";
+        case ReadEngine::IoUring: return "uring";
+        default:                  return "unknown";
+    }
+}
+
+inline bool parseReadEngine(const std::string& name, ReadEngine& engine) {
+    for (ReadEngine candidate : {ReadEngine::Sync, ReadEngine::Threads, ReadEngine::IoUring}) {
+        if (name == readEngineName(candidate)) {
+            engine = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+struct ReadAheadOptions {
+    ReadEngine engine = ReadEngine::IoUring;
+    int depth = 4;                // blocks in flight, the one being consumed included
+    size_t blockBytes = 8 << 20;  // the largest range a plan may hold
+    bool direct = false;          // O_DIRECT: past the page cache, straight from the disk
+};
+
+struct ReadRange {
+    uint64_t offset = 0;
+    size_t bytes = 0;
+};
+
+class BlockReadAhead {
+private:
+    static const size_t kPage = 4096;
+
+    // One buffer per block in flight; request r always uses slot r % depth
+    struct Slot {
+        char* buffer = nullptr;
+        uint64_t offset = 0;  // page-aligned start of the read
+        size_t bytes = 0;     // bytes to read from offset, whole pages
+        size_t needed = 0;    // of those, the ones the plan asked for must arrive
+        size_t done = 0;
+        bool ready = false;
+        int error = 0;
+#if defined(DUNGEON_IO_URING)
+        struct iovec vector;
+#endif
+    };
+
+    int fd = -1;
+    ReadAheadOptions options;
+    ReadEngine active = ReadEngine::Sync;
+    std::string fallbackNote;
+    std::string lastError;
+    std::vector<Slot> slots;
+    std::vector<ReadRange> plan;
+    size_t submitted = 0;  // requests handed to the engine
+    size_t delivered = 0;  // requests returned by next()
+    uint64_t readBytes = 0;
+    double waitNs = 0;
+
+    // Threads engine
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable queued;
+    std::condition_variable finished;
+    std::deque<size_t> queue;  // slots to read
+    bool stopping = false;
+
+#if defined(DUNGEON_IO_URING)
+    // IoUring engine: the rings as mmap'ed from the kernel
+    int ring = -1;
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    size_t sqRingBytes = 0;
+    size_t cqRingBytes = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqesBytes = 0;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+#endif
+
+    bool fail(const std::string& reason) {
+        if (lastError.empty()) {
+            lastError = reason;
+        }
+        return false;
+    }
+
+    // Reads what is left of the slot's range with pread; false on an error
+    bool readSlot(Slot& slot) {
+#if defined(DUNGEON_FILE_MMAP)
+        while (slot.done < slot.bytes) {
+            ssize_t got = pread(fd, slot.buffer + slot.done, slot.bytes - slot.done,
+                                static_cast<off_t>(slot.offset + slot.done));
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got < 0) {
+                slot.error = errno;
+                return false;
+            }
+            if (got == 0) {
+                break;  // end of file, inside the last page
+            }
+            slot.done += static_cast<size_t>(got);
+        }
+        return true;
+#else
+        slot.error = ENOSYS;
+        return false;
+#endif
+    }
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            queued.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            Slot& slot = slots[queue.front()];
+            queue.pop_front();
+            lock.unlock();
+            readSlot(slot);
+            lock.lock();
+            slot.ready = true;
+            finished.notify_all();
+        }
+    }
+
+    void submit(size_t request) {
+        Slot& slot = slots[request % slots.size()];
+        const ReadRange& range = plan[request];
+        slot.offset = range.offset / kPage * kPage;
+        slot.needed = static_cast<size_t>(range.offset - slot.offset) + range.bytes;
+        slot.bytes = (slot.needed + kPage - 1) / kPage * kPage;
+        slot.done = 0;
+        slot.ready = false;
+        slot.error = 0;
+        submitted++;
+        if (active == ReadEngine::Threads) {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(request % slots.size());
+            queued.notify_one();
+        }
+#if defined(DUNGEON_IO_URING)
+        if (active == ReadEngine::IoUring) {
+            submitRing(request % slots.size());
+        }
+#endif
+    }
+
+    // Blocks until the slot's read is complete
+    void await(Slot& slot) {
+        if (active == ReadEngine::Sync) {
+            readSlot(slot);
+            slot.ready = true;
+        }
+        if (active == ReadEngine::Threads) {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [&slot]() { return slot.ready; });
+        }
+#if defined(DUNGEON_IO_URING)
+        while (active == ReadEngine::IoUring && !slot.ready) {
+            reapRing();
+        }
+#endif
+    }
+
+#if defined(DUNGEON_IO_URING)
+    bool setupRing(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ring < 0) {
+            fallbackNote = std::string("io_uring unavailable (") + std::strerror(errno) + "), using threads";
+            return false;
+        }
+        sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) {
+            sqRingBytes = cqRingBytes = std::max(sqRingBytes, cqRingBytes);
+        }
+        sqRing = mmap(nullptr, sqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+        cqRing = single ? sqRing
+                        : mmap(nullptr, cqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring,
+                               IORING_OFF_CQ_RING);
+        sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+        void* entriesMap = mmap(nullptr, sqesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring,
+                                IORING_OFF_SQES);
+        if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || entriesMap == MAP_FAILED) {
+            if (sqRing == MAP_FAILED) sqRing = nullptr;
+            if (cqRing == MAP_FAILED) cqRing = nullptr;
+            sqes = entriesMap == MAP_FAILED ? nullptr : static_cast<io_uring_sqe*>(entriesMap);
+            closeRing();
+            fallbackNote = "io_uring rings cannot be mapped, using threads";
+            return false;
+        }
+        char* sq = static_cast<char*>(sqRing);
+        char* cq = static_cast<char*>(cqRing);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        sqes = static_cast<io_uring_sqe*>(entriesMap);
+        return true;
+    }
+
+    void closeRing() {
+        if (sqes) munmap(sqes, sqesBytes);
+        if (cqRing && cqRing != sqRing) munmap(cqRing, cqRingBytes);
+        if (sqRing) munmap(sqRing, sqRingBytes);
+        if (ring >= 0) ::close(ring);
+        ring = -1;
+        sqRing = cqRing = nullptr;
+        sqes = nullptr;
+    }
+
+    // Queues a readv of what is left of the slot's range; the slot index
+    // comes back as the completion's user_data
+    void submitRing(size_t index) {
+        Slot& slot = slots[index];
+        slot.vector.iov_base = slot.buffer + slot.done;
+        slot.vector.iov_len = slot.bytes - slot.done;
+        unsigned tail = *sqTail;  // only this thread writes the tail
+        unsigned entry = tail & *sqMask;
+        io_uring_sqe& sqe = sqes[entry];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(&slot.vector);
+        sqe.len = 1;
+        sqe.off = slot.offset + slot.done;
+        sqe.user_data = index;
+        sqArray[entry] = entry;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        while (syscall(__NR_io_uring_enter, ring, 1, 0, 0, nullptr, 0) < 0 && errno == EINTR) {
+        }
+    }
+
+    // Waits for at least one completion and applies all that are there
+    void reapRing() {
+        unsigned head = *cqHead;
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            if (syscall(__NR_io_uring_enter, ring, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+                for (Slot& slot : slots) {
+                    if (!slot.ready) slot.error = errno;
+                    slot.ready = true;
+                }
+                return;
+            }
+        }
+        for (; head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE); head++) {
+            const io_uring_cqe& cqe = cqes[head & *cqMask];
+            Slot& slot = slots[static_cast<size_t>(cqe.user_data)];
+            if (cqe.res > 0 && slot.done + cqe.res < slot.bytes) {
+                slot.done += static_cast<size_t>(cqe.res);  // short read: the rest goes back in
+                __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+                submitRing(static_cast<size_t>(cqe.user_data));
+                continue;
+            }
+            if (cqe.res < 0) {
+                slot.error = -cqe.res;
+            } else {
+                slot.done += static_cast<size_t>(cqe.res);
+            }
+            slot.ready = true;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+#endif
+
+public:
+    BlockReadAhead() {}
+    ~BlockReadAhead() { close(); }
+
+    BlockReadAhead(const BlockReadAhead&) = delete;
+    BlockReadAhead& operator=(const BlockReadAhead&) = delete;
+
+    bool open(const std::string& path, const ReadAheadOptions& readOptions) {
+        close();
+        options = readOptions;
+        options.depth = options.engine == ReadEngine::Sync ? 1 : std::max(2, options.depth);
+#if defined(DUNGEON_FILE_MMAP)
+        int flags = O_RDONLY;
+#if defined(O_DIRECT)
+        if (options.direct) {
+            fd = ::open(path.c_str(), flags | O_DIRECT);
+            if (fd < 0 && errno == EINVAL) {
+                fallbackNote = "no O_DIRECT on this file system, reading through the page cache";
+            }
+        }
+#else
+        if (options.direct) {
+            fallbackNote = "no O_DIRECT on this platform, reading through the page cache";
+        }
+#endif
+        if (fd < 0) {
+            fd = ::open(path.c_str(), flags);
+        }
+        if (fd < 0) {
+            return fail(path + ": " + std::strerror(errno));
+        }
+#else
+        return fail(path + ": read-ahead needs POSIX pread");
+#endif
+
+        size_t bufferBytes = (options.blockBytes + 2 * kPage - 1) / kPage * kPage;
+        slots.resize(options.depth);
+        for (Slot& slot : slots) {
+#if defined(DUNGEON_FILE_MMAP)
+            void* buffer = nullptr;
+            if (posix_memalign(&buffer, kPage, bufferBytes) != 0) {
+                close();
+                return fail(path + ": cannot allocate read buffers");
+            }
+            slot.buffer = static_cast<char*>(buffer);
+#endif
+        }
+
+        active = options.engine;
+#if defined(DUNGEON_IO_URING)
+        if (active == ReadEngine::IoUring && !setupRing(static_cast<unsigned>(options.depth))) {
+            active = ReadEngine::Threads;
+        }
+#else
+        if (active == ReadEngine::IoUring) {
+            fallbackNote = "built without io_uring, using threads";
+            active = ReadEngine::Threads;
+        }
+#endif
+        if (active == ReadEngine::Threads) {
+            stopping = false;
+            for (int t = 0; t < options.depth - 1; t++) {
+                workers.push_back(std::thread([this]() { workerLoop(); }));
+            }
+        }
+        return true;
+    }
+
+    // Waits for reads in flight, then releases everything
+    void close() {
+        if (!workers.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+                queued.notify_all();
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            workers.clear();
+        }
+#if defined(DUNGEON_IO_URING)
+        if (ring >= 0) {
+            // The kernel may still be writing into the buffers
+            for (size_t r = delivered; r < submitted; r++) {
+                await(slots[r % slots.size()]);
+            }
+            closeRing();
+        }
+#endif
+        for (Slot& slot : slots) {
+            std::free(slot.buffer);
+        }
+        slots.clear();
+        queue.clear();
+        plan.clear();
+#if defined(DUNGEON_FILE_MMAP)
+        if (fd >= 0) {
+            ::close(fd);
+        }
+#endif
+        fd = -1;
+        submitted = delivered = 0;
+        readBytes = 0;
+        waitNs = 0;
+        fallbackNote.clear();
+        lastError.clear();
+    }
+
+    // The ranges next() will return, in order; none larger than blockBytes.
+    // The first depth - 1 reads start now (Sync reads nothing ahead)
+    void start(const std::vector<ReadRange>& ranges) {
+        plan = ranges;
+        submitted = delivered = 0;
+        for (size_t r = 0; r < plan.size() && r + 1 < slots.size(); r++) {
+            submit(r);
+        }
+    }
+
+    // The next range of the plan once it is read, valid until the next
+    // call; nullptr at the end of the plan or on an error (see error())
+    const char* next() {
+        if (delivered >= plan.size() || failed()) {
+            return nullptr;
+        }
+        // The block handed out last is done with, and its slot is free
+        // for the read depth - 1 blocks ahead (Sync: this one). io_uring may
+        // complete a read of cached pages inside the submit, so that counts
+        // as waiting too
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        size_t ahead = delivered + slots.size() - 1;
+        if (ahead < plan.size()) {
+            submit(ahead);
+        }
+        Slot& slot = slots[delivered % slots.size()];
+        await(slot);
+        waitNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        const ReadRange& range = plan[delivered++];
+        if (slot.error != 0) {
+            fail(std::strerror(slot.error));
+            return nullptr;
+        }
+        if (slot.done < slot.needed) {
+            fail("file ends before byte " + std::to_string(range.offset + range.bytes));
+            return nullptr;
+        }
+        readBytes += range.bytes;
+        return slot.buffer + (range.offset - slot.offset);
+    }
+
+    bool failed() const { return !lastError.empty(); }
+    const std::string& error() const { return lastError; }
+    // The engine in use, after any fallback, and why it fell back
+    ReadEngine engine() const { return active; }
+    const std::string& fallback() const { return fallbackNote; }
+    int depth() const { return static_cast<int>(slots.size()); }
+    uint64_t bytesRead() const { return readBytes; }
+    // Time next() spent blocked on reads: the I/O the consumer did not hide
+    double waitSeconds() const { return waitNs / 1e9; }
+};
+
+/**
+ * A .dgrid file's rows bottom up, read ahead in blocks
+ *
+ *     ReadAheadDungeonFile file;
+ *     file.open("huge.dgrid", options);
+ *     DungeonKernels::streaming(file.rows(), file.cols(),
+ *                               [&file](int i) { return file.row(i); });
+ *
+ * The plan is the file's rows in blocks of blockBytes, last block first,
+ * so the kernel computes on one block while the next ones load. Memory is
+ * depth blocks. Rows must be asked for bottom up, as the streaming kernel
+ * does; a read error, or rows out of that order, read as zeros and set
+ * failed(), like ReverseTextRowReader.
+ */
+class ReadAheadDungeonFile {
+private:
+    BlockReadAhead reader;
+    DungeonFileHeader fileHeader;
+    const int* cells = nullptr;
+    int blockRows = 1;
+    int blockBegin = 0;  // rows [blockBegin, blockEnd) are at cells
+    int blockEnd = 0;
+    std::vector<int> zeros;
+    std::string lastError;
+
+    const int* failRow(const std::string& reason) {
+        if (lastError.empty()) {
+            lastError = reason;
+        }
+        blockBegin = blockEnd = 0;
+        return zeros.data();
+    }
+
+public:
+    ReadAheadDungeonFile() { std::memset(&fileHeader, 0, sizeof(fileHeader)); }
+
+    bool open(const std::string& path, const ReadAheadOptions& options) {
+        lastError.clear();
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) {
+            lastError = path + ": " + std::strerror(errno);
+            return false;
+        }
+        bool read = std::fread(&fileHeader, sizeof(fileHeader), 1, file) == 1;
+        bool sized = std::fseek(file, 0, SEEK_END) == 0;
+        long fileBytes = sized ? std::ftell(file) : -1;
+        std::fclose(file);
+        std::string problem = read && fileBytes >= 0
+                                  ? checkDungeonFileHeader(fileHeader, static_cast<uint64_t>(fileBytes))
+                                  : "not a dungeon file";
+        if (!problem.empty()) {
+            lastError = path + ": " + problem;
+            return false;
+        }
+        if (!reader.open(path, options)) {
+            lastError = reader.error();
+            return false;
+        }
+
+        size_t rowBytes = static_cast<size_t>(fileHeader.cols) * sizeof(int32_t);
+        if (rowBytes > options.blockBytes) {
+            lastError = path + ": a row is larger than the read block";
+            return false;
+        }
+        blockRows = rowBytes > 0 ? static_cast<int>(std::min<size_t>(options.blockBytes / rowBytes, INT_MAX)) : 1;
+        std::vector<ReadRange> plan;
+        for (int end = rows(); end > 0; end -= blockRows) {
+            int begin = std::max(0, end - blockRows);
+            ReadRange range;
+            range.offset = fileHeader.headerBytes + static_cast<uint64_t>(begin) * rowBytes;
+            range.bytes = static_cast<size_t>(end - begin) * rowBytes;
+            plan.push_back(range);
+        }
+        reader.start(plan);
+        zeros.assign(cols(), 0);
+        blockBegin = blockEnd = rows();
+        return true;
+    }
+
+    int rows() const { return static_cast<int>(fileHeader.rows); }
+    int cols() const { return static_cast<int>(fileHeader.cols); }
+
+    const int* row(int i) {
+        if (i >= blockBegin && i < blockEnd) {
+            return cells + static_cast<size_t>(i - blockBegin) * cols();
+        }
+        if (failed()) {
+            return zeros.data();
+        }
+        if (i != blockBegin - 1) {
+            return failRow("rows must be read bottom up");
+        }
+        const char* block = reader.next();
+        if (!block) {
+            return failRow(reader.failed() ? reader.error() : "read past the first row");
+        }
+        blockEnd = blockBegin;
+        blockBegin = std::max(0, blockEnd - blockRows);
+        cells = reinterpret_cast<const int*>(block);
+        return cells + static_cast<size_t>(i - blockBegin) * cols();
+    }
+
+    bool failed() const { return !lastError.empty(); }
+    const std::string& error() const { return lastError; }
+    const BlockReadAhead& readAhead() const { return reader; }
+};
+
+#endif // DUNGEON_GAME_DUNGEON_READAHEAD_H
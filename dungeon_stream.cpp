@@ -0,0 +1,261 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+#include "dungeon_readahead.h"
+#include "dungeon_kernels.h"
+
+using std::vector;
+using std::string;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/**
+ * Streaming solve of a .dgrid file with read-ahead
+ *
+ *   dungeon_stream huge.dgrid --engine all --depth 4 --block-mb 8 --direct
+ *
+ * Solves bottom up with the O(cols) streaming kernel, the rows coming
+ * through BlockReadAhead (dungeon_readahead.h), once per engine. Two
+ * baselines frame the result: "read only" reads the blocks and discards
+ * them (the disk), and "kernel only" runs the kernel on rows already in
+ * memory (the CPU). Without read-ahead (sync) a solve takes about their
+ * sum; with it, about the larger of the two. "I/O wait" is the time the
+ * kernel sat waiting for a block: the I/O not hidden.
+ *
+ * --direct reads with O_DIRECT, past the page cache; --cold instead drops
+ * the file's cached pages before every run (posix_fadvise DONTNEED), so a
+ * run through the page cache also reads the disk. With neither, a file
+ * that fits in RAM is served from memory after the first run.
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+struct StreamConfig {
+    string path;
+    vector<ReadEngine> engines;
+    int depth = 4;
+    size_t blockBytes = 8 << 20;
+    bool direct = false;
+    bool cold = false;
+};
+
+struct StreamRun {
+    double seconds = 0;
+    double waitSeconds = 0;
+    uint64_t bytes = 0;
+    int answer = 0;
+    string note;
+};
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Drops the file's clean pages from the page cache
+static void dropCachedPages(const string& path) {
+#if defined(DUNGEON_FILE_MMAP) && defined(POSIX_FADV_DONTNEED)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+static ReadAheadOptions readOptions(const StreamConfig& config, ReadEngine engine) {
+    ReadAheadOptions options;
+    options.engine = engine;
+    options.depth = config.depth;
+    options.blockBytes = config.blockBytes;
+    options.direct = config.direct;
+    return options;
+}
+
+static bool solve(const StreamConfig& config, ReadEngine engine, StreamRun& run, string& error) {
+    if (config.cold) {
+        dropCachedPages(config.path);
+    }
+    ReadAheadDungeonFile file;
+    Clock::time_point start = Clock::now();
+    if (!file.open(config.path, readOptions(config, engine))) {
+        error = file.error();
+        return false;
+    }
+    run.answer = DungeonKernels::streaming(file.rows(), file.cols(), [&file](int i) { return file.row(i); });
+    run.seconds = secondsSince(start);
+    if (file.failed()) {
+        error = file.error();
+        return false;
+    }
+    run.waitSeconds = file.readAhead().waitSeconds();
+    run.bytes = file.readAhead().bytesRead();
+    run.note = file.readAhead().fallback();
+    return true;
+}
+
+// The disk alone: every block read, nothing computed
+static bool readOnly(const StreamConfig& config, StreamRun& run, string& error) {
+    if (config.cold) {
+        dropCachedPages(config.path);
+    }
+    MappedDungeonFile header;
+    if (!header.open(config.path)) {
+        error = header.error();
+        return false;
+    }
+    uint64_t first = header.header().headerBytes;
+    uint64_t end = first + header.size() * sizeof(int32_t);
+    header.close();
+    vector<ReadRange> plan;
+    for (uint64_t offset = first; offset < end; offset += config.blockBytes) {
+        ReadRange range;
+        range.offset = offset;
+        range.bytes = static_cast<size_t>(std::min<uint64_t>(config.blockBytes, end - offset));
+        plan.push_back(range);
+    }
+    BlockReadAhead reader;
+    Clock::time_point start = Clock::now();
+    if (!reader.open(config.path, readOptions(config, ReadEngine::IoUring))) {
+        error = reader.error();
+        return false;
+    }
+    reader.start(plan);
+    while (reader.next()) {
+    }
+    run.seconds = secondsSince(start);
+    if (reader.failed()) {
+        error = reader.error();
+        return false;
+    }
+    run.bytes = reader.bytesRead();
+    run.note = reader.fallback();
+    return true;
+}
+
+// The kernel alone: the same number of rows, all from one block in memory
+static bool kernelOnly(const StreamConfig& config, StreamRun& run, string& error) {
+    MappedDungeonFile file;
+    if (!file.open(config.path)) {
+        error = file.error();
+        return false;
+    }
+    int rows = file.rows();
+    int cols = file.cols();
+    int blockRows = std::max(1, std::min(rows, static_cast<int>(config.blockBytes / (sizeof(int) * std::max(cols, 1)))));
+    vector<int> block(file.data() + static_cast<size_t>(rows - blockRows) * cols, file.data() + file.size());
+    file.close();
+    Clock::time_point start = Clock::now();
+    run.answer = DungeonKernels::streaming(rows, cols, [&](int i) { return &block[static_cast<size_t>(i % blockRows) * cols]; });
+    run.seconds = secondsSince(start);
+    run.bytes = static_cast<uint64_t>(rows) * cols * sizeof(int);
+    return true;
+}
+
+static void printRun(const string& name, const string& depth, const StreamRun& run, bool answer) {
+    cout << std::left << std::setw(13) << name << std::right << std::setw(6) << depth << std::fixed
+         << std::setprecision(1) << std::setw(12) << run.seconds * 1e3 << std::setprecision(2) << std::setw(9)
+         << run.bytes / run.seconds / 1e9;
+    if (answer) {
+        cout << std::setprecision(1) << std::setw(13) << 100 * run.waitSeconds / run.seconds << std::setw(12) << run.answer;
+    }
+    cout.unsetf(std::ios::fixed);
+    cout << endl;
+    if (!run.note.empty()) {
+        cout << "  (" << run.note << ")" << endl;
+    }
+}
+
+static void printUsage() {
+    cout << "Usage: dungeon_stream FILE.dgrid [options]\n"
+         << "  --engine NAME   sync, threads, uring or all (default all)\n"
+         << "  --depth N       blocks in flight (default 4)\n"
+         << "  --block-mb N    read block size (default 8)\n"
+         << "  --block-kb N    read block size in KB\n"
+         << "  --direct        read with O_DIRECT\n"
+         << "  --cold          drop the file's cached pages before each run\n";
+}
+
+int main(int argc, char** argv) {
+    StreamConfig config;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        ReadEngine engine;
+        if (arg == "--engine" && hasValue) {
+            string name = argv[++i];
+            if (name == "all") {
+                config.engines = {ReadEngine::Sync, ReadEngine::Threads, ReadEngine::IoUring};
+            } else if (parseReadEngine(name, engine)) {
+                config.engines.push_back(engine);
+            } else {
+                cerr << "Unknown engine " << name << endl;
+                return 1;
+            }
+        } else if (arg == "--depth" && hasValue) {
+            config.depth = std::max(2, std::atoi(argv[++i]));
+        } else if (arg == "--block-mb" && hasValue) {
+            config.blockBytes = static_cast<size_t>(std::max(1, std::atoi(argv[++i]))) << 20;
+        } else if (arg == "--block-kb" && hasValue) {
+            config.blockBytes = static_cast<size_t>(std::max(4, std::atoi(argv[++i]))) << 10;
+        } else if (arg == "--direct") {
+            config.direct = true;
+        } else if (arg == "--cold") {
+            config.cold = true;
+        } else if (config.path.empty() && !arg.empty() && arg[0] != '-') {
+            config.path = arg;
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (config.path.empty()) {
+        printUsage();
+        return 1;
+    }
+    if (config.engines.empty()) {
+        config.engines = {ReadEngine::Sync, ReadEngine::Threads, ReadEngine::IoUring};
+    }
+
+    cout << std::left << std::setw(13) << "Engine" << std::right << std::setw(6) << "Depth" << std::setw(12)
+         << "Time (ms)" << std::setw(9) << "GB/s" << std::setw(13) << "I/O wait (%)" << std::setw(12) << "Minimum HP"
+         << endl;
+    cout << string(65, '-') << endl;
+    string error;
+    StreamRun disk;
+    StreamRun kernel;
+    if (!readOnly(config, disk, error) || !kernelOnly(config, kernel, error)) {
+        cerr << "Cannot stream " << error << endl;
+        return 1;
+    }
+    printRun("read only", std::to_string(config.depth), disk, false);
+    printRun("kernel only", "-", kernel, false);
+
+    int status = 0;
+    int answer = 0;
+    for (size_t e = 0; e < config.engines.size(); e++) {
+        StreamRun run;
+        if (!solve(config, config.engines[e], run, error)) {
+            cerr << "Cannot stream " << error << endl;
+            return 1;
+        }
+        bool sync = config.engines[e] == ReadEngine::Sync;
+        printRun(readEngineName(config.engines[e]), sync ? "1" : std::to_string(config.depth), run, true);
+        if (e > 0 && run.answer != answer) {
+            cerr << "Engines disagree on the answer" << endl;
+            status = 1;
+        }
+        answer = run.answer;
+    }
+    cout << std::fixed << std::setprecision(1) << "read + kernel = " << (disk.seconds + kernel.seconds) * 1e3
+         << " ms, larger of the two = " << std::max(disk.seconds, kernel.seconds) * 1e3 << " ms" << endl;
+    cout.unsetf(std::ios::fixed);
+    return status;
+}
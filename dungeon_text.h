@@ -0,0 +1,506 @@
+#ifndef DUNGEON_GAME_DUNGEON_TEXT_H
+#define DUNGEON_GAME_DUNGEON_TEXT_H
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "dungeon_grid.h"
+#include "dungeon_file.h"
+
+/**
+ * Text dungeons: one row per line, top row first, integers separated by
+ * commas, spaces or tabs, so CSV and whitespace dumps both load. CRLF line
+ * ends, a missing final newline and trailing blank lines are accepted.
+ *
+ * Loading makes two passes over the mapped text, both across threads:
+ *
+ *   scan   split the text into chunks that end on a newline and count the
+ *          lines in each with memchr; the values on the first line give
+ *          cols, and the running line counts give each chunk its first row
+ *   parse  threads take chunks in turn and parse them straight into their
+ *          rows of the destination, checking every row has cols values
+ *
+ * Parsing classifies 64 bytes at a time with SSE2 compares into bitmasks
+ * of number starts, newlines and stray bytes, then converts each number
+ * with a SWAR multiply (swarDigits) instead of a loop over its digits; see
+ * parseTextChunk.
+ * The destination is any rows * cols buffer: a DungeonGrid's cells, or the
+ * page-aligned cells of a .dgrid file being written (convertDungeonText),
+ * so each value is stored once and never copied. Errors name the line
+ * (1-based) and what was wrong with it.
+ */
+
+// Bytes of a [begin, end) slice of the text and the rows in it
+struct TextChunk {
+    size_t begin = 0;
+    size_t end = 0;
+    size_t firstRow = 0;
+    size_t rows = 0;
+};
+
+struct TextGridLayout {
+    int rows = 0;
+    int cols = 0;
+    std::vector<TextChunk> chunks;
+    std::string error;  // empty if the text can be parsed with this layout
+};
+
+enum class TextRowStatus {
+    Ok,
+    BadNumber,   // a token that is not an optionally signed integer
+    OutOfRange,  // does not fit in int
+    TooMany      // more values than the row has room for
+};
+
+inline bool isTextSeparator(char c) {
+    return c == ' ' || c == ',' || c == '\t' || c == '\r';
+}
+
+// Index of the lowest set bit; value must not be 0
+inline int lowestBit(uint64_t value) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(value);
+#else
+    int bit = 0;
+    while (!(value & 1)) {
+        value >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// Leading decimal digits of the 8 bytes at p: their count, and their value
+// in `value`. A byte-by-byte loop mispredicts on every 1-, 2- or 3-digit
+// number; this has no data-dependent branch. A count of 8 means the run
+// may go on
+inline int swarDigits(const char* p, uint64_t& value) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    uint64_t x = word ^ 0x3030303030303030ull;  // digits become 0..9
+    // High bit set in every byte that is not a digit; a carry out of a
+    // non-digit only reaches the bytes after it
+    uint64_t nonDigit = ((x + 0x7676767676767676ull) | x) & 0x8080808080808080ull;
+    int count = nonDigit ? lowestBit(nonDigit) / 8 : 8;
+    // Right-align the digits behind zeros, then combine pairs, quads and
+    // the two halves with three multiplies
+    uint64_t v = count ? x << (8 * (8 - count)) : 0;
+    v = v * 10 + (v >> 8);
+    v = (((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+         (((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+    value = v & 0xffffffffu;
+    return count;
+}
+
+// Parses the line starting at p into out, at most `capacity` values; p is
+// left on the line's '\n' (or at end) and count holds the values stored
+inline TextRowStatus parseTextRow(const char*& p, const char* end, int* out, int capacity, int& count) {
+    count = 0;
+    while (true) {
+        while (p < end && isTextSeparator(*p)) {
+            p++;
+        }
+        if (p == end || *p == '\n') {
+            return TextRowStatus::Ok;
+        }
+
+        bool negative = *p == '-';
+        if (negative || *p == '+') {
+            p++;
+        }
+        const char* digits = p;
+        uint64_t value = 0;
+        if (end - p >= 8) {
+            p += swarDigits(p, value);
+        }
+        // The tail of the text, and runs of 8 digits or more
+        while (p < end && static_cast<unsigned char>(*p - '0') < 10) {
+            value = value * 10 + static_cast<unsigned>(*p - '0');
+            p++;
+        }
+        if (p == digits || (p < end && *p != '\n' && !isTextSeparator(*p))) {
+            return TextRowStatus::BadNumber;
+        }
+        // Eleven digits can already overflow value's range check below
+        if (p - digits > 10 || value > (negative ? 2147483648ull : 2147483647ull)) {
+            return TextRowStatus::OutOfRange;
+        }
+        if (count == capacity) {
+            return TextRowStatus::TooMany;
+        }
+        out[count++] = negative ? static_cast<int>(-static_cast<int64_t>(value)) : static_cast<int>(value);
+    }
+}
+
+// One bit per byte of a 64-byte block of text
+struct TextBlockMasks {
+    uint64_t digit = 0;
+    uint64_t sign = 0;     // '-' or '+'
+    uint64_t minus = 0;
+    uint64_t newline = 0;
+    uint64_t bad = 0;      // none of those and not a separator
+};
+
+inline TextBlockMasks classifyTextBlock(const char* p) {
+    TextBlockMasks masks;
+    uint64_t separator = 0;
+#if defined(__SSE2__)
+    for (int k = 0; k < 4; k++) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k));
+        __m128i d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+        __m128i digit = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+        __m128i minus = _mm_cmpeq_epi8(c, _mm_set1_epi8('-'));
+        __m128i sign = _mm_or_si128(minus, _mm_cmpeq_epi8(c, _mm_set1_epi8('+')));
+        __m128i space = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(' ')),
+                                                  _mm_cmpeq_epi8(c, _mm_set1_epi8(','))),
+                                     _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('\t')),
+                                                  _mm_cmpeq_epi8(c, _mm_set1_epi8('\r'))));
+        __m128i newline = _mm_cmpeq_epi8(c, _mm_set1_epi8('\n'));
+        int shift = 16 * k;
+        masks.digit |= static_cast<uint64_t>(_mm_movemask_epi8(digit) & 0xffff) << shift;
+        masks.sign |= static_cast<uint64_t>(_mm_movemask_epi8(sign) & 0xffff) << shift;
+        masks.minus |= static_cast<uint64_t>(_mm_movemask_epi8(minus) & 0xffff) << shift;
+        masks.newline |= static_cast<uint64_t>(_mm_movemask_epi8(newline) & 0xffff) << shift;
+        separator |= static_cast<uint64_t>(_mm_movemask_epi8(space) & 0xffff) << shift;
+    }
+#else
+    for (int b = 0; b < 64; b++) {
+        char c = p[b];
+        uint64_t bit = uint64_t(1) << b;
+        if (static_cast<unsigned char>(c - '0') < 10) masks.digit |= bit;
+        else if (c == '-') masks.minus |= bit;
+        else if (c == '\n') masks.newline |= bit;
+        else if (isTextSeparator(c)) separator |= bit;
+        if (c == '-' || c == '+') masks.sign |= bit;
+    }
+#endif
+    masks.bad = ~(masks.digit | masks.sign | masks.newline | separator);
+    return masks;
+}
+
+/**
+ * Parses the rows of one chunk into cells
+ *
+ * Each 64-byte block is classified at once (SSE2 where available) into
+ * bitmasks, and the bits where a number starts, a line ends or something
+ * is malformed are then visited in order. Where each number starts is
+ * known before any is converted, so the conversions (swarDigits) do not
+ * wait on one another the way they do when a byte loop finds each
+ * number's end before it can look for the next one. Malformed is found in
+ * the masks too: a stray byte, a sign inside a number or a sign without a
+ * digit after it. Only numbers of 8 digits or more, the only ones that
+ * can overflow, are checked one by one.
+ *
+ * Returns false at the first row that is not `cols` integers, with the row
+ * and the start of its line in badRow / badLine; parseTextRow then says
+ * what is wrong with it.
+ */
+inline bool parseTextChunk(const char* data, const TextChunk& chunk, int* cells, int cols,
+                           size_t& badRow, const char*& badLine) {
+    const char* p = data + chunk.begin;
+    const char* end = data + chunk.end;
+    const char* line = p;
+    size_t row = chunk.firstRow;
+    int* out = cells + row * cols;
+    int* rowEnd = out + cols;
+    uint64_t carry = 0;  // 1 if the byte before this block was part of a number
+    bool failed = false;
+    // Reads run up to 12 bytes past the start of the last number in a
+    // block, so the end of the chunk is parsed from a space-padded copy
+    const size_t slack = 16;
+    char tail[64 + slack];
+
+    while (p < end && !failed) {
+        const char* block = p;
+        size_t available = static_cast<size_t>(end - p);
+        if (available < 64 + slack) {
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, p, available);
+            block = tail;
+        }
+        TextBlockMasks masks = classifyTextBlock(block);
+        uint64_t token = masks.digit | masks.sign;
+        uint64_t starts = token & ~((token << 1) | carry);
+        carry = token >> 63;
+        // Malformed numbers show in the masks: a sign inside a number, or
+        // one not followed by a digit. They and stray bytes fail the row
+        // they are on, so they are events too
+        uint64_t digitNext = (masks.digit >> 1) |
+                             (static_cast<uint64_t>(static_cast<unsigned char>(block[64] - '0') < 10) << 63);
+        uint64_t malformed = masks.bad | (masks.sign & ~starts) | (masks.sign & ~digitNext);
+
+        for (uint64_t pending = starts | masks.newline | malformed; pending != 0; pending &= pending - 1) {
+            int b = lowestBit(pending);
+            uint64_t bit = uint64_t(1) << b;
+            if ((masks.newline | malformed) & bit) {
+                if ((malformed & bit) || out != rowEnd) {
+                    failed = true;
+                    break;
+                }
+                row++;
+                rowEnd += cols;
+                line = p + b + 1;
+                continue;
+            }
+            uint64_t negative = (masks.minus >> b) & 1;
+            const char* digits = block + b + ((masks.sign >> b) & 1);
+            uint64_t value = 0;
+            int count = swarDigits(digits, value);
+            if (count == 8) {
+                // 8 digits or more, the only numbers that can be out of
+                // range; 11 are, whatever the digits
+                while (count <= 10 && static_cast<unsigned char>(digits[count] - '0') < 10) {
+                    value = value * 10 + static_cast<unsigned>(digits[count++] - '0');
+                }
+                if (value > 2147483647ull + negative || count > 10) {
+                    failed = true;
+                    break;
+                }
+            }
+            if (out == rowEnd) {
+                failed = true;
+                break;
+            }
+            *out++ = static_cast<int>((value ^ (0 - negative)) + negative);
+        }
+        p += 64;
+    }
+    // The last line of the text may have no newline
+    if (!failed && out != rowEnd - cols) {
+        failed = out != rowEnd;
+    }
+    if (failed) {
+        badRow = row;
+        badLine = line;
+    }
+    return !failed;
+}
+
+// What is wrong with the line at p, which parseTextChunk rejected: the
+// slow parser again, this time for the reason
+inline std::string describeTextRowProblem(const char* p, const char* end, int cols) {
+    std::vector<int> values(cols);
+    int count = 0;
+    switch (parseTextRow(p, end, &values[0], cols, count)) {
+        case TextRowStatus::BadNumber:  return "not an integer";
+        case TextRowStatus::OutOfRange: return "value out of int range";
+        case TextRowStatus::TooMany:    return "more than " + std::to_string(cols) + " values";
+        default: return std::to_string(count) + " values, expected " + std::to_string(cols);
+    }
+}
+
+inline int textThreads(int threads) {
+    if (threads > 0) {
+        return threads;
+    }
+    unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? static_cast<int>(hardware) : 1;
+}
+
+// Runs work(chunkIndex) for every chunk on `threads` threads, each taking
+// the next unclaimed chunk
+template<typename Work>
+void forEachTextChunk(size_t chunks, int threads, Work work) {
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t c = next++; c < chunks; c = next++) {
+            work(c);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < std::min<int>(threads, static_cast<int>(chunks)); t++) {
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+inline TextGridLayout scanDungeonText(const char* data, size_t size, int threads = 0) {
+    TextGridLayout layout;
+    threads = textThreads(threads);
+
+    // Trailing blank lines and whitespace are not rows
+    while (size > 0 && (data[size - 1] == '\n' || isTextSeparator(data[size - 1]))) {
+        size--;
+    }
+    if (size == 0) {
+        return layout;
+    }
+
+    // Several chunks per thread, so one slow chunk does not hold up the
+    // rest; none smaller than 1 MB, where thread start-up would dominate
+    const size_t minChunk = 1 << 20;
+    size_t target = std::max<size_t>(1, std::min<size_t>(static_cast<size_t>(threads) * 4, size / minChunk));
+    size_t begin = 0;
+    for (size_t c = 1; c <= target && begin < size; c++) {
+        size_t end = size;
+        if (c < target) {
+            size_t cut = std::max(begin, size / target * c);
+            const void* newline = std::memchr(data + cut, '\n', size - cut);
+            end = newline ? static_cast<const char*>(newline) - data + 1 : size;
+        }
+        TextChunk chunk;
+        chunk.begin = begin;
+        chunk.end = end;
+        layout.chunks.push_back(chunk);
+        begin = end;
+    }
+
+    forEachTextChunk(layout.chunks.size(), threads, [&](size_t c) {
+        TextChunk& chunk = layout.chunks[c];
+        const char* p = data + chunk.begin;
+        const char* end = data + chunk.end;
+        size_t lines = 0;
+        while (const void* newline = std::memchr(p, '\n', end - p)) {
+            lines++;
+            p = static_cast<const char*>(newline) + 1;
+        }
+        // Only the last chunk can end in a line without its newline
+        chunk.rows = lines + (p < end ? 1 : 0);
+    });
+
+    size_t rows = 0;
+    for (TextChunk& chunk : layout.chunks) {
+        chunk.firstRow = rows;
+        rows += chunk.rows;
+    }
+
+    const char* firstLine = data;
+    const void* newline = std::memchr(data, '\n', size);
+    const char* firstEnd = newline ? static_cast<const char*>(newline) : data + size;
+    std::vector<int> values((firstEnd - firstLine) / 2 + 1);
+    int cols = 0;
+    TextRowStatus status = parseTextRow(firstLine, firstEnd, &values[0], static_cast<int>(values.size()), cols);
+    if (status != TextRowStatus::Ok) {
+        layout.error = "line 1: " + describeTextRowProblem(data, firstEnd, static_cast<int>(values.size()));
+        return layout;
+    }
+    if (cols == 0) {
+        layout.error = "line 1: no row of integers";
+        return layout;
+    }
+    if (rows > static_cast<size_t>(INT_MAX)) {
+        layout.error = "more rows than int can count";
+        return layout;
+    }
+    layout.rows = static_cast<int>(rows);
+    layout.cols = cols;
+    return layout;
+}
+
+// Parses the text described by layout into cells (layout.rows * layout.cols
+// ints); false with the first bad line in error otherwise
+inline bool parseDungeonText(const char* data, const TextGridLayout& layout, int* cells,
+                             std::string* error = nullptr, int threads = 0) {
+    if (!layout.error.empty()) {
+        if (error) *error = layout.error;
+        return false;
+    }
+    const size_t noError = SIZE_MAX;
+    std::vector<size_t> badRow(layout.chunks.size(), noError);
+    std::vector<std::string> problems(layout.chunks.size());
+
+    forEachTextChunk(layout.chunks.size(), textThreads(threads), [&](size_t c) {
+        const TextChunk& chunk = layout.chunks[c];
+        const char* line = nullptr;
+        if (parseTextChunk(data, chunk, cells, layout.cols, badRow[c], line)) {
+            return;
+        }
+        problems[c] = describeTextRowProblem(line, data + chunk.end, layout.cols);
+    });
+
+    // Chunks are in file order, so the first failing one has the first bad line
+    for (size_t c = 0; c < badRow.size(); c++) {
+        if (badRow[c] != noError) {
+            if (error) *error = "line " + std::to_string(badRow[c] + 1) + ": " + problems[c];
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool parseDungeonText(const char* data, size_t size, DungeonGrid& grid,
+                             std::string* error = nullptr, int threads = 0) {
+    TextGridLayout layout = scanDungeonText(data, size, threads);
+    grid = DungeonGrid(layout.rows, layout.cols);
+    if (grid.empty()) {
+        if (error) *error = layout.error;
+        return layout.error.empty();
+    }
+    return parseDungeonText(data, layout, &grid.cells[0], error, threads);
+}
+
+inline bool loadDungeonText(const std::string& path, DungeonGrid& grid,
+                            std::string* error = nullptr, int threads = 0) {
+    FileMapping text;
+    if (!text.openRead(path)) {
+        if (error) *error = text.error();
+        return false;
+    }
+    if (!parseDungeonText(text.data(), text.size(), grid, error, threads)) {
+        if (error) *error = path + ": " + *error;
+        return false;
+    }
+    return true;
+}
+
+// Parses a text dungeon straight into the cells of a new .dgrid file
+inline bool convertDungeonText(const std::string& textPath, const std::string& gridPath,
+                               std::string* error = nullptr, int threads = 0) {
+    FileMapping text;
+    if (!text.openRead(textPath)) {
+        if (error) *error = text.error();
+        return false;
+    }
+    TextGridLayout layout = scanDungeonText(text.data(), text.size(), threads);
+    if (!layout.error.empty()) {
+        if (error) *error = textPath + ": " + layout.error;
+        return false;
+    }
+    MappedDungeonFile grid;
+    if (!grid.create(gridPath, makeDungeonFileHeader(layout.rows, layout.cols))) {
+        if (error) *error = grid.error();
+        return false;
+    }
+    if (!parseDungeonText(text.data(), layout, grid.data(), error, threads)) {
+        if (error) *error = textPath + ": " + *error;
+        return false;
+    }
+    return true;
+}
+
+// Appends one row as space-separated integers and a newline
+inline void appendDungeonTextRow(std::string& out, const int* row, int cols) {
+    char digits[12];
+    for (int j = 0; j < cols; j++) {
+        int64_t value = row[j];
+        if (value < 0) {
+            out += '-';
+            value = -value;
+        }
+        int length = 0;
+        do {
+            digits[length++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        while (length > 0) {
+            out += digits[--length];
+        }
+        out += j + 1 < cols ? ' ' : '\n';
+    }
+}
+
+#endif // DUNGEON_GAME_DUNGEON_TEXT_H
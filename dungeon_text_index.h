@@ -0,0 +1,377 @@
+#ifndef DUNGEON_GAME_DUNGEON_TEXT_INDEX_H
+#define DUNGEON_GAME_DUNGEON_TEXT_INDEX_H
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#include "dungeon_text.h"
+
+/**
+ * Row-offset index of a text dungeon (.drows sidecar)
+ *
+ *   [0, 64)      TextRowIndexHeader
+ *   [64, ...)    uint64 byte offsets of rows 0, k, 2k ..., then the end of
+ *                the last row
+ *
+ * Text lists rows top to bottom, and the O(cols) kernels take them bottom
+ * up. With the offset of every k-th row, ReverseTextRowReader reads the
+ * text backwards in blocks of whole k-row groups, one large pread each,
+ * and parses a block only when the kernel reaches it. k trades the size of
+ * the index (8 bytes per k rows) against the smallest block. textBytes is
+ * the size of the text indexed; the index of a text since grown or cut is
+ * stale and is rebuilt.
+ */
+struct TextRowIndexHeader {
+    char magic[8];        // "DROWS\0\0\0"
+    uint32_t version;
+    uint32_t byteOrder;   // kDungeonFileByteOrder as written
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t stride;      // k, rows per entry
+    uint64_t textBytes;
+    uint64_t reserved[2];
+};
+
+const uint32_t kTextRowIndexVersion = 1;
+
+struct TextRowIndex {
+    int rows = 0;
+    int cols = 0;
+    int stride = 1;
+    uint64_t textBytes = 0;
+    std::vector<uint64_t> offsets;  // of rows 0, stride, 2 * stride ..., then the end
+
+    size_t groups() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+};
+
+inline std::string textRowIndexPath(const std::string& textPath) {
+    return textPath + ".drows";
+}
+
+// Size of the file at path, or false if it cannot be opened
+inline bool textFileBytes(const std::string& path, uint64_t& bytes) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    bool sized = std::fseek(file, 0, SEEK_END) == 0;
+    long end = sized ? std::ftell(file) : -1;
+    std::fclose(file);
+    bytes = static_cast<uint64_t>(end);
+    return end >= 0;
+}
+
+// Maps the text, scans it (dungeon_text.h) and records where every
+// stride-th row starts, the chunks walked in parallel
+inline bool buildTextRowIndex(const std::string& textPath, int stride, TextRowIndex& index,
+                              std::string* error = nullptr, int threads = 0) {
+    FileMapping text;
+    if (!text.openRead(textPath)) {
+        if (error) *error = text.error();
+        return false;
+    }
+    TextGridLayout layout = scanDungeonText(text.data(), text.size(), threads);
+    if (!layout.error.empty()) {
+        if (error) *error = textPath + ": " + layout.error;
+        return false;
+    }
+    index.rows = layout.rows;
+    index.cols = layout.cols;
+    index.stride = std::max(1, stride);
+    index.textBytes = text.size();
+    size_t groups = (static_cast<size_t>(layout.rows) + index.stride - 1) / index.stride;
+    index.offsets.assign(groups + 1, 0);
+    index.offsets[groups] = layout.chunks.empty() ? 0 : layout.chunks.back().end;
+
+    const char* data = text.data();
+    forEachTextChunk(layout.chunks.size(), textThreads(threads), [&](size_t c) {
+        const TextChunk& chunk = layout.chunks[c];
+        const char* p = data + chunk.begin;
+        for (size_t row = chunk.firstRow; row < chunk.firstRow + chunk.rows; row++) {
+            if (row % index.stride == 0) {
+                index.offsets[row / index.stride] = static_cast<uint64_t>(p - data);
+            }
+            const void* newline = std::memchr(p, '\n', data + chunk.end - p);
+            p = newline ? static_cast<const char*>(newline) + 1 : data + chunk.end;
+        }
+    });
+    return true;
+}
+
+inline bool writeTextRowIndex(const std::string& path, const TextRowIndex& index, std::string* error = nullptr) {
+    TextRowIndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "DROWS", 5);
+    header.version = kTextRowIndexVersion;
+    header.byteOrder = kDungeonFileByteOrder;
+    header.rows = static_cast<uint64_t>(index.rows);
+    header.cols = static_cast<uint64_t>(index.cols);
+    header.stride = static_cast<uint64_t>(index.stride);
+    header.textBytes = index.textBytes;
+
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) {
+        if (error) *error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    bool written = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+                   std::fwrite(index.offsets.data(), sizeof(uint64_t), index.offsets.size(), out) == index.offsets.size();
+    if (std::fclose(out) != 0 || !written) {
+        if (error) *error = path + ": write failed";
+        return false;
+    }
+    return true;
+}
+
+// Whether the offsets can be read as blocks: one per stride rows plus the
+// end, starting at 0, never decreasing and inside the text. The reader
+// subtracts neighbouring offsets, so anything else would underflow
+inline bool textRowIndexConsistent(const TextRowIndex& index) {
+    if (index.rows < 0 || index.stride < 1 ||
+        index.offsets.size() != (static_cast<size_t>(index.rows) + index.stride - 1) / index.stride + 1) {
+        return false;
+    }
+    return index.offsets[0] == 0 && std::is_sorted(index.offsets.begin(), index.offsets.end()) &&
+           index.offsets.back() <= index.textBytes;
+}
+
+// Whether the open sidecar is exactly the header plus the offsets it declares
+inline bool textIndexFileFits(std::FILE* in, const TextRowIndexHeader& header) {
+    uint64_t entries = (header.rows + header.stride - 1) / header.stride + 1;
+    if (std::fseek(in, 0, SEEK_END) != 0) {
+        return false;
+    }
+    long end = std::ftell(in);
+    if (end < 0 || std::fseek(in, sizeof(header), SEEK_SET) != 0) {
+        return false;
+    }
+    return static_cast<uint64_t>(end) == sizeof(header) + entries * sizeof(uint64_t);
+}
+
+inline bool readTextRowIndex(const std::string& path, TextRowIndex& index, std::string* error = nullptr) {
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (!in) {
+        if (error) *error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    TextRowIndexHeader header;
+    std::string problem;
+    if (std::fread(&header, sizeof(header), 1, in) != 1 || std::memcmp(header.magic, "DROWS\0\0\0", 8) != 0) {
+        problem = "not a row index";
+    } else if (header.byteOrder != kDungeonFileByteOrder || header.version != kTextRowIndexVersion) {
+        problem = "unsupported row index version or byte order";
+    } else if (header.rows > static_cast<uint64_t>(INT_MAX) || header.cols > static_cast<uint64_t>(INT_MAX) ||
+               header.stride == 0 || header.stride > static_cast<uint64_t>(INT_MAX)) {
+        problem = "row index dimensions exceed int";
+    } else if (!textIndexFileFits(in, header)) {
+        // Checked before sizing offsets, so a corrupt row count cannot
+        // make us allocate more than the file holds
+        problem = "row index is truncated or corrupt";
+    } else {
+        index.rows = static_cast<int>(header.rows);
+        index.cols = static_cast<int>(header.cols);
+        index.stride = static_cast<int>(header.stride);
+        index.textBytes = header.textBytes;
+        index.offsets.resize((header.rows + header.stride - 1) / header.stride + 1);
+        if (std::fread(&index.offsets[0], sizeof(uint64_t), index.offsets.size(), in) != index.offsets.size() ||
+            !textRowIndexConsistent(index)) {
+            problem = "row index is truncated or corrupt";
+        }
+    }
+    std::fclose(in);
+    if (!problem.empty()) {
+        if (error) *error = path + ": " + problem;
+        return false;
+    }
+    return true;
+}
+
+// The sidecar of textPath if it is there and indexes the text as it is
+// now, else a new index (written beside the text when that is possible)
+inline bool openTextRowIndex(const std::string& textPath, int stride, TextRowIndex& index, bool& built,
+                             std::string* error = nullptr, int threads = 0) {
+    uint64_t bytes = 0;
+    built = false;
+    if (readTextRowIndex(textRowIndexPath(textPath), index) && textFileBytes(textPath, bytes) &&
+        bytes == index.textBytes) {
+        return true;
+    }
+    if (!buildTextRowIndex(textPath, stride, index, error, threads)) {
+        return false;
+    }
+    built = true;
+    writeTextRowIndex(textRowIndexPath(textPath), index);  // a read-only directory only costs the rebuild
+    return true;
+}
+
+/**
+ * Rows of a text dungeon, read bottom up through its row index
+ *
+ *     DungeonKernels::streaming(reader.rows(), reader.cols(),
+ *                               [&reader](int i) { return reader.row(i); })
+ *
+ * solves a text larger than RAM without converting it. row(i) parses the
+ * block holding row i when i is outside the current one: as many k-row
+ * groups ending at row i as fit in blockBytes (always at least one), read
+ * with one pread. Memory is that block and its cells, whatever the rows.
+ *
+ * Reading and parsing happen inside row(), which the kernels cannot fail
+ * from; a block that cannot be read or parsed, or does not hold the rows
+ * the index promised, reads as zeros, and failed() / error() say so after
+ * the solve. Needs POSIX pread, like FileMapping needs mmap.
+ */
+class ReverseTextRowReader {
+private:
+    TextRowIndex index;
+    int fd = -1;
+    size_t blockBytes = 0;
+    std::vector<char> text;
+    std::vector<int> cells;
+    std::vector<int> zeros;
+    int blockBegin = 0;  // rows [blockBegin, blockEnd) are in cells
+    int blockEnd = 0;
+    uint64_t readBytes = 0;
+    std::string lastError;
+
+    bool fail(const std::string& reason) {
+        if (lastError.empty()) {
+            lastError = reason;
+        }
+        return false;
+    }
+
+    bool readText(uint64_t offset, size_t bytes) {
+        text.resize(bytes);
+#if defined(DUNGEON_FILE_MMAP)
+        size_t done = 0;
+        while (done < bytes) {
+            ssize_t got = pread(fd, &text[done], bytes - done, static_cast<off_t>(offset + done));
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got <= 0) {
+                return fail(got < 0 ? std::strerror(errno) : "text is shorter than its row index");
+            }
+            done += static_cast<size_t>(got);
+        }
+        readBytes += bytes;
+        return true;
+#else
+        (void)offset;
+        return fail("reading text blocks needs POSIX pread");
+#endif
+    }
+
+    bool loadBlock(int row) {
+        size_t stride = static_cast<size_t>(index.stride);
+        size_t last = static_cast<size_t>(row) / stride;
+        size_t first = last;
+        while (first > 0 && index.offsets[last + 1] - index.offsets[first - 1] <= blockBytes) {
+            first--;
+        }
+        blockBegin = static_cast<int>(first * stride);
+        blockEnd = static_cast<int>(std::min<size_t>(index.rows, (last + 1) * stride));
+        size_t bytes = static_cast<size_t>(index.offsets[last + 1] - index.offsets[first]);
+        if (!readText(index.offsets[first], bytes)) {
+            return false;
+        }
+
+        // The rows must be the ones the index says before any is stored
+        size_t lines = 0;
+        const char* p = text.data();
+        const char* end = p + bytes;
+        while (const void* newline = std::memchr(p, '\n', end - p)) {
+            lines++;
+            p = static_cast<const char*>(newline) + 1;
+        }
+        lines += p < end ? 1 : 0;
+        size_t rows = static_cast<size_t>(blockEnd - blockBegin);
+        if (lines != rows) {
+            return fail("row index is stale: rows " + std::to_string(blockBegin + 1) + ".." +
+                        std::to_string(blockEnd) + " are " + std::to_string(lines) + " lines");
+        }
+
+        cells.resize(rows * index.cols);
+        TextChunk chunk;
+        chunk.end = bytes;
+        chunk.rows = rows;
+        size_t badRow = 0;
+        const char* badLine = nullptr;
+        if (!parseTextChunk(text.data(), chunk, &cells[0], index.cols, badRow, badLine)) {
+            return fail("line " + std::to_string(blockBegin + badRow + 1) + ": " +
+                        describeTextRowProblem(badLine, end, index.cols));
+        }
+        return true;
+    }
+
+public:
+    ReverseTextRowReader() {}
+    ~ReverseTextRowReader() { close(); }
+
+    ReverseTextRowReader(const ReverseTextRowReader&) = delete;
+    ReverseTextRowReader& operator=(const ReverseTextRowReader&) = delete;
+
+    bool open(const std::string& textPath, const TextRowIndex& rowIndex, size_t blockBytes = 8 << 20) {
+        close();
+        uint64_t bytes = 0;
+        if (!textFileBytes(textPath, bytes)) {
+            return fail(textPath + ": " + std::strerror(errno));
+        }
+        if (!textRowIndexConsistent(rowIndex)) {
+            return fail(textPath + ": row index is corrupt");
+        }
+        if (bytes != rowIndex.textBytes) {
+            return fail(textPath + ": row index is stale");
+        }
+#if defined(DUNGEON_FILE_MMAP)
+        fd = ::open(textPath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return fail(textPath + ": " + std::strerror(errno));
+        }
+#else
+        return fail(textPath + ": reading text blocks needs POSIX pread");
+#endif
+        index = rowIndex;
+        this->blockBytes = blockBytes;
+        zeros.assign(index.cols, 0);
+        return true;
+    }
+
+    void close() {
+#if defined(DUNGEON_FILE_MMAP)
+        if (fd >= 0) {
+            ::close(fd);
+        }
+#endif
+        fd = -1;
+        blockBegin = blockEnd = 0;
+        readBytes = 0;
+        lastError.clear();
+    }
+
+    int rows() const { return index.rows; }
+    int cols() const { return index.cols; }
+
+    const int* row(int i) {
+        if ((i < blockBegin || i >= blockEnd) && (failed() || !loadBlock(i))) {
+            blockBegin = blockEnd = 0;
+            return zeros.data();
+        }
+        return &cells[static_cast<size_t>(i - blockBegin) * index.cols];
+    }
+
+    bool failed() const { return !lastError.empty(); }
+    const std::string& error() const { return lastError; }
+    uint64_t bytesRead() const { return readBytes; }
+    // Block and cell buffers at their largest so far
+    size_t bufferBytes() const { return text.capacity() + cells.capacity() * sizeof(int); }
+};
+
+#endif // DUNGEON_GAME_DUNGEON_TEXT_INDEX_H
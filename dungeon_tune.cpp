@@ -0,0 +1,43 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "auto_tuner.h"
+
+using std::cout;
+using std::endl;
+using std::string;
+
+// Tuning mode: search tile size, thread count and lane width for this CPU
+// and store them in the profile file that AdaptiveDungeonSolver::loadTuning
+// reads at startup.
+//
+//   dungeon_tune [profile path] [max threads]
+int main(int argc, char** argv) {
+    string path = argc > 1 ? argv[1] : "dungeon_tuning.profile";
+    int maxThreads = argc > 2 ? std::atoi(argv[2]) : 0;
+
+    AutoTuner tuner(maxThreads);
+    cout << "Tuning for: " << cpuModelName() << endl;
+
+    TuningProfile profile = tuner.tune();
+
+    cout << "| Class  | Tile (rows x cols) | Threads | Lanes |" << endl;
+    cout << "|--------|--------------------|---------|-------|" << endl;
+    for (int k = 0; k < TuningProfile::kClasses; k++) {
+        const TunedConfig& config = profile.classes[k];
+        string tile = std::to_string(config.tileRows) + " x " + std::to_string(config.tileCols);
+        cout << "| " << sizeClassName(static_cast<SizeClass>(k));
+        cout << string(7 - string(sizeClassName(static_cast<SizeClass>(k))).size(), ' ');
+        cout << "| " << tile << string(19 - tile.size(), ' ');
+        cout << "| " << config.threads << string(8 - std::to_string(config.threads).size(), ' ');
+        cout << "| " << (config.int16Lanes ? "int16" : "int32") << " |" << endl;
+    }
+
+    if (!AutoTuner::saveProfile(path, profile)) {
+        std::cerr << "Cannot write " << path << endl;
+        return 1;
+    }
+    cout << "Profile saved to " << path << endl;
+    return 0;
+}
@@ -0,0 +1,161 @@
+#ifndef DUNGEON_GAME_FORWARD_SWEEP_H
+#define DUNGEON_GAME_FORWARD_SWEEP_H
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// How a forward solver answers "can the knight reach the princess starting
+// with H health?" inside its binary search
+enum class FeasibilityBackend {
+    Sweep,      // ForwardHealthSweep: one vectorized forward DP per probe
+    Traversal   // the solver's own graph traversal (BFS, DFS, Dijkstra, ...)
+};
+
+/**
+ * Forward max-health feasibility sweep over anti-diagonals
+ *
+ * Moves only go right or down, so the grid is a DAG and the best health
+ * on entering (i, j) is simply
+ *
+ *     best(i, j) = max(best(i-1, j), best(i, j-1)) + dungeon[i][j]
+ *
+ * with cells whose best health is <= 0 treated as dead. Every cell on an
+ * anti-diagonal i + j = d depends only on diagonal d - 1, so a whole
+ * diagonal is computed with independent lanes. The dungeon is copied once
+ * into diagonal-major order; each probe then streams through it with two
+ * row-indexed buffers where the top and left neighbours of row i are the
+ * adjacent entries prev[i] and prev[i + 1].
+ *
+ * Health is saturated at kHealthCap and dead cells hold kDead, so the
+ * int32 lanes cannot overflow as long as |dungeon[i][j]| < 2^30.
+ */
+class ForwardHealthSweep {
+public:
+    static const int kDead = -(1 << 30);
+    static const int kHealthCap = 1 << 30;
+
+private:
+    int rows_ = 0;
+    int cols_ = 0;
+    std::vector<int> diagValues_;     // cells in diagonal-major order
+    std::vector<size_t> diagOffset_;  // start of each diagonal in diagValues_
+    std::vector<int> scratch_;        // buffers for the single-threaded probe
+
+public:
+    // Copy the dungeon into diagonal-major layout; done once per solve
+    void load(const std::vector<std::vector<int>>& dungeon) {
+        rows_ = dungeon.size();
+        cols_ = dungeon[0].size();
+        int diagonals = rows_ + cols_ - 1;
+
+        diagValues_.resize(static_cast<size_t>(rows_) * cols_);
+        diagOffset_.resize(diagonals);
+
+        size_t offset = 0;
+        for (int d = 0; d < diagonals; d++) {
+            diagOffset_[d] = offset;
+            for (int i = firstRow(d); i <= lastRow(d); i++) {
+                diagValues_[offset++] = dungeon[i][d - i];
+            }
+        }
+    }
+
+    // Two diagonal buffers of rows + 1 entries each (slot 0 is padding)
+    size_t scratchSize() const {
+        return 2 * (static_cast<size_t>(rows_) + 1);
+    }
+
+    bool canReach(int startHealth) {
+        return canReach(startHealth, scratch_);
+    }
+
+    // Thread-safe for concurrent probes as long as each uses its own scratch
+    bool canReach(int startHealth, std::vector<int>& scratch) const {
+        scratch.assign(scratchSize(), static_cast<int>(kDead));
+        int* prev = &scratch[0];
+        int* cur = prev + rows_ + 1;
+
+        // Diagonal 0 is the starting cell
+        long long first = static_cast<long long>(startHealth) + diagValues_[0];
+        if (first <= 0) {
+            return false;
+        }
+        prev[1] = static_cast<int>(std::min<long long>(first, kHealthCap));
+
+        int diagonals = rows_ + cols_ - 1;
+        for (int d = 1; d < diagonals; d++) {
+            int lo = firstRow(d);
+            int hi = lastRow(d);
+            const int* values = &diagValues_[diagOffset_[d]] - lo;
+
+            if (!sweepDiagonal(prev, cur, values, lo, hi)) {
+                return false;  // every cell on this diagonal is dead
+            }
+
+            std::swap(prev, cur);
+        }
+
+        return prev[rows_] > 0;
+    }
+
+private:
+    int firstRow(int d) const {
+        return std::max(0, d - cols_ + 1);
+    }
+
+    int lastRow(int d) const {
+        return std::min(d, rows_ - 1);
+    }
+
+    // Compute cur[i + 1] for rows lo..hi of one diagonal; returns false if
+    // no cell on it is alive
+    static bool sweepDiagonal(const int* prev, int* cur, const int* values,
+                              int lo, int hi) {
+        int i = lo;
+        int alive = kDead;
+
+#if defined(__AVX2__)
+        const __m256i dead = _mm256_set1_epi32(kDead);
+        const __m256i cap = _mm256_set1_epi32(kHealthCap);
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i aliveLanes = dead;
+
+        for (; i + 8 <= hi + 1; i += 8) {
+            __m256i top = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + i));
+            __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + i + 1));
+            __m256i cell = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+
+            __m256i health = _mm256_add_epi32(_mm256_max_epi32(top, left), cell);
+            health = _mm256_min_epi32(health, cap);
+            health = _mm256_blendv_epi8(dead, health, _mm256_cmpgt_epi32(health, zero));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(cur + i + 1), health);
+            aliveLanes = _mm256_max_epi32(aliveLanes, health);
+        }
+
+        int lanes[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), aliveLanes);
+        for (int lane = 0; lane < 8; lane++) {
+            alive = std::max(alive, lanes[lane]);
+        }
+#endif
+
+        // Branch-free scalar form; compilers auto-vectorize it for SSE/NEON
+        for (; i <= hi; i++) {
+            int health = std::max(prev[i], prev[i + 1]) + values[i];
+            health = std::min(health, static_cast<int>(kHealthCap));
+            health = health > 0 ? health : static_cast<int>(kDead);
+            cur[i + 1] = health;
+            alive = std::max(alive, health);
+        }
+
+        return alive > 0;
+    }
+};
+
+#endif // DUNGEON_GAME_FORWARD_SWEEP_H
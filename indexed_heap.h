@@ -0,0 +1,223 @@
+#ifndef DUNGEON_GAME_INDEXED_HEAP_H
+#define DUNGEON_GAME_INDEXED_HEAP_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "solver_workspace.h"
+
+/**
+ * Indexed d-ary min-heap keyed by flat cell index (row * cols + col)
+ *
+ * Unlike std::priority_queue, every cell appears in the heap at most once:
+ * improving a cell's key moves the existing entry up (decrease-key) instead
+ * of pushing a duplicate that is later discarded. Queue memory is therefore
+ * bounded by the number of cells.
+ *
+ * Storage is three flat arrays:
+ *   heap_[k]  - cell id stored in heap slot k
+ *   pos_[id]  - heap slot of cell id, or -1 if the cell is not queued
+ *   keys_[id] - current key of cell id
+ *
+ * Arity 4 keeps the tree shallow and puts all children of a slot in the
+ * same cache line, which is what matters on large grids.
+ *
+ * The arrays are the heap's own, or come from a Workspace (reset with a
+ * workspace) and are valid until the caller's Workspace::Frame closes.
+ */
+template<typename Key, int Arity = 4>
+class IndexedDaryHeap {
+private:
+    int* heap_ = nullptr;
+    int* pos_ = nullptr;
+    Key* keys_ = nullptr;
+    int count_ = 0;
+    std::vector<int> heapStore_;
+    std::vector<int> posStore_;
+    std::vector<Key> keyStore_;
+
+public:
+    explicit IndexedDaryHeap(int capacity = 0) {
+        reset(capacity);
+    }
+
+    IndexedDaryHeap(int capacity, Workspace& workspace) {
+        reset(capacity, workspace);
+    }
+
+    IndexedDaryHeap(const IndexedDaryHeap&) = delete;
+    IndexedDaryHeap& operator=(const IndexedDaryHeap&) = delete;
+
+    // Empty the heap and size it for cell ids in [0, capacity)
+    void reset(int capacity) {
+        heapStore_.resize(capacity);
+        posStore_.assign(capacity, -1);
+        keyStore_.resize(capacity);
+        heap_ = heapStore_.data();
+        pos_ = posStore_.data();
+        keys_ = keyStore_.data();
+        count_ = 0;
+    }
+
+    // Same, with the arrays taken from the workspace; Key must be trivial
+    void reset(int capacity, Workspace& workspace) {
+        heap_ = workspace.allocate<int>(capacity);
+        pos_ = workspace.allocate<int>(capacity, -1);
+        keys_ = workspace.allocate<Key>(capacity);
+        count_ = 0;
+    }
+
+    bool empty() const { return count_ == 0; }
+    size_t size() const { return count_; }
+    bool contains(int id) const { return pos_[id] >= 0; }
+    const Key& key(int id) const { return keys_[id]; }
+
+    int top() const { return heap_[0]; }
+    const Key& topKey() const { return keys_[heap_[0]]; }
+
+    // Insert a cell that is not currently queued
+    void push(int id, const Key& key) {
+        keys_[id] = key;
+        pos_[id] = count_;
+        heap_[count_++] = id;
+        siftUp(pos_[id]);
+    }
+
+    // Lower the key of a queued cell; larger keys are ignored
+    void decreaseKey(int id, const Key& key) {
+        if (!(key < keys_[id])) {
+            return;
+        }
+        keys_[id] = key;
+        siftUp(pos_[id]);
+    }
+
+    // Insert the cell, or lower its key if it is already queued
+    void pushOrDecrease(int id, const Key& key) {
+        if (contains(id)) {
+            decreaseKey(id, key);
+        } else {
+            push(id, key);
+        }
+    }
+
+    // Remove and return the cell with the smallest key
+    int pop() {
+        int id = heap_[0];
+        int last = heap_[--count_];
+        pos_[id] = -1;
+
+        if (count_ > 0) {
+            heap_[0] = last;
+            pos_[last] = 0;
+            siftDown(0);
+        }
+        return id;
+    }
+
+private:
+    void siftUp(int slot) {
+        int id = heap_[slot];
+        const Key key = keys_[id];
+
+        while (slot > 0) {
+            int parent = (slot - 1) / Arity;
+            int parentId = heap_[parent];
+            if (!(key < keys_[parentId])) {
+                break;
+            }
+            heap_[slot] = parentId;
+            pos_[parentId] = slot;
+            slot = parent;
+        }
+
+        heap_[slot] = id;
+        pos_[id] = slot;
+    }
+
+    void siftDown(int slot) {
+        int count = count_;
+        int id = heap_[slot];
+        const Key key = keys_[id];
+
+        while (true) {
+            int first = slot * Arity + 1;
+            if (first >= count) {
+                break;
+            }
+
+            // Pick the smallest of up to Arity children
+            int last = first + Arity < count ? first + Arity : count;
+            int best = first;
+            for (int child = first + 1; child < last; child++) {
+                if (keys_[heap_[child]] < keys_[heap_[best]]) {
+                    best = child;
+                }
+            }
+
+            if (!(keys_[heap_[best]] < key)) {
+                break;
+            }
+            heap_[slot] = heap_[best];
+            pos_[heap_[slot]] = slot;
+            slot = best;
+        }
+
+        heap_[slot] = id;
+        pos_[id] = slot;
+    }
+};
+
+/**
+ * Flat bitset over cell ids, used as the closed set of graph searches
+ *
+ * One bit per cell in contiguous 64-bit words instead of the
+ * vector<vector<bool>> row-of-rows layout. Like IndexedDaryHeap, the words
+ * are the set's own or come from a Workspace.
+ */
+class FlatBitset {
+private:
+    uint64_t* words_ = nullptr;
+    std::vector<uint64_t> wordStore_;
+
+    static size_t wordsFor(int bits) {
+        return (static_cast<size_t>(bits) + 63) / 64;
+    }
+
+public:
+    explicit FlatBitset(int bits = 0) {
+        reset(bits);
+    }
+
+    FlatBitset(int bits, Workspace& workspace) {
+        reset(bits, workspace);
+    }
+
+    FlatBitset(const FlatBitset&) = delete;
+    FlatBitset& operator=(const FlatBitset&) = delete;
+
+    // Clear all bits and size the set for ids in [0, bits)
+    void reset(int bits) {
+        wordStore_.assign(wordsFor(bits), 0);
+        words_ = wordStore_.data();
+    }
+
+    void reset(int bits, Workspace& workspace) {
+        words_ = workspace.allocate<uint64_t>(wordsFor(bits), 0);
+    }
+
+    bool test(int id) const {
+        return (words_[id >> 6] >> (id & 63)) & 1;
+    }
+
+    void set(int id) {
+        words_[id >> 6] |= uint64_t(1) << (id & 63);
+    }
+
+    void clear(int id) {
+        words_[id >> 6] &= ~(uint64_t(1) << (id & 63));
+    }
+};
+
+#endif // DUNGEON_GAME_INDEXED_HEAP_H
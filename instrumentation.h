@@ -0,0 +1,178 @@
+#ifndef DUNGEON_GAME_INSTRUMENTATION_H
+#define DUNGEON_GAME_INSTRUMENTATION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+// Counters a solver reports through its instrumentation policy
+struct ProbeTotals {
+    uint64_t calls = 0;
+    uint64_t memoHits = 0;
+    uint64_t boundaryChecks = 0;
+    uint64_t sampledCalls = 0;  // calls whose duration was measured
+    uint64_t sampledNs = 0;     // inclusive time of the sampled calls
+
+    // Mean inclusive time per call, from the sampled calls only
+    double nsPerCall() const {
+        return sampledCalls > 0 ? static_cast<double>(sampledNs) / sampledCalls : 0;
+    }
+};
+
+/**
+ * Instrumentation policy that does nothing
+ *
+ * Tally and CallScope are empty types with empty inline members, so a
+ * solver instantiated with this policy compiles to the same code as one
+ * without any hooks.
+ */
+struct NoInstrumentation {
+    static const bool enabled = false;
+
+    class Tally {
+    public:
+        explicit Tally(NoInstrumentation&) {}
+        void onMemoHit() {}
+        void onBoundaryCheck() {}
+    };
+
+    class CallScope {
+    public:
+        explicit CallScope(Tally&) {}
+    };
+
+    void reset() {}
+    ProbeTotals totals() const { return ProbeTotals(); }
+};
+
+/**
+ * Instrumentation policy with thread-sharded counters
+ *
+ * A solve counts into a Tally on its own stack: plain increments that the
+ * compiler can keep in registers. When the Tally goes out of scope it adds
+ * its counts to the calling thread's shard with one relaxed fetch_add per
+ * counter. Shards are 64-byte aligned, so threads never write the same
+ * cache line and never take a lock. totals() merges the shards and may run
+ * while solves are in flight (it sees every finished solve); reset() must
+ * not.
+ *
+ * With SampleEvery > 0 (a power of two), every SampleEvery-th call of a
+ * solve is timed with steady_clock, so the clock is read twice per
+ * SampleEvery calls instead of twice per call. SampleEvery = 0 counts only.
+ */
+template<unsigned SampleEvery = 0>
+class CountingInstrumentation {
+    static_assert((SampleEvery & (SampleEvery - 1)) == 0,
+                  "SampleEvery must be 0 or a power of two");
+
+public:
+    static const bool enabled = true;
+    static const size_t kShards = 64;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> calls;
+        std::atomic<uint64_t> memoHits;
+        std::atomic<uint64_t> boundaryChecks;
+        std::atomic<uint64_t> sampledCalls;
+        std::atomic<uint64_t> sampledNs;
+    };
+
+    // Process-wide slot for the calling thread; threads beyond kShards
+    // share shards, which fetch_add keeps exact
+    static size_t threadSlot() {
+        static std::atomic<size_t> nextSlot(0);
+        static thread_local size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    Shard shards[kShards];
+
+public:
+    CountingInstrumentation() { reset(); }
+
+    CountingInstrumentation(const CountingInstrumentation&) = delete;
+    CountingInstrumentation& operator=(const CountingInstrumentation&) = delete;
+
+    // Counters of one solve, published to the thread's shard on destruction
+    class Tally {
+    private:
+        CountingInstrumentation& owner;
+
+    public:
+        ProbeTotals counts;
+
+        explicit Tally(CountingInstrumentation& owner) : owner(owner) {}
+
+        ~Tally() {
+            Shard& shard = owner.shards[threadSlot() % kShards];
+            shard.calls.fetch_add(counts.calls, std::memory_order_relaxed);
+            shard.memoHits.fetch_add(counts.memoHits, std::memory_order_relaxed);
+            shard.boundaryChecks.fetch_add(counts.boundaryChecks, std::memory_order_relaxed);
+            shard.sampledCalls.fetch_add(counts.sampledCalls, std::memory_order_relaxed);
+            shard.sampledNs.fetch_add(counts.sampledNs, std::memory_order_relaxed);
+        }
+
+        Tally(const Tally&) = delete;
+        Tally& operator=(const Tally&) = delete;
+
+        void onMemoHit() { counts.memoHits++; }
+        void onBoundaryCheck() { counts.boundaryChecks++; }
+    };
+
+    // Counts one call and, when sampled, times it until the scope ends
+    class CallScope {
+    private:
+        Tally& tally;
+        bool sampled;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit CallScope(Tally& tally)
+            : tally(tally),
+              sampled(SampleEvery > 0 && (tally.counts.calls & (SampleEvery - 1)) == 0),
+              start() {
+            tally.counts.calls++;
+            if (sampled) {
+                start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~CallScope() {
+            if (sampled) {
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                tally.counts.sampledCalls++;
+                tally.counts.sampledNs += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            }
+        }
+
+        CallScope(const CallScope&) = delete;
+        CallScope& operator=(const CallScope&) = delete;
+    };
+
+    void reset() {
+        for (auto& shard : shards) {
+            shard.calls.store(0, std::memory_order_relaxed);
+            shard.memoHits.store(0, std::memory_order_relaxed);
+            shard.boundaryChecks.store(0, std::memory_order_relaxed);
+            shard.sampledCalls.store(0, std::memory_order_relaxed);
+            shard.sampledNs.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ProbeTotals totals() const {
+        ProbeTotals sum;
+        for (const auto& shard : shards) {
+            sum.calls += shard.calls.load(std::memory_order_relaxed);
+            sum.memoHits += shard.memoHits.load(std::memory_order_relaxed);
+            sum.boundaryChecks += shard.boundaryChecks.load(std::memory_order_relaxed);
+            sum.sampledCalls += shard.sampledCalls.load(std::memory_order_relaxed);
+            sum.sampledNs += shard.sampledNs.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+};
+
+#endif // DUNGEON_GAME_INSTRUMENTATION_H
@@ -0,0 +1,45 @@
+#ifndef DUNGEON_GAME_KERNEL_TIMING_H
+#define DUNGEON_GAME_KERNEL_TIMING_H
+
+#include <chrono>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+
+#include "dungeon_grid.h"
+
+// Best of `trials` runs, each repeating work() for at least minNs; used by
+// the calibration and tuning code, where the minimum is the least noisy
+// estimate of what a kernel costs
+template<typename Work>
+double bestTimeNs(Work work, double minNs = 2e6, int trials = 3) {
+    double best = std::numeric_limits<double>::max();
+    for (int trial = 0; trial < trials; trial++) {
+        int repeats = 0;
+        double elapsed = 0;
+        auto start = std::chrono::steady_clock::now();
+        do {
+            work();
+            repeats++;
+            elapsed = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - start).count();
+        } while (elapsed < minNs);
+        best = std::min(best, elapsed / repeats);
+    }
+    return best;
+}
+
+// Same distribution as generateRandomDungeon (values in [low, high]), but
+// seeded and independent of rand() so calibration runs are repeatable
+inline DungeonGrid syntheticGrid(int rows, int cols, uint32_t seed, int low = -10, int high = 10) {
+    DungeonGrid grid(rows, cols);
+    uint32_t state = seed * 2654435761u + 1;
+    uint32_t span = static_cast<uint32_t>(high - low + 1);
+    for (int& value : grid.cells) {
+        state = state * 1664525u + 1013904223u;
+        value = low + static_cast<int>((state >> 16) % span);
+    }
+    return grid;
+}
+
+#endif // DUNGEON_GAME_KERNEL_TIMING_H
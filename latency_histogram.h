@@ -0,0 +1,159 @@
+#ifndef DUNGEON_GAME_LATENCY_HISTOGRAM_H
+#define DUNGEON_GAME_LATENCY_HISTOGRAM_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * HDR-style log-linear histogram of latencies in nanoseconds
+ *
+ * Each power of two is split into kSubBuckets linear buckets, so any value
+ * is stored with a relative error below 1 / kSubBuckets (about 3%) from
+ * 1 ns up to 2^40 ns (18 minutes) in a fixed 1152-slot array; larger
+ * values land in the last bucket. Values below kSubBuckets are exact.
+ *
+ * This is the plain snapshot type: recording into it is not thread-safe.
+ * SolveMetrics records into per-thread atomic copies of the same layout
+ * and merges them into a LatencyHistogram when it is read.
+ */
+class LatencyHistogram {
+public:
+    static const int kSubBits = 5;
+    static const uint64_t kSubBuckets = 1u << kSubBits;
+    static const int kMaxExponent = 39;  // values up to 2^40 - 1
+    static const size_t kBuckets = (kMaxExponent - kSubBits + 2) * kSubBuckets;
+
+    // Slot of a value: exact below kSubBuckets, then kSubBuckets slots per octave
+    static size_t bucketOf(uint64_t ns) {
+        if (ns < kSubBuckets) {
+            return static_cast<size_t>(ns);
+        }
+        int exponent = highestBit(ns);
+        if (exponent > kMaxExponent) {
+            return kBuckets - 1;
+        }
+        uint64_t sub = (ns >> (exponent - kSubBits)) & (kSubBuckets - 1);
+        return static_cast<size_t>((exponent - kSubBits + 1) * kSubBuckets + sub);
+    }
+
+    // Smallest value that maps to the slot
+    static uint64_t bucketLow(size_t bucket) {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        int exponent = static_cast<int>(bucket / kSubBuckets) + kSubBits - 1;
+        uint64_t sub = bucket % kSubBuckets;
+        return (kSubBuckets + sub) << (exponent - kSubBits);
+    }
+
+    // Largest value that maps to the slot
+    static uint64_t bucketHigh(size_t bucket) {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        int exponent = static_cast<int>(bucket / kSubBuckets) + kSubBits - 1;
+        return bucketLow(bucket) + (uint64_t(1) << (exponent - kSubBits)) - 1;
+    }
+
+private:
+    static int highestBit(uint64_t value) {
+#if defined(__GNUC__)
+        return 63 - __builtin_clzll(value);
+#else
+        int bit = 0;
+        while (value >>= 1) bit++;
+        return bit;
+#endif
+    }
+
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t sumNs = 0;
+    uint64_t maxNs = 0;
+
+public:
+    LatencyHistogram() : counts(kBuckets, 0) {}
+
+    void record(uint64_t ns) {
+        counts[bucketOf(ns)]++;
+        total++;
+        sumNs += ns;
+        maxNs = std::max(maxNs, ns);
+    }
+
+    // Coordinated-omission correction for a closed-loop client that meant
+    // to issue a request every expectedIntervalNs: a stall of ns also hid
+    // the requests that would have been sent during it, so record those
+    // too, with latencies ns - interval, ns - 2 * interval, ... >= interval
+    // (HdrHistogram's recordValueWithExpectedInterval)
+    void recordWithExpectedInterval(uint64_t ns, uint64_t expectedIntervalNs) {
+        record(ns);
+        if (expectedIntervalNs == 0 || ns <= expectedIntervalNs) {
+            return;
+        }
+        for (uint64_t missing = ns - expectedIntervalNs; missing >= expectedIntervalNs;
+             missing -= expectedIntervalNs) {
+            record(missing);
+        }
+    }
+
+    // Adds a raw slot count, e.g. from an atomic per-thread copy
+    void addBucket(size_t bucket, uint64_t count) {
+        counts[bucket] += count;
+        total += count;
+    }
+
+    void addSum(uint64_t ns) { sumNs += ns; }
+    void addMax(uint64_t ns) { maxNs = std::max(maxNs, ns); }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t b = 0; b < kBuckets; b++) {
+            counts[b] += other.counts[b];
+        }
+        total += other.total;
+        sumNs += other.sumNs;
+        maxNs = std::max(maxNs, other.maxNs);
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t sum() const { return sumNs; }
+    uint64_t max() const { return maxNs; }
+    uint64_t bucketCount(size_t bucket) const { return counts[bucket]; }
+
+    double mean() const {
+        return total > 0 ? static_cast<double>(sumNs) / total : 0;
+    }
+
+    // Value at quantile q in [0, 1]: the upper edge of the slot holding the
+    // ceil(q * count)-th value, capped at the largest value recorded
+    uint64_t percentile(double q) const {
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(q * total + 0.999999);
+        rank = std::max<uint64_t>(1, std::min(rank, total));
+        uint64_t seen = 0;
+        for (size_t b = 0; b < kBuckets; b++) {
+            seen += counts[b];
+            if (seen >= rank) {
+                return std::min(bucketHigh(b), maxNs);
+            }
+        }
+        return maxNs;
+    }
+
+    // Values <= ns, for cumulative export buckets; exact when ns is a slot's
+    // upper edge, otherwise counts the slot holding ns in full
+    uint64_t countAtOrBelow(uint64_t ns) const {
+        size_t last = bucketOf(ns);
+        uint64_t seen = 0;
+        for (size_t b = 0; b <= last; b++) {
+            seen += counts[b];
+        }
+        return seen;
+    }
+};
+
+#endif // DUNGEON_GAME_LATENCY_HISTOGRAM_H
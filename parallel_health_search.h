@@ -0,0 +1,198 @@
+#ifndef DUNGEON_GAME_PARALLEL_HEALTH_SEARCH_H
+#define DUNGEON_GAME_PARALLEL_HEALTH_SEARCH_H
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "span_trace.h"
+#include "forward_sweep.h"
+
+/**
+ * Speculative k-ary search for the minimum feasible starting health
+ *
+ * The forward solvers binary-search the starting health with one
+ * feasibility probe per step (~20 sequential O(m×n) probes for the range
+ * [1, 1000000]). Here each round probes `lanes` evenly spaced candidates at
+ * once, one per thread, and keeps the sub-interval between the largest
+ * failing and the smallest passing candidate. The interval shrinks by a
+ * factor of lanes + 1 per round, so latency drops to about
+ * log2(range) / log2(lanes + 1) probe times.
+ *
+ * probe(lane, health) must be monotone in health and safe to call
+ * concurrently for distinct lanes (each lane gets its own scratch state).
+ * Like the sequential binary search, `right` is assumed feasible.
+ *
+ * Under an active SpanTracer each round and each probe is a span (probe
+ * value = candidate health), so slow lanes show up on the timeline.
+ */
+template<typename Probe>
+int parallelMinimumHealth(int left, int right, int lanes, Probe probe) {
+    if (lanes < 1) {
+        lanes = 1;
+    }
+
+    std::vector<int> candidates;
+    std::vector<char> feasible;
+    std::vector<std::thread> workers;
+    int round = 0;
+
+    while (left < right) {
+        SpanScope roundSpan(SpanKind::SearchRound, cellRange(0, 0, 0, 0), round++,
+                            static_cast<long long>(right) - left);
+
+        // Evenly spaced candidates strictly inside [left, right)
+        candidates.clear();
+        long long span = static_cast<long long>(right) - left;
+        for (int i = 1; i <= lanes; i++) {
+            int candidate = left + static_cast<int>(span * i / (lanes + 1));
+            if (candidates.empty() || candidate > candidates.back()) {
+                candidates.push_back(candidate);
+            }
+        }
+
+        int count = candidates.size();
+        feasible.assign(count, 0);
+
+        // Lane 0 runs on the calling thread
+        workers.clear();
+        for (int lane = 1; lane < count; lane++) {
+            workers.push_back(std::thread([&, lane]() {
+                SpanScope probeSpan(SpanKind::Probe, cellRange(0, 0, 0, 0), lane, candidates[lane]);
+                feasible[lane] = probe(lane, candidates[lane]);
+            }));
+        }
+        {
+            SpanScope probeSpan(SpanKind::Probe, cellRange(0, 0, 0, 0), 0, candidates[0]);
+            feasible[0] = probe(0, candidates[0]);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        // Probes are monotone: narrow to (last failure, first success]
+        int nextLeft = left, nextRight = right;
+        for (int lane = 0; lane < count; lane++) {
+            if (feasible[lane]) {
+                nextRight = candidates[lane];
+                break;
+            }
+            nextLeft = candidates[lane] + 1;
+        }
+
+        left = nextLeft;
+        right = nextRight;
+    }
+
+    return left;
+}
+
+/**
+ * Binary search for the minimum feasible starting health, one probe per step
+ *
+ * probe(health) must be monotone in health; `right` is assumed feasible.
+ * Spans are recorded as in parallelMinimumHealth: a round per step, and a
+ * lane-0 probe inside it.
+ */
+template<typename Probe>
+int sequentialMinimumHealth(int left, int right, Probe probe) {
+    int round = 0;
+    while (left < right) {
+        SpanScope roundSpan(SpanKind::SearchRound, cellRange(0, 0, 0, 0), round++,
+                            static_cast<long long>(right) - left);
+        int mid = left + (right - left) / 2;
+        bool feasible;
+        {
+            SpanScope probeSpan(SpanKind::Probe, cellRange(0, 0, 0, 0), 0, mid);
+            feasible = probe(mid);
+        }
+
+        if (feasible) {
+            right = mid;
+        } else {
+            left = mid + 1;
+        }
+    }
+    return left;
+}
+
+// Default lane count: one probe per hardware thread
+inline int defaultSearchLanes() {
+    unsigned int threads = std::thread::hardware_concurrency();
+    return threads > 0 ? static_cast<int>(threads) : 1;
+}
+
+// Per-lane scratch for traversals that keep none between probes
+struct NoLaneScratch {};
+
+/**
+ * Starting-health search of a forward solver (BFS, DFS, Dijkstra, A*,
+ * Bellman-Ford)
+ *
+ * Owns the probe plumbing those solvers share: the FeasibilityBackend
+ * choice, the ForwardHealthSweep, and one scratch object per lane, all
+ * recycled across probes and calls (lane 0 serves the binary search). A
+ * solver supplies only its traversal, traverse(health, LaneScratch&),
+ * which is used under FeasibilityBackend::Traversal and must be safe to
+ * call concurrently for distinct scratch objects.
+ *
+ * Both searches cover starting health [1, 1000000].
+ */
+template<typename LaneScratch = NoLaneScratch>
+class ForwardHealthSearch {
+private:
+    FeasibilityBackend backend;
+    ForwardHealthSweep sweep;
+    std::vector<std::vector<int>> sweepScratch;
+    std::vector<LaneScratch> laneScratch;
+
+    void prepare(const std::vector<std::vector<int>>& dungeon, int lanes) {
+        if (backend == FeasibilityBackend::Sweep) {
+            sweep.load(dungeon);
+            sweepScratch.resize(lanes);
+        } else {
+            laneScratch.resize(lanes);
+        }
+    }
+
+    template<typename Traverse>
+    bool probe(int health, int lane, const Traverse& traverse) {
+        if (backend == FeasibilityBackend::Sweep) {
+            return sweep.canReach(health, sweepScratch[lane]);
+        }
+        return traverse(health, laneScratch[lane]);
+    }
+
+public:
+    explicit ForwardHealthSearch(FeasibilityBackend backend = FeasibilityBackend::Sweep)
+        : backend(backend) {}
+
+    // Binary search, one probe per step
+    template<typename Traverse>
+    int minimumHealth(const std::vector<std::vector<int>>& dungeon, const Traverse& traverse) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+        prepare(dungeon, 1);
+
+        return sequentialMinimumHealth(1, 1000000, [&](int health) {
+            return probe(health, 0, traverse);
+        });
+    }
+
+    // Same answer, probing `lanes` candidates per round on separate threads
+    template<typename Traverse>
+    int minimumHealthParallel(const std::vector<std::vector<int>>& dungeon, int lanes,
+                              const Traverse& traverse) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+        prepare(dungeon, std::max(lanes, 1));
+
+        return parallelMinimumHealth(1, 1000000, lanes, [&](int lane, int health) {
+            return probe(health, lane, traverse);
+        });
+    }
+};
+
+#endif // DUNGEON_GAME_PARALLEL_HEALTH_SEARCH_H
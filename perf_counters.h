@@ -0,0 +1,273 @@
+#ifndef DUNGEON_GAME_PERF_COUNTERS_H
+#define DUNGEON_GAME_PERF_COUNTERS_H
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+// Events read around a solver call
+enum class PerfEvent {
+    Cycles,
+    Instructions,
+    BranchMisses,
+    L1DMisses,    // L1 data cache read misses
+    LLCMisses,    // last-level cache read misses
+    DTLBMisses,   // data TLB read misses
+    TaskClockNs,  // software: CPU time of the measured threads
+    PageFaults,   // software
+    Count
+};
+
+inline const char* perfEventName(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::Cycles:       return "cycles";
+        case PerfEvent::Instructions: return "instructions";
+        case PerfEvent::BranchMisses: return "branch-misses";
+        case PerfEvent::L1DMisses:    return "L1D-misses";
+        case PerfEvent::LLCMisses:    return "LLC-misses";
+        case PerfEvent::DTLBMisses:   return "dTLB-misses";
+        case PerfEvent::TaskClockNs:  return "task-clock-ns";
+        case PerfEvent::PageFaults:   return "page-faults";
+        default:                      return "unknown";
+    }
+}
+
+// Counter values for one measured region; `available` is false for events
+// the kernel or the (virtual) CPU refused to count
+struct PerfSample {
+    static const int kEvents = static_cast<int>(PerfEvent::Count);
+
+    double values[kEvents] = {};
+    bool available[kEvents] = {};
+
+    double value(PerfEvent event) const { return values[static_cast<int>(event)]; }
+    bool has(PerfEvent event) const { return available[static_cast<int>(event)]; }
+
+    PerfSample& operator+=(const PerfSample& other) {
+        for (int e = 0; e < kEvents; e++) {
+            values[e] += other.values[e];
+            available[e] = available[e] || other.available[e];
+        }
+        return *this;
+    }
+};
+
+/**
+ * perf_event_open counters for the calling thread and the threads it
+ * starts (user space only)
+ *
+ * Events are opened as groups that the PMU schedules together:
+ * {cycles, instructions, branch misses} and {L1D, LLC, dTLB misses}, plus
+ * the software {task clock, page faults} that work even without a PMU.
+ * Six events rarely fit the programmable counters at once; with groups the
+ * kernel multiplexes whole groups, so ratios within a group (IPC) stay
+ * exact, and counts are scaled by time_enabled / time_running.
+ *
+ * Events are inherited, so a multi-threaded solver's workers count too,
+ * as long as they start after the PerfCounters and exit before stop()
+ * (a thread's counts are added to the parent's when it exits). The kernel
+ * cannot read inherited events as a group, and a reset does not clear
+ * what exited threads added, so each event is read on its own and a
+ * sample is the difference between the reads at start() and stop().
+ *
+ * Events that fail to open (perf_event_paranoid > 2, no PMU in a VM,
+ * non-Linux) are reported unavailable rather than failing the run;
+ * unavailableReason() says why the first one failed.
+ */
+class PerfCounters {
+private:
+    static const int kEvents = PerfSample::kEvents;
+    static const int kGroups = 3;
+
+    // One read of an event: value, time_enabled, time_running
+    struct Reading {
+        uint64_t value = 0;
+        uint64_t enabled = 0;
+        uint64_t running = 0;
+    };
+
+    int fds[kEvents];
+    int leaders[kGroups];
+    Reading begin[kEvents];  // read at start()
+    std::string reason;
+
+public:
+    PerfCounters() {
+        for (int e = 0; e < kEvents; e++) {
+            fds[e] = -1;
+        }
+        for (int g = 0; g < kGroups; g++) leaders[g] = -1;
+
+#if defined(__linux__)
+        for (int e = 0; e < kEvents; e++) {
+            int group = groupOf(static_cast<PerfEvent>(e));
+            fds[e] = openEvent(static_cast<PerfEvent>(e), leaders[group]);
+            if (fds[e] >= 0 && leaders[group] < 0) {
+                leaders[group] = fds[e];
+            }
+        }
+#else
+        reason = "hardware counters need Linux perf_event_open";
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int e = 0; e < kEvents; e++) {
+            if (fds[e] >= 0) close(fds[e]);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // True if any hardware event could be opened
+    bool hardwareAvailable() const {
+        return leaders[0] >= 0 || leaders[1] >= 0;
+    }
+
+    const std::string& unavailableReason() const { return reason; }
+
+    void start() {
+#if defined(__linux__)
+        for (int leader : leaders) {
+            if (leader < 0) continue;
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+        for (int e = 0; e < kEvents; e++) {
+            readEvent(fds[e], begin[e]);
+        }
+#endif
+    }
+
+    PerfSample stop() {
+        PerfSample sample;
+#if defined(__linux__)
+        for (int leader : leaders) {
+            if (leader >= 0) ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        }
+        for (int e = 0; e < kEvents; e++) {
+            Reading end;
+            if (!readEvent(fds[e], end) || end.running <= begin[e].running) {
+                continue;  // never scheduled: nothing to scale
+            }
+            double scale = static_cast<double>(end.enabled - begin[e].enabled) / (end.running - begin[e].running);
+            sample.values[e] = (end.value - begin[e].value) * scale;
+            sample.available[e] = true;
+        }
+#endif
+        return sample;
+    }
+
+    // Counters around a single call of work()
+    template<typename Work>
+    PerfSample measure(Work work) {
+        start();
+        work();
+        return stop();
+    }
+
+private:
+    static int groupOf(PerfEvent event) {
+        switch (event) {
+            case PerfEvent::Cycles:
+            case PerfEvent::Instructions:
+            case PerfEvent::BranchMisses:
+                return 0;
+            case PerfEvent::TaskClockNs:
+            case PerfEvent::PageFaults:
+                return 2;
+            default:
+                return 1;
+        }
+    }
+
+#if defined(__linux__)
+    static uint64_t cacheConfig(uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+               (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    int openEvent(PerfEvent event, int groupFd) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = groupFd < 0 ? 1 : 0;  // members follow the leader
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        switch (event) {
+            case PerfEvent::Cycles:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case PerfEvent::Instructions:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case PerfEvent::BranchMisses:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+            case PerfEvent::L1DMisses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cacheConfig(PERF_COUNT_HW_CACHE_L1D);
+                break;
+            case PerfEvent::LLCMisses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cacheConfig(PERF_COUNT_HW_CACHE_LL);
+                break;
+            case PerfEvent::DTLBMisses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cacheConfig(PERF_COUNT_HW_CACHE_DTLB);
+                break;
+            case PerfEvent::TaskClockNs:
+                attr.type = PERF_TYPE_SOFTWARE;
+                attr.config = PERF_COUNT_SW_TASK_CLOCK;
+                break;
+            default:
+                attr.type = PERF_TYPE_SOFTWARE;
+                attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+                break;
+        }
+
+        long fd = syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+        if (fd < 0 && reason.empty()) {
+            reason = std::string(perfEventName(event)) + ": " + std::strerror(errno);
+            if (errno == EACCES || errno == EPERM) {
+                reason += " (check /proc/sys/kernel/perf_event_paranoid)";
+            } else if (errno == ENOENT || errno == ENODEV || errno == EOPNOTSUPP) {
+                reason += " (no hardware PMU exposed, e.g. in a VM)";
+            }
+        }
+        return static_cast<int>(fd);
+    }
+
+    static bool readEvent(int fd, Reading& reading) {
+        if (fd < 0) {
+            return false;
+        }
+        uint64_t buffer[3];
+        if (read(fd, buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer))) {
+            return false;
+        }
+        reading.value = buffer[0];
+        reading.enabled = buffer[1];
+        reading.running = buffer[2];
+        return true;
+    }
+#endif
+};
+
+#endif // DUNGEON_GAME_PERF_COUNTERS_H
@@ -0,0 +1,879 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <climits>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <cmath>
+
+#include "dungeon_grid.h"
+#include "dungeon_kernels.h"
+#include "kernel_timing.h"
+#include "perf_counters.h"
+#include "search_workspace.h"
+#include "forward_sweep.h"
+#include "parallel_health_search.h"
+#include "indexed_heap.h"
+#include "alloc_hooks.h"
+
+using std::vector;
+using std::pair;
+using std::priority_queue;
+using std::string;
+using std::max;
+using std::min;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+// Hardware counter profile of the solvers across grid sizes
+//
+//   perf_profile [--sizes N,N,...] [--solvers a,b,...] [--repeat R]
+//
+// Every solver runs R times per size under PerfCounters (perf_counters.h);
+// counts are reported per solve and per cell, plus IPC and miss rates, to
+// show where the graph solvers lose against the DP kernels: instructions per
+// cell, cache and TLB misses from pointer-chasing frontiers, or branch
+// misses in the probe loops.
+
+// Copied from dungeon_game_bfs.cpp
+class DungeonGameBFS {
+private:
+    vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
+    
+    ForwardHealthSearch<SearchWorkspace> search;
+    
+public:
+    explicit DungeonGameBFS(FeasibilityBackend backend = FeasibilityBackend::Sweep)
+        : search(backend) {}
+    
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        return search.minimumHealth(dungeon, [&](int health, SearchWorkspace& ws) {
+            return canReachPrincess(dungeon, health, ws);
+        });
+    }
+    
+    int calculateMinimumHPParallel(vector<vector<int>>& dungeon, int lanes = defaultSearchLanes()) {
+        return search.minimumHealthParallel(dungeon, lanes, [&](int health, SearchWorkspace& ws) {
+            return canReachPrincess(dungeon, health, ws);
+        });
+    }
+    
+private:
+    bool canReachPrincess(vector<vector<int>>& dungeon, int startHealth,
+                          SearchWorkspace& ws) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+        
+        // BFS to check if we can reach princess with given starting health
+        ws.beginProbe(rows * cols);
+        
+        ws.pushFrontier(0, startHealth);
+        
+        while (!ws.frontierEmpty()) {
+            PackedState current = ws.popFront();
+            
+            // A healthier copy of this cell was queued after this one
+            if (ws.isDominated(current.cell, current.health)) {
+                continue;
+            }
+            
+            int row = current.cell / cols;
+            int col = current.cell % cols;
+            
+            // Check current health after entering this cell
+            int currentHealth = current.health + dungeon[row][col];
+            
+            // Must have positive health
+            if (currentHealth <= 0) {
+                continue;
+            }
+            
+            // Reached princess
+            if (row == rows - 1 && col == cols - 1) {
+                return true;
+            }
+            
+            // Explore neighbors
+            for (auto& dir : directions) {
+                int newRow = row + dir.first;
+                int newCol = col + dir.second;
+                
+                if (newRow < rows && newCol < cols) {
+                    // Re-queue a cell whenever it is reached with more health;
+                    // first-arrival marking would drop a healthier later path
+                    uint32_t next = newRow * cols + newCol;
+                    if (ws.improveBest(next, currentHealth)) {
+                        ws.pushFrontier(next, currentHealth);
+                    }
+                }
+            }
+        }
+        
+        return false;
+    }
+};
+
+// Copied from dungeon_game_dijkstra.cpp
+class DungeonGameDijkstra {
+private:
+    vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
+    
+public:
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+        
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+        
+        // Dijkstra's algorithm to find minimum health needed
+        // We'll work backwards: find minimum health needed to reach princess from each cell
+        // Cells are addressed by flat index (row * cols + col) and queued at
+        // most once; a better label lowers the queued key in place
+        vector<int> minHealth(rows * cols, INT_MAX);
+        IndexedDaryHeap<int> pq(rows * cols);
+        
+        // Start from princess room - minimum health needed there
+        int princess = (rows - 1) * cols + (cols - 1);
+        int princessHealth = max(1, 1 - dungeon[rows-1][cols-1]);
+        minHealth[princess] = princessHealth;
+        pq.push(princess, princessHealth);
+        
+        // Reverse directions (left, up) since we're working backwards
+        vector<pair<int, int>> reverseDirections = {{0, -1}, {-1, 0}};
+        
+        while (!pq.empty()) {
+            int current = pq.pop();
+            
+            int row = current / cols;
+            int col = current % cols;
+            
+            // Explore neighbors (cells that can reach current cell)
+            for (auto& dir : reverseDirections) {
+                int newRow = row + dir.first;
+                int newCol = col + dir.second;
+                
+                // Check bounds
+                if (newRow < 0 || newCol < 0) {
+                    continue;
+                }
+                
+                int next = newRow * cols + newCol;
+                
+                // Calculate minimum health needed at (newRow, newCol) to reach princess
+                int healthNeeded = max(1, minHealth[current] - dungeon[newRow][newCol]);
+                
+                // If we found a better path to this cell
+                if (healthNeeded < minHealth[next]) {
+                    minHealth[next] = healthNeeded;
+                    
+                    // max(1, h - d) is not monotone in the path, so a cell already
+                    // popped can still get a better label; it is then queued again
+                    pq.pushOrDecrease(next, healthNeeded);
+                }
+            }
+        }
+        
+        return minHealth[0];
+    }
+};
+
+// Copied from dungeon_game_dfs.cpp
+class DungeonGameDFS {
+private:
+    vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
+    
+    ForwardHealthSearch<SearchWorkspace> search;
+    
+public:
+    explicit DungeonGameDFS(FeasibilityBackend backend = FeasibilityBackend::Sweep)
+        : search(backend) {}
+    
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        return search.minimumHealth(dungeon, [&](int health, SearchWorkspace& ws) {
+            return canReachPrincessDFS(dungeon, health, ws);
+        });
+    }
+    
+    int calculateMinimumHPParallel(vector<vector<int>>& dungeon, int lanes = defaultSearchLanes()) {
+        return search.minimumHealthParallel(dungeon, lanes, [&](int health, SearchWorkspace& ws) {
+            return canReachPrincessDFS(dungeon, health, ws);
+        });
+    }
+    
+private:
+    bool canReachPrincessDFS(vector<vector<int>>& dungeon, int startHealth,
+                             SearchWorkspace& ws) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+        
+        // DFS using stack to check if we can reach princess
+        ws.beginProbe(rows * cols);
+        
+        ws.pushFrontier(0, startHealth);
+        
+        while (!ws.frontierEmpty()) {
+            PackedState current = ws.popBack();
+            int row = current.cell / cols;
+            int col = current.cell % cols;
+            
+            // Check current health after entering this cell
+            int currentHealth = current.health + dungeon[row][col];
+            
+            // Must have positive health
+            if (currentHealth <= 0) {
+                continue;
+            }
+            
+            // Skip only if an earlier visit entered with at least as much
+            // health; first-visit marking would drop a healthier later path
+            if (!ws.improveBest(current.cell, currentHealth)) {
+                continue;
+            }
+            
+            // Reached princess
+            if (row == rows - 1 && col == cols - 1) {
+                return true;
+            }
+            
+            // Explore neighbors (add to stack in reverse order for consistent traversal)
+            for (int i = directions.size() - 1; i >= 0; i--) {
+                int newRow = row + directions[i].first;
+                int newCol = col + directions[i].second;
+                
+                if (newRow < rows && newCol < cols) {
+                    ws.pushFrontier(newRow * cols + newCol, currentHealth);
+                }
+            }
+        }
+        
+        return false;
+    }
+};
+
+// Copied from dungeon_game_astar.cpp
+class DungeonGameAStar {
+private:
+    vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
+    
+public:
+    // Scratch memory comes from `workspace` if given (solver_workspace.h),
+    // so repeated solves with a warm workspace do not allocate
+    int calculateMinimumHP(vector<vector<int>>& dungeon, Workspace* workspace = nullptr) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+        
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+        int cells = rows * cols;
+        
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        scratch.reserve(scratchBytes(cells));
+        
+        // A* working backwards from princess to start
+        // Cells are addressed by flat index (row * cols + col); each cell is
+        // queued at most once and improved in place via decrease-key
+        int* minHealth = scratch.allocate<int>(cells, INT_MAX);
+        FlatBitset closed(cells, scratch);
+        IndexedDaryHeap<double> open(cells, scratch);
+        
+        // Start from princess room
+        int princess = (rows - 1) * cols + (cols - 1);
+        int princessHealth = max(1, 1 - dungeon[rows-1][cols-1]);
+        minHealth[princess] = princessHealth;
+        
+        double heuristic = manhattanDistance(rows-1, cols-1, 0, 0);
+        open.push(princess, princessHealth + heuristic);
+        
+        // Reverse directions for backward search
+        const pair<int, int> reverseDirections[] = {{0, -1}, {-1, 0}};
+        
+        while (!open.empty()) {
+            int current = open.pop();
+            closed.set(current);
+            
+            int row = current / cols;
+            int col = current % cols;
+            
+            // Found the start position
+            if (current == 0) {
+                return minHealth[current];
+            }
+            
+            // Explore neighbors
+            for (auto& dir : reverseDirections) {
+                int newRow = row + dir.first;
+                int newCol = col + dir.second;
+                
+                if (newRow < 0 || newCol < 0) {
+                    continue;
+                }
+                
+                int next = newRow * cols + newCol;
+                if (closed.test(next)) {
+                    continue;
+                }
+                
+                // Calculate health needed at (newRow, newCol)
+                int healthNeeded = max(1, minHealth[current] - dungeon[newRow][newCol]);
+                
+                if (healthNeeded < minHealth[next]) {
+                    minHealth[next] = healthNeeded;
+                    
+                    // Calculate f-score = g-score + heuristic
+                    double h = manhattanDistance(newRow, newCol, 0, 0);
+                    open.pushOrDecrease(next, healthNeeded + h);
+                }
+            }
+        }
+        
+        return minHealth[0];
+    }
+    
+    // minHealth, the closed set and the heap's three arrays
+    static size_t scratchBytes(int cells) {
+        return 3 * Workspace::bytesFor<int>(cells) + Workspace::bytesFor<double>(cells) +
+               Workspace::bytesFor<uint64_t>((cells + 63) / 64);
+    }
+    
+private:
+    double manhattanDistance(int row1, int col1, int row2, int col2) {
+        return abs(row1 - row2) + abs(col1 - col2);
+    }
+};
+
+// Forward A* with binary search, copied from dungeon_game_astar.cpp
+class DungeonGameAStarForward {
+private:
+    struct ForwardState {
+        int row, col, health;
+        double fScore;
+        
+        ForwardState(int r, int c, int h, double f) 
+            : row(r), col(c), health(h), fScore(f) {}
+        
+        // For priority queue (min-heap based on f-score, but we want max health)
+        bool operator>(const ForwardState& other) const {
+            if (fScore != other.fScore) {
+                return fScore > other.fScore;
+            }
+            return health < other.health; // Prefer higher health for tie-breaking
+        }
+    };
+    
+    vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
+    
+    ForwardHealthSearch<NoLaneScratch> search;
+    
+public:
+    explicit DungeonGameAStarForward(FeasibilityBackend backend = FeasibilityBackend::Sweep)
+        : search(backend) {}
+    
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        return search.minimumHealth(dungeon, [&](int health, NoLaneScratch&) {
+            return canReachPrincess(dungeon, health);
+        });
+    }
+    
+    int calculateMinimumHPParallel(vector<vector<int>>& dungeon, int lanes = defaultSearchLanes()) {
+        return search.minimumHealthParallel(dungeon, lanes, [&](int health, NoLaneScratch&) {
+            return canReachPrincess(dungeon, health);
+        });
+    }
+    
+private:
+    bool canReachPrincess(vector<vector<int>>& dungeon, int startHealth) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+        
+        vector<vector<int>> maxHealthReached(rows, vector<int>(cols, -1));
+        vector<vector<bool>> visited(rows, vector<bool>(cols, false));
+        priority_queue<ForwardState, vector<ForwardState>, std::greater<ForwardState>> pq;
+        
+        int initialHealth = startHealth + dungeon[0][0];
+        if (initialHealth <= 0) return false;
+        
+        maxHealthReached[0][0] = initialHealth;
+        double heuristic = manhattanDistance(0, 0, rows-1, cols-1);
+        pq.push(ForwardState(0, 0, initialHealth, -initialHealth + heuristic));
+        
+        while (!pq.empty()) {
+            ForwardState current = pq.top();
+            pq.pop();
+            
+            // Skip if already visited or found better path
+            if (visited[current.row][current.col] || 
+                current.health < maxHealthReached[current.row][current.col]) {
+                continue;
+            }
+            visited[current.row][current.col] = true;
+            
+            // Reached princess
+            if (current.row == rows - 1 && current.col == cols - 1) {
+                return true;
+            }
+            
+            // Explore neighbors
+            for (auto& dir : directions) {
+                int newRow = current.row + dir.first;
+                int newCol = current.col + dir.second;
+                
+                if (newRow < rows && newCol < cols && !visited[newRow][newCol]) {
+                    int newHealth = current.health + dungeon[newRow][newCol];
+                    
+                    if (newHealth > 0 && newHealth > maxHealthReached[newRow][newCol]) {
+                        maxHealthReached[newRow][newCol] = newHealth;
+                        
+                        double h = manhattanDistance(newRow, newCol, rows-1, cols-1);
+                        double fScore = -newHealth + h; // Minimize negative health + distance
+                        
+                        pq.push(ForwardState(newRow, newCol, newHealth, fScore));
+                    }
+                }
+            }
+        }
+        
+        return false;
+    }
+    
+    double manhattanDistance(int row1, int col1, int row2, int col2) {
+        return abs(row1 - row2) + abs(col1 - col2);
+    }
+};
+
+// Copied from dungeon_game_bellman_ford.cpp
+class DungeonGameBellmanFord {
+private:
+    struct Edge {
+        int from_row, from_col, to_row, to_col, weight;
+        
+        Edge(int fr, int fc, int tr, int tc, int w) 
+            : from_row(fr), from_col(fc), to_row(tr), to_col(tc), weight(w) {}
+    };
+    
+    vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
+    
+public:
+    // The edge list and labels come from `workspace` if given
+    // (solver_workspace.h), so repeated solves with a warm workspace do not
+    // allocate
+    int calculateMinimumHP(vector<vector<int>>& dungeon, Workspace* workspace = nullptr) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+        
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+        
+        Workspace local;
+        Workspace& scratch = workspace ? *workspace : local;
+        Workspace::Frame frame(scratch);
+        int edgeCount = rows * (cols - 1) + (rows - 1) * cols;
+        scratch.reserve(Workspace::bytesFor<Edge>(edgeCount) + Workspace::bytesFor<int>(rows * cols));
+        
+        // Create edges for the graph
+        Edge* edges = scratch.allocate<Edge>(edgeCount);
+        createEdges(dungeon, edges);
+        
+        // Use Bellman-Ford to find minimum health needed
+        // We work backwards from princess to start; labels are row-major
+        int* minHealthCells = scratch.allocate<int>(rows * cols, INT_MAX);
+        auto minHealth = [minHealthCells, cols](int row, int col) -> int& {
+            return minHealthCells[row * cols + col];
+        };
+        
+        // Initialize princess room
+        minHealth(rows-1, cols-1) = max(1, 1 - dungeon[rows-1][cols-1]);
+        
+        // Relax edges (rows * cols - 1) times
+        for (int i = 0; i < rows * cols - 1; i++) {
+            bool updated = false;
+            
+            // Process each edge (in reverse direction for backward algorithm)
+            for (int e = 0; e < edgeCount; e++) {
+                const Edge& edge = edges[e];
+                int fromHealth = minHealth(edge.to_row, edge.to_col);
+                if (fromHealth != INT_MAX) {
+                    // Calculate health needed at source to reach destination
+                    int healthNeeded = max(1, fromHealth - dungeon[edge.from_row][edge.from_col]);
+                    
+                    if (healthNeeded < minHealth(edge.from_row, edge.from_col)) {
+                        minHealth(edge.from_row, edge.from_col) = healthNeeded;
+                        updated = true;
+                    }
+                }
+            }
+            
+            // Early termination if no updates
+            if (!updated) break;
+        }
+        
+        return minHealth(0, 0);
+    }
+    
+private:
+    // Fills edges with the rows * (cols - 1) + (rows - 1) * cols moves
+    void createEdges(vector<vector<int>>& dungeon, Edge* edges) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+        int count = 0;
+        
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                // Add edges from current cell to adjacent cells
+                for (auto& dir : directions) {
+                    int newRow = i + dir.first;
+                    int newCol = j + dir.second;
+                    
+                    if (newRow < rows && newCol < cols) {
+                        // Edge weight is the value of destination cell
+                        edges[count++] = Edge(i, j, newRow, newCol, dungeon[newRow][newCol]);
+                    }
+                }
+            }
+        }
+    }
+};
+
+// Forward Bellman-Ford with binary search, copied from dungeon_game_bellman_ford.cpp
+class DungeonGameBellmanFordForward {
+private:
+    vector<pair<int, int>> directions = {{0, 1}, {1, 0}}; // right, down
+    
+    ForwardHealthSearch<vector<int>> search;
+    
+public:
+    explicit DungeonGameBellmanFordForward(FeasibilityBackend backend = FeasibilityBackend::Sweep)
+        : search(backend) {}
+    
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        return search.minimumHealth(dungeon, [&](int health, vector<int>& scratch) {
+            return canReachPrincess(dungeon, health, scratch);
+        });
+    }
+    
+    int calculateMinimumHPParallel(vector<vector<int>>& dungeon, int lanes = defaultSearchLanes()) {
+        return search.minimumHealthParallel(dungeon, lanes, [&](int health, vector<int>& scratch) {
+            return canReachPrincess(dungeon, health, scratch);
+        });
+    }
+    
+private:
+    bool canReachPrincess(vector<vector<int>>& dungeon, int startHealth, vector<int>& scratch) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+        
+        // Use Bellman-Ford to find maximum health at each cell; the labels
+        // are the lane's scratch, row-major
+        scratch.assign(static_cast<size_t>(rows) * cols, INT_MIN);
+        auto maxHealth = [&scratch, cols](int row, int col) -> int& {
+            return scratch[static_cast<size_t>(row) * cols + col];
+        };
+        
+        // Initialize starting position
+        maxHealth(0, 0) = startHealth + dungeon[0][0];
+        if (maxHealth(0, 0) <= 0) return false;
+        
+        // Relax edges V-1 times
+        for (int iter = 0; iter < rows * cols - 1; iter++) {
+            bool updated = false;
+            
+            for (int i = 0; i < rows; i++) {
+                for (int j = 0; j < cols; j++) {
+                    if (maxHealth(i, j) == INT_MIN) continue;
+                    
+                    // Try all neighbors
+                    for (auto& dir : directions) {
+                        int newRow = i + dir.first;
+                        int newCol = j + dir.second;
+                        
+                        if (newRow < rows && newCol < cols) {
+                            int newHealth = maxHealth(i, j) + dungeon[newRow][newCol];
+                            
+                            if (newHealth > 0 && newHealth > maxHealth(newRow, newCol)) {
+                                maxHealth(newRow, newCol) = newHealth;
+                                updated = true;
+                            }
+                        }
+                    }
+                }
+            }
+            
+            if (!updated) break;
+        }
+        
+        return maxHealth(rows-1, cols-1) > 0;
+    }
+};
+
+// Copied from dungeon_game_1d_dp.cpp
+class DungeonGameOptimized {
+public:
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        vector<int> dp(cols, INT_MAX);
+        dp[cols - 1] = max(1, 1 - dungeon[rows - 1][cols - 1]);
+        for (int j = cols - 2; j >= 0; j--) {
+            dp[j] = max(1, dp[j + 1] - dungeon[rows - 1][j]);
+        }
+
+        for (int i = rows - 2; i >= 0; i--) {
+            dp[cols - 1] = max(1, dp[cols - 1] - dungeon[i][cols - 1]);
+            for (int j = cols - 2; j >= 0; j--) {
+                dp[j] = max(1, min(dp[j + 1], dp[j]) - dungeon[i][j]);
+            }
+        }
+
+        return dp[0];
+    }
+};
+
+// Largest side the backward Bellman-Ford is run at
+const int kBellmanFordMaxSize = 256;
+
+struct ProfileRow {
+    string solver;
+    int size = 0;
+    int repeats = 0;
+    int answer = 0;
+    PerfSample total;
+    AllocationStats memory;  // one solve, after the counted ones
+};
+
+class SolverProfiler {
+private:
+    PerfCounters counters;
+    vector<ProfileRow> rows;
+    int repeat;
+
+public:
+    explicit SolverProfiler(int repeat) : repeat(repeat) {}
+
+    const PerfCounters& perf() const { return counters; }
+
+    void profileSize(int size, const vector<string>& solvers) {
+        // Setup outside the counted region
+        DungeonGrid grid = syntheticGrid(size, size, static_cast<uint32_t>(size));
+        vector<vector<int>> dungeon = grid.toNested();
+
+        DungeonGameOptimized optimized;
+        DungeonGameBFS bfsSweep(FeasibilityBackend::Sweep);
+        DungeonGameBFS bfsTraversal(FeasibilityBackend::Traversal);
+        DungeonGameDijkstra dijkstra;
+        DungeonGameDFS dfsTraversal(FeasibilityBackend::Traversal);
+        DungeonGameAStar astar;
+        DungeonGameAStarForward astarTraversal(FeasibilityBackend::Traversal);
+        DungeonGameBellmanFord bellmanFord;
+        DungeonGameBellmanFordForward bellmanFordTraversal(FeasibilityBackend::Traversal);
+
+        for (const auto& solver : solvers) {
+            std::function<int()> solve;
+            if (solver == "dp1d") {
+                solve = [&]() { return optimized.calculateMinimumHP(dungeon); };
+            } else if (solver == "scalar1d") {
+                solve = [&]() { return DungeonKernels::scalar1D(grid); };
+            } else if (solver == "wavefront32") {
+                solve = [&]() { return DungeonKernels::wavefront<int32_t>(grid); };
+            } else if (solver == "tiled") {
+                solve = [&]() { return DungeonKernels::tiledParallel(grid, 256, 256, 1); };
+            } else if (solver == "fulltable") {
+                solve = [&]() { return DungeonKernels::fullTable(grid, nullptr); };
+            } else if (solver == "bfs_sweep") {
+                solve = [&]() { return bfsSweep.calculateMinimumHP(dungeon); };
+            } else if (solver == "bfs_parallel") {
+                solve = [&]() { return bfsSweep.calculateMinimumHPParallel(dungeon, 4); };
+            } else if (solver == "tiled_mt") {
+                solve = [&]() { return DungeonKernels::tiledParallel(grid, 128, 128, 4); };
+            } else if (solver == "bfs_traversal") {
+                solve = [&]() { return bfsTraversal.calculateMinimumHP(dungeon); };
+            } else if (solver == "dijkstra") {
+                solve = [&]() { return dijkstra.calculateMinimumHP(dungeon); };
+            } else if (solver == "dfs_traversal") {
+                solve = [&]() { return dfsTraversal.calculateMinimumHP(dungeon); };
+            } else if (solver == "astar") {
+                solve = [&]() { return astar.calculateMinimumHP(dungeon); };
+            } else if (solver == "astar_traversal") {
+                solve = [&]() { return astarTraversal.calculateMinimumHP(dungeon); };
+            } else if (solver == "bellman_ford") {
+                // About rows + cols passes over every edge: cubic in the side
+                if (size > kBellmanFordMaxSize) {
+                    cout << "Skipping bellman_ford at " << size << "x" << size
+                         << " (limit " << kBellmanFordMaxSize << ")" << endl;
+                    continue;
+                }
+                solve = [&]() { return bellmanFord.calculateMinimumHP(dungeon); };
+            } else if (solver == "bellman_ford_traversal") {
+                solve = [&]() { return bellmanFordTraversal.calculateMinimumHP(dungeon); };
+            } else {
+                cerr << "Unknown solver: " << solver << endl;
+                continue;
+            }
+
+            ProfileRow row;
+            row.solver = solver;
+            row.size = size;
+            row.answer = solve();  // warm caches and allocator, uncounted
+            for (int r = 0; r < repeat; r++) {
+                row.total += counters.measure([&]() { row.answer = solve(); });
+                row.repeats++;
+            }
+            row.memory = measureAllocations([&]() { row.answer = solve(); });
+            rows.push_back(row);
+        }
+    }
+
+    // Counts divided by solves (perCell = false) or by solves × cells
+    void printTable(bool perCell) const {
+        static const PerfEvent columns[] = {
+            PerfEvent::TaskClockNs, PerfEvent::Cycles, PerfEvent::Instructions,
+            PerfEvent::BranchMisses, PerfEvent::L1DMisses, PerfEvent::LLCMisses,
+            PerfEvent::DTLBMisses, PerfEvent::PageFaults
+        };
+
+        cout << "\n=== " << (perCell ? "PER CELL" : "PER SOLVE") << " ===" << endl;
+        cout << std::left << std::setw(24) << "Solver" << std::setw(11) << "Grid" << std::right;
+        for (PerfEvent event : columns) {
+            cout << std::setw(15) << perfEventName(event);
+        }
+        cout << std::setw(7) << "IPC" << endl;
+        cout << string(24 + 11 + 15 * 8 + 7, '-') << endl;
+
+        for (const auto& row : rows) {
+            double divisor = row.repeats;
+            if (perCell) {
+                divisor *= static_cast<double>(row.size) * row.size;
+            }
+
+            cout << std::left << std::setw(24) << row.solver
+                 << std::setw(11) << (std::to_string(row.size) + "x" + std::to_string(row.size))
+                 << std::right << std::fixed << std::setprecision(perCell ? 3 : 0);
+            for (PerfEvent event : columns) {
+                if (row.total.has(event)) {
+                    cout << std::setw(15) << row.total.value(event) / divisor;
+                } else {
+                    cout << std::setw(15) << "n/a";
+                }
+            }
+            if (row.total.has(PerfEvent::Cycles) && row.total.has(PerfEvent::Instructions) &&
+                row.total.value(PerfEvent::Cycles) > 0) {
+                cout << std::setprecision(2) << std::setw(7)
+                     << row.total.value(PerfEvent::Instructions) / row.total.value(PerfEvent::Cycles);
+            } else {
+                cout << std::setw(7) << "n/a";
+            }
+            cout << endl;
+            cout.unsetf(std::ios::fixed);
+        }
+    }
+
+    // Heap use of one solve, from the global new/delete hooks
+    void printMemory() const {
+        cout << "\n=== MEMORY PER SOLVE ===" << endl;
+        cout << std::left << std::setw(24) << "Solver" << std::setw(11) << "Grid" << std::right
+             << std::setw(13) << "allocations" << std::setw(16) << "bytes" << std::setw(16) << "peak-live"
+             << std::setw(14) << "live/cell" << std::setw(14) << "peak-RSS-KB" << endl;
+        cout << string(24 + 11 + 13 + 16 * 2 + 14 * 2, '-') << endl;
+
+        for (const auto& row : rows) {
+            double cells = static_cast<double>(row.size) * row.size;
+            cout << std::left << std::setw(24) << row.solver
+                 << std::setw(11) << (std::to_string(row.size) + "x" + std::to_string(row.size))
+                 << std::right << std::setw(13) << row.memory.allocations
+                 << std::setw(16) << row.memory.bytes
+                 << std::setw(16) << row.memory.peakLiveBytes
+                 << std::fixed << std::setprecision(2) << std::setw(14) << row.memory.peakLiveBytes / cells
+                 << std::setw(14) << row.memory.peakRssBytes / 1024 << endl;
+            cout.unsetf(std::ios::fixed);
+        }
+    }
+};
+
+static vector<string> splitList(const string& text) {
+    vector<string> items;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        if (comma == string::npos) comma = text.size();
+        if (comma > start) items.push_back(text.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return items;
+}
+
+int main(int argc, char** argv) {
+    vector<int> sizes = {64, 256, 1024};
+    vector<string> solvers = {"dp1d", "scalar1d", "wavefront32", "tiled", "fulltable",
+                              "bfs_sweep", "bfs_traversal", "dfs_traversal", "dijkstra", "astar",
+                              "astar_traversal", "bellman_ford", "bellman_ford_traversal"};
+    int repeat = 3;
+    string chromeTracePath;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            for (const auto& size : splitList(argv[++i])) sizes.push_back(std::atoi(size.c_str()));
+        } else if (arg == "--solvers" && i + 1 < argc) {
+            solvers = splitList(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = max(1, std::atoi(argv[++i]));
+        } else if (arg == "--chrome-trace" && i + 1 < argc) {
+            chromeTracePath = argv[++i];
+        } else {
+            cerr << "Usage: perf_profile [--sizes N,N,...] [--solvers a,b,...] [--repeat R]"
+                 << " [--chrome-trace PATH]\n"
+                 << "Solvers: dp1d scalar1d wavefront32 tiled fulltable bfs_sweep bfs_traversal\n"
+                 << "         dfs_traversal dijkstra astar astar_traversal bellman_ford\n"
+                 << "         bellman_ford_traversal bfs_parallel (4 probe lanes) tiled_mt (4 threads)"
+                 << endl;
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    SolverProfiler profiler(repeat);
+    cout << "=== HARDWARE COUNTER PROFILE ===" << endl;
+    if (!profiler.perf().hardwareAvailable()) {
+        cout << "Hardware counters unavailable: " << profiler.perf().unavailableReason() << endl;
+        cout << "Reporting software counters only." << endl;
+    }
+
+    // Timeline of tiles, barrier waits and search probes for Perfetto
+    SpanTracer timeline;
+    if (!chromeTracePath.empty()) {
+        timeline.activate();
+    }
+
+    for (int size : sizes) {
+        if (size > 0) {
+            profiler.profileSize(size, solvers);
+        }
+    }
+
+    if (!chromeTracePath.empty()) {
+        SpanTracer::deactivate();
+        if (!timeline.writeChromeJson(chromeTracePath)) {
+            cerr << "Cannot write " << chromeTracePath << endl;
+            return 1;
+        }
+        cout << timeline.spans() << " spans written to " << chromeTracePath << endl;
+    }
+
+    profiler.printTable(false);
+    profiler.printTable(true);
+    profiler.printMemory();
+    return 0;
+}
@@ -1,76 +1,111 @@
 #!/bin/bash
 
 # Dungeon Game Profiling Script
-# This script runs comprehensive profiling analysis
+# This script runs the CMake-built profiling tools from build/
 
 echo "=== DUNGEON GAME PROFILING SUITE ==="
 echo
 
-# Check if build is needed
-if [ ! -f "profiling_tests" ]; then
-    echo "Building profiling tests..."
-    make profiling_tests
-    echo
-fi
+BUILD_DIR=build
+
+# Configure and build the given targets with optimizations and debug info
+build_targets() {
+    cmake -S . -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=RelWithDebInfo > /dev/null || exit 1
+    for target in "$@"; do
+        cmake --build "$BUILD_DIR" --target "$target" > /dev/null || exit 1
+    done
+}
 
 echo "Choose profiling option:"
-echo "1. Basic performance profiling"
-echo "2. Optimized build profiling"
-echo "3. Memory usage profiling"
-echo "4. Instruments profiling (macOS)"
-echo "5. Valgrind profiling (Linux/macOS)"
-echo "6. All profiling methods"
-echo "7. Quick benchmark"
+echo "1. Quick benchmark (dungeon_benchmark)"
+echo "2. Memory: allocations per solve, with and without a Workspace"
+echo "3. Roofline: bandwidth and compute ceilings per kernel"
+echo "4. Timeline of tiles and search probes (Chrome trace)"
+echo "5. Valgrind callgrind (Linux/macOS)"
+echo "6. All of the above"
+echo "7. Hardware counters (Linux perf_event_open)"
 echo
 
 read -p "Enter your choice (1-7): " choice
 
+run_benchmark() {
+    build_targets dungeon_benchmark
+    ./"$BUILD_DIR"/dungeon_benchmark --sizes 64,256,1024 --time 0.2 --json benchmark_results.json
+}
+
+run_memory() {
+    build_targets dungeon_benchmark
+    ./"$BUILD_DIR"/dungeon_benchmark --allocations
+}
+
+run_roofline() {
+    build_targets dungeon_benchmark
+    ./"$BUILD_DIR"/dungeon_benchmark --roofline
+}
+
+run_timeline() {
+    build_targets perf_profile
+    ./"$BUILD_DIR"/perf_profile --sizes 1024 --solvers tiled_mt,bfs_parallel --chrome-trace solvers.json
+    echo "Open solvers.json in https://ui.perfetto.dev or chrome://tracing"
+}
+
+run_valgrind() {
+    if ! command -v valgrind > /dev/null; then
+        echo "valgrind not found; skipping"
+        return
+    fi
+    build_targets perf_profile
+    valgrind --tool=callgrind --callgrind-out-file=callgrind.out \
+        ./"$BUILD_DIR"/perf_profile --sizes 256 --repeat 1
+}
+
+run_counters() {
+    build_targets perf_profile
+    ./"$BUILD_DIR"/perf_profile
+}
+
 case $choice in
     1)
-        echo "Running basic performance profiling..."
-        make profile
+        echo "Running quick benchmark..."
+        run_benchmark
         ;;
     2)
-        echo "Running optimized build profiling..."
-        make profile-optimized
+        echo "Running memory profiling..."
+        run_memory
         ;;
     3)
-        echo "Running memory usage profiling..."
-        make profile-memory
+        echo "Running roofline analysis..."
+        run_roofline
         ;;
     4)
-        echo "Running Instruments profiling (macOS)..."
-        make profile-instruments
+        echo "Recording solver timeline..."
+        run_timeline
         ;;
     5)
         echo "Running Valgrind profiling..."
-        make profile-valgrind
+        run_valgrind
         ;;
     6)
         echo "Running all profiling methods..."
         echo
-        echo "=== 1. Basic Profiling ==="
-        make profile
+        echo "=== 1. Benchmark ==="
+        run_benchmark
         echo
-        echo "=== 2. Optimized Profiling ==="
-        make profile-optimized
+        echo "=== 2. Memory ==="
+        run_memory
         echo
-        echo "=== 3. Memory Profiling ==="
-        make profile-memory
+        echo "=== 3. Roofline ==="
+        run_roofline
         echo
-        echo "=== 4. Instruments (if available) ==="
-        make profile-instruments
+        echo "=== 4. Timeline ==="
+        run_timeline
         echo
         echo "=== 5. Valgrind (if available) ==="
-        make profile-valgrind
+        run_valgrind
         ;;
     7)
-        echo "Running quick benchmark..."
-        if [ ! -f "profiling_optimized" ]; then
-            make profiling_optimized
-        fi
-        echo "Testing different grid sizes..."
-        time ./profiling_optimized | grep -E "(Testing|Average time|Result)"
+        echo "Running hardware counter profile..."
+        run_counters
         ;;
     *)
         echo "Invalid choice. Please run the script again."
@@ -84,12 +119,10 @@ echo
 
 # Provide analysis recommendations
 echo "Profiling files generated:"
-ls -la | grep -E "(callgrind|instruments|\.prof|\.trace)"
+ls -la | grep -E "(callgrind|benchmark_results|solvers)\.(out|json)"
 
 echo
 echo "Next steps for analysis:"
 echo "- View callgrind output: kcachegrind callgrind.out (or qcachegrind)"
-echo "- Open Instruments trace: open instruments_output.trace"
-echo "- Compare performance across different optimizations"
-echo "- Analyze memory usage patterns"
-echo "- Identify bottlenecks in recursive calls"
+echo "- Compare benchmark_results.json against a baseline with build/benchmark_compare"
+echo "- Open solvers.json in Perfetto to see tile waits and probe lanes"
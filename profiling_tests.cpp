@@ -4,7 +4,11 @@
 #include <chrono>
 #include <fstream>
 #include <iomanip>
-#include <random>
+#include <thread>
+
+#include "instrumentation.h"
+#include "alloc_hooks.h"
+#include "dungeon_generator.h"
 
 using std::vector;
 using std::max;
@@ -16,97 +20,94 @@ using std::chrono::duration_cast;
 using std::chrono::microseconds;
 using std::chrono::nanoseconds;
 
-// Original DungeonGame class with profiling hooks
-class DungeonGame {
+/**
+ * Original DungeonGame with instrumentation hooks
+ *
+ * The instrumentation is a compile-time policy (see instrumentation.h):
+ * InstrumentedDungeonGame<NoInstrumentation> compiles the hooks away, while
+ * CountingInstrumentation keeps thread-sharded counters that are cheap
+ * enough to leave in production builds. Counters accumulate across solves
+ * and threads until resetProfileData().
+ */
+template<typename Instrumentation>
+class InstrumentedDungeonGame {
 private:
-    mutable size_t recursiveCalls = 0;
-    mutable size_t memoHits = 0;
-    mutable size_t boundaryChecks = 0;
-    mutable std::chrono::nanoseconds totalTime{0};
+    Instrumentation probes;
     
 public:
-    void resetProfileData() const {
-        recursiveCalls = 0;
-        memoHits = 0;
-        boundaryChecks = 0;
-        totalTime = std::chrono::nanoseconds{0};
+    void resetProfileData() {
+        probes.reset();
+    }
+    
+    ProbeTotals profileData() const {
+        return probes.totals();
     }
     
     void printProfileData() const {
+        ProbeTotals totals = probes.totals();
         cout << "\n=== PROFILING RESULTS ===" << endl;
-        cout << "Recursive calls: " << recursiveCalls << endl;
-        cout << "Memoization hits: " << memoHits << endl;
-        cout << "Boundary checks: " << boundaryChecks << endl;
-        cout << "Total execution time: " << totalTime.count() << " nanoseconds" << endl;
-        cout << "Average time per call: " << (recursiveCalls > 0 ? totalTime.count() / recursiveCalls : 0) << " ns" << endl;
+        cout << "Recursive calls: " << totals.calls << endl;
+        cout << "Memoization hits: " << totals.memoHits << endl;
+        cout << "Boundary checks: " << totals.boundaryChecks << endl;
+        if (totals.sampledCalls > 0) {
+            cout << "Sampled calls: " << totals.sampledCalls << endl;
+            cout << "Average inclusive time per call: " << std::fixed << std::setprecision(1)
+                 << totals.nsPerCall() << " ns" << endl;
+        }
         cout << "Memoization hit rate: " << std::fixed << std::setprecision(2) 
-             << (recursiveCalls > 0 ? (double)memoHits / recursiveCalls * 100 : 0) << "%" << endl;
+             << (totals.calls > 0 ? (double)totals.memoHits / totals.calls * 100 : 0) << "%" << endl;
     }
 
+    typedef typename Instrumentation::Tally Tally;
+    
     int recurse(int row, int col, const vector<vector<int>>& dungeon, 
-                vector<vector<int>>& memo) const {
+                vector<vector<int>>& memo, Tally& tally) {
         
-        auto start = high_resolution_clock::now();
-        recursiveCalls++;
+        typename Instrumentation::CallScope scope(tally);
         
         int rows = dungeon.size();
         int cols = dungeon[0].size();
 
         // Base case: reached princess
         if(row == rows - 1 && col == cols - 1) {
-            auto end = high_resolution_clock::now();
-            totalTime += duration_cast<nanoseconds>(end - start);
             return max(1, 1 - dungeon[row][col]);
         }
 
         // Out of bounds check
-        boundaryChecks++;
+        tally.onBoundaryCheck();
         if(row >= rows || col >= cols) {
-            auto end = high_resolution_clock::now();
-            totalTime += duration_cast<nanoseconds>(end - start);
             return INT_MAX;
         }
 
         // Memoization check
         if(memo[row][col] != INT_MIN) {
-            memoHits++;
-            auto end = high_resolution_clock::now();
-            totalTime += duration_cast<nanoseconds>(end - start);
+            tally.onMemoHit();
             return memo[row][col];
         }
 
         // Recursive calls
-        int goRight = recurse(row, col + 1, dungeon, memo);
-        int goDown = recurse(row + 1, col, dungeon, memo);
+        int goRight = recurse(row, col + 1, dungeon, memo, tally);
+        int goDown = recurse(row + 1, col, dungeon, memo, tally);
 
         int minimumHealth = min(goRight, goDown) - dungeon[row][col];
         memo[row][col] = max(1, minimumHealth);
         
-        auto end = high_resolution_clock::now();
-        totalTime += duration_cast<nanoseconds>(end - start);
-        
         return memo[row][col];
     }
 
-    int calculateMinimumHP(vector<vector<int>>& dungeon) const {
-        resetProfileData();
-        
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
         int rows = dungeon.size();
         int cols = dungeon[0].size();
         
         vector<vector<int>> memo(rows, vector<int>(cols, INT_MIN));
-        
-        auto start = high_resolution_clock::now();
-        int result = recurse(0, 0, dungeon, memo);
-        auto end = high_resolution_clock::now();
-        
-        auto duration = duration_cast<microseconds>(end - start);
-        cout << "Total algorithm time: " << duration.count() << " microseconds" << endl;
-        
-        return result;
+        Tally tally(probes);
+        return recurse(0, 0, dungeon, memo, tally);
     }
 };
 
+// Counts every call and times one call in 64
+typedef InstrumentedDungeonGame<CountingInstrumentation<64>> DungeonGame;
+
 // Performance benchmarking
 class PerformanceBenchmark {
 private:
@@ -140,6 +141,7 @@ public:
             
             // Single run with detailed profiling
             vector<vector<int>> testDungeon = dungeon;
+            game.resetProfileData();
             int result = game.calculateMinimumHP(testDungeon);
             cout << "Result: " << result << endl;
             game.printProfileData();
@@ -160,6 +162,7 @@ public:
         cout << "Worst case dungeon (all negative):" << endl;
         printDungeon(worstCase);
         
+        game.resetProfileData();
         int result = game.calculateMinimumHP(worstCase);
         cout << "Result: " << result << endl;
         game.printProfileData();
@@ -179,33 +182,94 @@ public:
         cout << "Best case dungeon (all positive):" << endl;
         printDungeon(bestCase);
         
+        game.resetProfileData();
         int result = game.calculateMinimumHP(bestCase);
         cout << "Result: " << result << endl;
         game.printProfileData();
     }
     
+    void benchmarkInstrumentationOverhead() {
+        cout << "\n=== INSTRUMENTATION OVERHEAD ===" << endl;
+        
+        vector<vector<int>> dungeon = generateRandomDungeon(60, 60);
+        const int runs = 200;
+        
+        InstrumentedDungeonGame<NoInstrumentation> plain;
+        InstrumentedDungeonGame<CountingInstrumentation<>> counting;
+        InstrumentedDungeonGame<CountingInstrumentation<64>> sampled;
+        
+        double plainNs = timeRuns(plain, dungeon, runs);
+        double countingNs = timeRuns(counting, dungeon, runs);
+        double sampledNs = timeRuns(sampled, dungeon, runs);
+        
+        cout << "60x60 grid, " << runs << " solves each:" << endl;
+        cout << std::fixed << std::setprecision(1);
+        cout << "  No instrumentation:     " << plainNs << " ns/solve" << endl;
+        cout << "  Counters only:          " << countingNs << " ns/solve ("
+             << (countingNs / plainNs - 1) * 100 << "% overhead)" << endl;
+        cout << "  Counters + 1/64 timing: " << sampledNs << " ns/solve ("
+             << (sampledNs / plainNs - 1) * 100 << "% overhead)" << endl;
+    }
+    
+    void benchmarkThreadedCounters() {
+        cout << "\n=== THREAD-SHARDED COUNTERS ===" << endl;
+        
+        vector<vector<int>> dungeon = generateRandomDungeon(40, 40);
+        const int threads = 4;
+        const int solvesPerThread = 50;
+        
+        // One shared solver; each thread counts into its own shard
+        DungeonGame shared;
+        vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&]() {
+                for (int i = 0; i < solvesPerThread; i++) {
+                    vector<vector<int>> copy = dungeon;
+                    shared.calculateMinimumHP(copy);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        
+        DungeonGame single;
+        vector<vector<int>> copy = dungeon;
+        single.calculateMinimumHP(copy);
+        
+        uint64_t expected = single.profileData().calls * threads * solvesPerThread;
+        uint64_t merged = shared.profileData().calls;
+        cout << threads << " threads x " << solvesPerThread << " solves: "
+             << merged << " calls counted, " << expected << " expected"
+             << (merged == expected ? " (exact)" : " (MISMATCH)") << endl;
+    }
+    
     void memoryUsageAnalysis() {
         cout << "\n=== MEMORY USAGE ANALYSIS ===" << endl;
         
         vector<int> sizes = {10, 20, 30, 40, 50};
         
         for (int size : sizes) {
-            // Calculate memory usage for memoization table
-            size_t memoSize = size * size * sizeof(int);
-            size_t dungeonSize = size * size * sizeof(int);
-            size_t totalMemory = memoSize + dungeonSize;
-            
-            cout << size << "x" << size << " grid:" << endl;
-            cout << "  Memoization table: " << memoSize << " bytes" << endl;
-            cout << "  Dungeon grid: " << dungeonSize << " bytes" << endl;
-            cout << "  Total memory: " << totalMemory << " bytes (" 
-                 << std::fixed << std::setprecision(2) << totalMemory / 1024.0 << " KB)" << endl;
+            // Model: the memo table as size*size ints, ignoring vector overhead
+            size_t memoModel = size * size * sizeof(int);
             
-            // Test actual performance
+            // Measured by the global new/delete hooks over one solve
             vector<vector<int>> dungeon = generateRandomDungeon(size, size);
-            auto start = high_resolution_clock::now();
-            game.calculateMinimumHP(dungeon);
-            auto end = high_resolution_clock::now();
+            high_resolution_clock::time_point start, end;
+            AllocationStats stats = measureAllocations([&]() {
+                start = high_resolution_clock::now();
+                game.calculateMinimumHP(dungeon);
+                end = high_resolution_clock::now();
+            });
+            
+            cout << size << "x" << size << " grid:" << endl;
+            cout << "  Memoization table (model): " << memoModel << " bytes" << endl;
+            cout << "  Allocations: " << stats.allocations << ", "
+                 << stats.bytes << " bytes requested" << endl;
+            cout << "  Peak live heap: " << stats.peakLiveBytes << " bytes ("
+                 << std::fixed << std::setprecision(2) << stats.peakLiveBytes / 1024.0 << " KB, "
+                 << static_cast<double>(stats.peakLiveBytes) / memoModel << "x the model)" << endl;
+            cout << "  Peak RSS: " << stats.peakRssBytes / 1024 << " KB" << endl;
             
             auto time = duration_cast<microseconds>(end - start).count();
             cout << "  Execution time: " << time << " μs" << endl;
@@ -215,19 +279,25 @@ public:
     }
     
 private:
-    vector<vector<int>> generateRandomDungeon(int rows, int cols) {
-        vector<vector<int>> dungeon(rows, vector<int>(cols));
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(-20, 10);
+    template<typename Game>
+    double timeRuns(Game& solver, const vector<vector<int>>& dungeon, int runs) {
+        vector<vector<int>> copy = dungeon;
+        solver.calculateMinimumHP(copy);  // warm up
         
-        for (int i = 0; i < rows; i++) {
-            for (int j = 0; j < cols; j++) {
-                dungeon[i][j] = dis(gen);
-            }
+        auto start = high_resolution_clock::now();
+        for (int i = 0; i < runs; i++) {
+            solver.calculateMinimumHP(copy);
         }
-        
-        return dungeon;
+        auto end = high_resolution_clock::now();
+        return static_cast<double>(duration_cast<nanoseconds>(end - start).count()) / runs;
+    }
+    
+    vector<vector<int>> generateRandomDungeon(int rows, int cols) {
+        // -20 to 10, seeded so profiles of two builds see the same grids
+        GeneratorSpec spec = GeneratorSpec::make(DungeonFamily::Uniform, rows, cols, 1);
+        spec.low = -20;
+        spec.high = 10;
+        return DungeonGenerator(spec).generate().toNested();
     }
     
     void printDungeon(const vector<vector<int>>& dungeon) {
@@ -252,6 +322,8 @@ int main() {
     benchmark.benchmarkWorstCase();
     benchmark.benchmarkDifferentSizes();
     benchmark.memoryUsageAnalysis();
+    benchmark.benchmarkInstrumentationOverhead();
+    benchmark.benchmarkThreadedCounters();
     
     cout << "\n=== PROFILING COMPLETE ===" << endl;
     cout << "For more detailed profiling, use external tools:" << endl;
@@ -0,0 +1,336 @@
+#ifndef DUNGEON_GAME_ROOFLINE_H
+#define DUNGEON_GAME_ROOFLINE_H
+
+#include <vector>
+#include <limits>
+#include <climits>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include "dungeon_kernels.h"
+#include "kernel_timing.h"
+
+// Where a working set lives
+enum class MemoryLevel {
+    L1,
+    L2,
+    LLC,
+    DRAM,
+    Count
+};
+
+inline const char* memoryLevelName(MemoryLevel level) {
+    switch (level) {
+        case MemoryLevel::L1:   return "L1";
+        case MemoryLevel::L2:   return "L2";
+        case MemoryLevel::LLC:  return "LLC";
+        case MemoryLevel::DRAM: return "DRAM";
+        default:                return "unknown";
+    }
+}
+
+// Data cache sizes in bytes; conservative defaults where the OS won't say
+struct CacheSizes {
+    size_t l1 = 32 * 1024;
+    size_t l2 = 1024 * 1024;
+    size_t llc = 8 * 1024 * 1024;
+};
+
+inline CacheSizes detectCacheSizes() {
+    CacheSizes sizes;
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+    long l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (l1 > 0) sizes.l1 = static_cast<size_t>(l1);
+    if (l2 > 0) sizes.l2 = static_cast<size_t>(l2);
+    sizes.llc = l3 > 0 ? static_cast<size_t>(l3) : std::max(sizes.l2, sizes.llc);
+#endif
+    return sizes;
+}
+
+// STREAM-style bandwidth, GB/s (bytes per ns), over three arrays whose
+// combined size is `bytes`; each kernel is the best of several passes.
+// The loops use SSE2, or AVX2 in a native build: at -O2 GCC leaves them
+// scalar, which would measure the load ports rather than the memory level.
+// The read loop keeps four sums so the adds never hold up the loads;
+// with 16-byte SSE2 loads it still reads L1 little faster than L2
+struct StreamBandwidth {
+    double read = 0;   // sum += a[i]
+    double copy = 0;   // c[i] = a[i]
+    double triad = 0;  // a[i] = b[i] + 3 * c[i]
+};
+
+inline int32_t streamRead(const int32_t* a, size_t count) {
+    size_t i = 0;
+    int32_t sum = 0;
+    int32_t lanes[4] = { 0, 0, 0, 0 };
+#if defined(__AVX2__)
+    __m256i s0 = _mm256_setzero_si256(), s1 = s0, s2 = s0, s3 = s0;
+    for (; i + 32 <= count; i += 32) {
+        s0 = _mm256_add_epi32(s0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+        s1 = _mm256_add_epi32(s1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 8)));
+        s2 = _mm256_add_epi32(s2, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 16)));
+        s3 = _mm256_add_epi32(s3, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 24)));
+    }
+    __m256i s = _mm256_add_epi32(_mm256_add_epi32(s0, s1), _mm256_add_epi32(s2, s3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes),
+                     _mm_add_epi32(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1)));
+#elif defined(__SSE2__)
+    __m128i s0 = _mm_setzero_si128(), s1 = s0, s2 = s0, s3 = s0;
+    for (; i + 16 <= count; i += 16) {
+        s0 = _mm_add_epi32(s0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        s1 = _mm_add_epi32(s1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 4)));
+        s2 = _mm_add_epi32(s2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 8)));
+        s3 = _mm_add_epi32(s3, _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 12)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes),
+                     _mm_add_epi32(_mm_add_epi32(s0, s1), _mm_add_epi32(s2, s3)));
+#endif
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < count; i++) sum += a[i];
+    return sum;
+}
+
+inline void streamTriad(int32_t* a, const int32_t* b, const int32_t* c, size_t count) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= count; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i));
+        __m128i triple = _mm_add_epi32(_mm_add_epi32(x, x), x);
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(a + i), _mm_add_epi32(y, triple));
+    }
+#endif
+    for (; i < count; i++) a[i] = b[i] + 3 * c[i];
+}
+
+inline StreamBandwidth measureStreamBandwidth(size_t bytes, double minNs = 2e7) {
+    size_t count = std::max<size_t>(bytes / (3 * sizeof(int32_t)), 1024);
+    std::vector<int32_t> a(count, 1), b(count, 2), c(count, 3);
+    // Small levels repeat the pass so the clock read between calls to the
+    // timed work stays out of the measurement
+    int passes = static_cast<int>(std::max<size_t>(1, (size_t(1) << 22) / (count * sizeof(int32_t))));
+    double moved = static_cast<double>(passes) * count * sizeof(int32_t);
+    volatile int32_t sink = 0;
+    StreamBandwidth result;
+
+    double ns = bestTimeNs([&]() {
+        for (int p = 0; p < passes; p++) sink = streamRead(&a[0], count);
+    }, minNs);
+    result.read = moved / ns;
+
+    ns = bestTimeNs([&]() {
+        for (int p = 0; p < passes; p++) std::copy(a.begin(), a.end(), c.begin());
+        sink = c[count / 2];
+    }, minNs);
+    result.copy = 2 * moved / ns;
+
+    ns = bestTimeNs([&]() {
+        for (int p = 0; p < passes; p++) streamTriad(&a[0], &b[0], &c[0], count);
+        sink = a[count / 2];
+    }, minNs);
+    result.triad = 3 * moved / ns;
+    return result;
+}
+
+/**
+ * Compute ceilings of the minimum-HP cell update, in cells per ns
+ *
+ *   peak32     the machine's throughput for need = max(1, min(x, y) - cell)
+ *              on independent cells: ten chains of min/sub/max in the
+ *              widest int32 vectors this build has (scalar where SSE4.1 is
+ *              missing, since SSE2 has no 32-bit min/max). This bounds
+ *              every kernel
+ *   peak16     the same in int16 lanes, for the int16 wavefront
+ *   chained    a latency figure, not a ceiling: the same update carried in
+ *              a register along L1-resident rows, each cell waiting for its
+ *              right neighbour as in the row-order kernels (memo, 1D,
+ *              in-place, full table, tiles). A row-order kernel near this
+ *              rate is latency-bound; only a wavefront order gets past it
+ */
+struct ComputeCeilings {
+    double peak32 = 0;
+    double peak16 = 0;
+    double chained = 0;
+};
+
+// min/sub/max on one register of lanes; scalar unless specialized below
+template<typename T>
+struct PeakLanes {
+    typedef T Vector;
+    static const int kLanes = 1;
+    static Vector splat(int value) { return static_cast<T>(value); }
+    static Vector step(Vector need, Vector low, Vector cell, Vector one) {
+        return std::max<T>(static_cast<T>(std::min(need, low) - cell), one);
+    }
+    static Vector lower(Vector a, Vector b) { return std::min(a, b); }
+    static int first(Vector a) { return a; }
+};
+
+#if defined(__AVX2__)
+template<>
+struct PeakLanes<int32_t> {
+    typedef __m256i Vector;
+    static const int kLanes = 8;
+    static Vector splat(int value) { return _mm256_set1_epi32(value); }
+    static Vector step(Vector need, Vector low, Vector cell, Vector one) {
+        return _mm256_max_epi32(_mm256_sub_epi32(_mm256_min_epi32(need, low), cell), one);
+    }
+    static Vector lower(Vector a, Vector b) { return _mm256_min_epi32(a, b); }
+    static int first(Vector a) { return _mm_cvtsi128_si32(_mm256_castsi256_si128(a)); }
+};
+
+template<>
+struct PeakLanes<int16_t> {
+    typedef __m256i Vector;
+    static const int kLanes = 16;
+    static Vector splat(int value) { return _mm256_set1_epi16(static_cast<int16_t>(value)); }
+    static Vector step(Vector need, Vector low, Vector cell, Vector one) {
+        return _mm256_max_epi16(_mm256_subs_epi16(_mm256_min_epi16(need, low), cell), one);
+    }
+    static Vector lower(Vector a, Vector b) { return _mm256_min_epi16(a, b); }
+    static int first(Vector a) { return static_cast<int16_t>(_mm_cvtsi128_si32(_mm256_castsi256_si128(a))); }
+};
+#elif defined(__SSE2__)
+#if defined(__SSE4_1__)
+template<>
+struct PeakLanes<int32_t> {
+    typedef __m128i Vector;
+    static const int kLanes = 4;
+    static Vector splat(int value) { return _mm_set1_epi32(value); }
+    static Vector step(Vector need, Vector low, Vector cell, Vector one) {
+        return _mm_max_epi32(_mm_sub_epi32(_mm_min_epi32(need, low), cell), one);
+    }
+    static Vector lower(Vector a, Vector b) { return _mm_min_epi32(a, b); }
+    static int first(Vector a) { return _mm_cvtsi128_si32(a); }
+};
+#endif
+
+template<>
+struct PeakLanes<int16_t> {
+    typedef __m128i Vector;
+    static const int kLanes = 8;
+    static Vector splat(int value) { return _mm_set1_epi16(static_cast<int16_t>(value)); }
+    static Vector step(Vector need, Vector low, Vector cell, Vector one) {
+        return _mm_max_epi16(_mm_subs_epi16(_mm_min_epi16(need, low), cell), one);
+    }
+    static Vector lower(Vector a, Vector b) { return _mm_min_epi16(a, b); }
+    static int first(Vector a) { return static_cast<int16_t>(_mm_cvtsi128_si32(a)); }
+};
+#endif
+
+// Cells per ns of independent updates: ten chains of three one-cycle ops
+// cover the latency on three vector ports
+template<typename T>
+double peakCeiling(double minNs) {
+    typedef PeakLanes<T> Lanes;
+    typedef typename Lanes::Vector Vector;
+    volatile int seed = 5;  // keeps the compiler from running the chains itself
+    const Vector low = Lanes::splat(seed), cell = Lanes::splat(-3), one = Lanes::splat(1);
+    const int rounds = 4096;
+    volatile int sink = 0;
+
+    double ns = bestTimeNs([&]() {
+        // Named registers: as an array the chains would go through memory
+        Vector a0 = Lanes::splat(seed), a1 = Lanes::splat(seed + 1), a2 = Lanes::splat(seed + 2),
+               a3 = Lanes::splat(seed + 3), a4 = Lanes::splat(seed + 4), a5 = Lanes::splat(seed + 5),
+               a6 = Lanes::splat(seed + 6), a7 = Lanes::splat(seed + 7), a8 = Lanes::splat(seed + 8),
+               a9 = Lanes::splat(seed + 9);
+        for (int r = 0; r < rounds; r++) {
+            a0 = Lanes::step(a0, low, cell, one);
+            a1 = Lanes::step(a1, low, cell, one);
+            a2 = Lanes::step(a2, low, cell, one);
+            a3 = Lanes::step(a3, low, cell, one);
+            a4 = Lanes::step(a4, low, cell, one);
+            a5 = Lanes::step(a5, low, cell, one);
+            a6 = Lanes::step(a6, low, cell, one);
+            a7 = Lanes::step(a7, low, cell, one);
+            a8 = Lanes::step(a8, low, cell, one);
+            a9 = Lanes::step(a9, low, cell, one);
+        }
+        Vector left = Lanes::lower(Lanes::lower(a0, a1), Lanes::lower(a2, a3));
+        Vector right = Lanes::lower(Lanes::lower(a4, a5), Lanes::lower(a6, a7));
+        sink = Lanes::first(Lanes::lower(Lanes::lower(left, right), Lanes::lower(a8, a9)));
+    }, minNs);
+    return static_cast<double>(rounds) * 10 * Lanes::kLanes / ns;
+}
+
+// Cells per ns of the register-carried row update over rows of `width`
+inline double chainedCeiling(int width, double minNs) {
+    std::vector<int> below(width, 5), values(width);
+    for (int i = 0; i < width; i++) values[i] = i % 21 - 10;
+    const int rows = std::max(64, (1 << 17) / width);
+    volatile int sink = 0;
+
+    double ns = bestTimeNs([&]() {
+        int* dp = &below[0];
+        const int* row = &values[0];
+        for (int r = 0; r < rows; r++) {
+            int need = INT_MAX;
+            for (int j = width - 1; j >= 0; j--) {
+                need = std::max(1, std::min(dp[j], need) - row[j]);
+                dp[j] = need;
+            }
+        }
+        sink = dp[0];
+    }, minNs);
+    return static_cast<double>(width) * rows / ns;
+}
+
+inline ComputeCeilings measureComputeCeilings(double minNs = 2e7) {
+    ComputeCeilings ceilings;
+    ceilings.peak32 = peakCeiling<int32_t>(minNs);
+    ceilings.peak16 = peakCeiling<int16_t>(minNs);
+    // Long rows expose the latency of the chain; short ones let the core
+    // start the next row before this one ends, which small grids get too
+    ceilings.chained = std::max(chainedCeiling(2048, minNs), chainedCeiling(48, minNs));
+    return ceilings;
+}
+
+// What this machine can do, per core
+struct MachineRoofline {
+    CacheSizes caches;
+    StreamBandwidth bandwidth[static_cast<int>(MemoryLevel::Count)];
+    size_t probeBytes[static_cast<int>(MemoryLevel::Count)];
+    ComputeCeilings compute;
+};
+
+// Working-set size that sits in a level: a quarter of the cache, so the
+// kernel's own buffers fit beside it; DRAM is 4x the LLC, capped
+inline size_t residentBytes(MemoryLevel level, const CacheSizes& caches, size_t maxBytes) {
+    switch (level) {
+        case MemoryLevel::L1:  return caches.l1 / 4;
+        case MemoryLevel::L2:  return caches.l2 / 4;
+        case MemoryLevel::LLC: return std::min(caches.llc / 4, maxBytes);
+        default:               return std::min(std::max<size_t>(4 * caches.llc, 64u << 20), maxBytes);
+    }
+}
+
+inline MachineRoofline measureMachineRoofline(size_t maxBytes) {
+    MachineRoofline machine;
+    machine.caches = detectCacheSizes();
+    for (int l = 0; l < static_cast<int>(MemoryLevel::Count); l++) {
+        MemoryLevel level = static_cast<MemoryLevel>(l);
+        // The probe arrays fill the same share of the level as the grids
+        machine.probeBytes[l] = residentBytes(level, machine.caches, maxBytes);
+        machine.bandwidth[l] = measureStreamBandwidth(machine.probeBytes[l]);
+    }
+    machine.compute = measureComputeCeilings();
+    return machine;
+}
+
+// Roofline bound in cells per ns: the lower of the compute ceiling and
+// what the memory level can feed at `bytesPerCell`
+inline double rooflineBound(double computeCeiling, double bandwidthGBs, double bytesPerCell) {
+    double memoryBound = bytesPerCell > 0 ? bandwidthGBs / bytesPerCell
+                                          : std::numeric_limits<double>::max();
+    return std::min(computeCeiling, memoryBound);
+}
+
+#endif // DUNGEON_GAME_ROOFLINE_H
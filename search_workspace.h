@@ -0,0 +1,112 @@
+#ifndef DUNGEON_GAME_SEARCH_WORKSPACE_H
+#define DUNGEON_GAME_SEARCH_WORKSPACE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+// Frontier entry packed into 8 bytes: flat cell index and health on entry
+struct PackedState {
+    uint32_t cell;
+    int32_t health;
+
+    PackedState(uint32_t c, int32_t h) : cell(c), health(h) {}
+};
+
+/**
+ * Reusable scratch memory for the binary-search feasibility probes
+ *
+ * A probe marks cells visited by writing the current generation number
+ * into a flat uint32 array, so starting a new probe is a single increment
+ * instead of reallocating and clearing a vector<vector<bool>>. The frontier
+ * vector keeps its capacity between probes and between calls, so after the
+ * first probe a search does no heap allocation at all.
+ *
+ * The frontier serves as a FIFO queue (pushFrontier/popFront) for BFS or as
+ * a LIFO stack (pushFrontier/popBack) for DFS. improveBest keeps the best
+ * health seen per cell for searches that prune dominated paths.
+ */
+class SearchWorkspace {
+private:
+    std::vector<uint32_t> visitedStamp_;
+    std::vector<int32_t> bestHealth_;
+    uint32_t generation_ = 0;
+
+    std::vector<PackedState> frontier_;
+    size_t head_ = 0;
+
+public:
+    // Start a new probe over a grid of the given number of cells
+    void beginProbe(size_t cells) {
+        if (visitedStamp_.size() != cells) {
+            visitedStamp_.assign(cells, 0);
+            bestHealth_.resize(cells);
+            generation_ = 0;
+        }
+
+        // On wrap-around old stamps could alias the new generation
+        if (++generation_ == 0) {
+            std::fill(visitedStamp_.begin(), visitedStamp_.end(), 0);
+            generation_ = 1;
+        }
+
+        frontier_.clear();
+        head_ = 0;
+    }
+
+    bool isVisited(uint32_t cell) const {
+        return visitedStamp_[cell] == generation_;
+    }
+
+    void markVisited(uint32_t cell) {
+        visitedStamp_[cell] = generation_;
+    }
+
+    // Dominance check: record health on entering a cell and return true if
+    // it beats every earlier arrival in this probe, false if the new path is
+    // dominated and can be pruned. Shares the stamp with markVisited.
+    bool improveBest(uint32_t cell, int32_t health) {
+        if (visitedStamp_[cell] == generation_ && health <= bestHealth_[cell]) {
+            return false;
+        }
+        visitedStamp_[cell] = generation_;
+        bestHealth_[cell] = health;
+        return true;
+    }
+
+    // True if a later arrival recorded by improveBest beat this health, so
+    // a queued entry carrying it is stale
+    bool isDominated(uint32_t cell, int32_t health) const {
+        return visitedStamp_[cell] == generation_ && health < bestHealth_[cell];
+    }
+
+    bool frontierEmpty() const {
+        return head_ == frontier_.size();
+    }
+
+    void pushFrontier(uint32_t cell, int32_t health) {
+        frontier_.push_back(PackedState(cell, health));
+    }
+
+    // Queue order: oldest entry first
+    PackedState popFront() {
+        PackedState state = frontier_[head_++];
+
+        // Rewind once drained so the queue reuses the front of the buffer
+        if (head_ == frontier_.size()) {
+            frontier_.clear();
+            head_ = 0;
+        }
+        return state;
+    }
+
+    // Stack order: newest entry first
+    PackedState popBack() {
+        PackedState state = frontier_.back();
+        frontier_.pop_back();
+        return state;
+    }
+};
+
+#endif // DUNGEON_GAME_SEARCH_WORKSPACE_H
@@ -3,8 +3,31 @@
 #include <cassert>
 #include <climits>
 #include <string>
+#include <sstream>
 #include <chrono>
 #include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "adaptive_solver.h"
+#include "benchmark_stats.h"
+#include "instrumentation.h"
+#include "alloc_tracking.h"
+#include "solve_metrics.h"
+#include "parallel_health_search.h"
+#include "roofline.h"
+#include "dungeon_generator.h"
+#include "dungeon_file.h"
+#include "dungeon_text.h"
+#include "dungeon_text_index.h"
+#include "dungeon_readahead.h"
+#include "forward_sweep.h"
+#include "indexed_heap.h"
 
 using std::vector;
 using std::max;
@@ -52,6 +75,253 @@ public:
     }
 };
 
+// Top-down DungeonGame without recursion
+//
+// Same recurrence and memo semantics as DungeonGame::recurse, but cells are
+// resolved with an explicit stack, so grid size cannot overflow the call
+// stack. The memo is one flat array with an extra padding column and row:
+// out-of-bounds neighbours read INT_MAX and the princess's two virtual
+// neighbours read 1, so no bounds checks are needed. The grid is resolved
+// tile by tile from the bottom-right; since everything right of and below
+// a tile is already known, each tile's search stays inside it and the
+// stack never holds more than about 2 * (tile height + tile width) cells.
+class DungeonGameIterative {
+private:
+    static const int kTile = 64;
+
+    vector<int> memo;
+    vector<size_t> pending;
+
+public:
+    int calculateMinimumHP(vector<vector<int>>& dungeon) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+        size_t stride = cols + 1;
+
+        memo.assign(static_cast<size_t>(rows + 1) * stride, INT_MIN);
+        for (int row = 0; row <= rows; row++) {
+            memo[row * stride + cols] = INT_MAX;
+        }
+        for (int col = 0; col < cols; col++) {
+            memo[rows * stride + col] = INT_MAX;
+        }
+        memo[(rows - 1) * stride + cols] = 1;
+        memo[rows * stride + cols - 1] = 1;
+
+        for (int tileRow = (rows - 1) / kTile * kTile; tileRow >= 0; tileRow -= kTile) {
+            for (int tileCol = (cols - 1) / kTile * kTile; tileCol >= 0; tileCol -= kTile) {
+                resolve(tileRow, tileCol, dungeon, stride);
+            }
+        }
+
+        return memo[0];
+    }
+
+private:
+    // Depth-first evaluation of recurse(row, col) on an explicit stack
+    void resolve(int row, int col, const vector<vector<int>>& dungeon, size_t stride) {
+        pending.clear();
+        pending.push_back(row * stride + col);
+
+        while (!pending.empty()) {
+            size_t cell = pending.back();
+            if (memo[cell] != INT_MIN) {
+                pending.pop_back();
+                continue;
+            }
+
+            int goRight = memo[cell + 1];
+            int goDown = memo[cell + stride];
+
+            // Evaluate unresolved subproblems first, right before down
+            if (goRight == INT_MIN || goDown == INT_MIN) {
+                if (goDown == INT_MIN) pending.push_back(cell + stride);
+                if (goRight == INT_MIN) pending.push_back(cell + 1);
+                continue;
+            }
+
+            int minimumHealth = min(goRight, goDown) - dungeon[cell / stride][cell % stride];
+            memo[cell] = max(1, minimumHealth);
+            pending.pop_back();
+        }
+    }
+};
+
+// Parallel lazy top-down DungeonGame
+//
+// Fork-join version of DungeonGame::recurse for queries that only need
+// part of the table, e.g. minimum health from an interior start cell.
+// A task for cell (row, col) spawns its right and down subproblems as
+// tasks and finishes once both are known, so only cells reachable from
+// the query are ever evaluated.
+//
+// Memo cells are atomics with two reserved states: kEmpty (never claimed)
+// and kComputing (claimed by a task). A cell is claimed with a single
+// compare-and-swap, so exactly one task ever computes it. A task whose
+// subproblem is being computed by another thread is requeued, and its
+// worker runs or steals other tasks meanwhile instead of spinning.
+// The memo is padded like DungeonGameIterative's and survives between
+// queries on the same dungeon.
+class DungeonGameParallel {
+private:
+    static const int kEmpty = INT_MIN;
+    static const int kComputing = INT_MIN + 1;
+
+    struct WorkQueue {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+
+    const vector<vector<int>>* grid = nullptr;
+    size_t stride = 0;
+    std::unique_ptr<std::atomic<int>[]> memo;
+    std::unique_ptr<WorkQueue[]> queues;
+    int workers = 1;
+
+public:
+    int calculateMinimumHP(vector<vector<int>>& dungeon, int threads = 0) {
+        if (dungeon.empty() || dungeon[0].empty()) {
+            return 1;
+        }
+
+        load(dungeon);
+        return minimumHPFrom(0, 0, threads);
+    }
+
+    // Reset the memo for a new dungeon; the dungeon must outlive the queries
+    void load(const vector<vector<int>>& dungeon) {
+        int rows = dungeon.size();
+        int cols = dungeon[0].size();
+
+        grid = &dungeon;
+        stride = cols + 1;
+        memo.reset(new std::atomic<int>[(rows + 1) * stride]);
+
+        for (size_t cell = 0; cell < (rows + 1) * stride; cell++) {
+            memo[cell].store(kEmpty, std::memory_order_relaxed);
+        }
+        for (int row = 0; row <= rows; row++) {
+            memo[row * stride + cols].store(INT_MAX, std::memory_order_relaxed);
+        }
+        for (int col = 0; col < cols; col++) {
+            memo[rows * stride + col].store(INT_MAX, std::memory_order_relaxed);
+        }
+        memo[(rows - 1) * stride + cols].store(1, std::memory_order_relaxed);
+        memo[rows * stride + cols - 1].store(1, std::memory_order_relaxed);
+    }
+
+    // Minimum health needed when starting at (row, col) of the loaded dungeon
+    int minimumHPFrom(int row, int col, int threads = 0) {
+        size_t root = row * stride + col;
+
+        int expected = kEmpty;
+        if (!memo[root].compare_exchange_strong(expected, kComputing)) {
+            return memo[root].load();  // answered by an earlier query
+        }
+
+        workers = threads > 0 ? threads : max(1u, std::thread::hardware_concurrency());
+        queues.reset(new WorkQueue[workers]);
+        queues[0].tasks.push_back(root);
+
+        vector<std::thread> helpers;
+        for (int worker = 1; worker < workers; worker++) {
+            helpers.push_back(std::thread(&DungeonGameParallel::work, this, worker, root));
+        }
+        work(0, root);
+        for (auto& helper : helpers) {
+            helper.join();
+        }
+
+        return memo[root].load();
+    }
+
+private:
+    static bool isKnown(int value) {
+        return value != kEmpty && value != kComputing;
+    }
+
+    void work(int self, size_t root) {
+        while (!isKnown(memo[root].load(std::memory_order_acquire))) {
+            size_t cell;
+            if (popOwn(self, cell) || steal(self, cell)) {
+                run(self, cell);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Advance one claimed cell: compute it, or fork its missing subproblems
+    void run(int self, size_t cell) {
+        int goRight = claimOrRead(cell + 1);
+        int goDown = claimOrRead(cell + stride);
+
+        if (isKnown(goRight) && isKnown(goDown)) {
+            int value = (*grid)[cell / stride][cell % stride];
+            int minimumHealth = min(goRight, goDown) - value;
+            memo[cell].store(max(1, minimumHealth), std::memory_order_release);
+            return;
+        }
+
+        WorkQueue& queue = queues[self];
+        std::lock_guard<std::mutex> guard(queue.lock);
+
+        if (goRight == kEmpty || goDown == kEmpty) {
+            // Fork: requeue this cell as a continuation beneath its new
+            // children, which run first (right before down)
+            queue.tasks.push_back(cell);
+            if (goDown == kEmpty) queue.tasks.push_back(cell + stride);
+            if (goRight == kEmpty) queue.tasks.push_back(cell + 1);
+        } else {
+            // Only waiting on another thread: park at the steal end so this
+            // worker runs other tasks first
+            queue.tasks.push_front(cell);
+        }
+    }
+
+    // Read a subproblem; if nobody owns it yet, claim it for the caller to
+    // spawn and return kEmpty
+    int claimOrRead(size_t cell) {
+        int value = memo[cell].load(std::memory_order_acquire);
+        if (value != kEmpty) {
+            return value;
+        }
+        if (!memo[cell].compare_exchange_strong(value, kComputing,
+                                                std::memory_order_acq_rel)) {
+            return value;  // another thread claimed or finished it first
+        }
+        return kEmpty;
+    }
+
+    bool popOwn(int self, size_t& cell) {
+        WorkQueue& queue = queues[self];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        cell = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(int self, size_t& cell) {
+        for (int offset = 1; offset < workers; offset++) {
+            WorkQueue& victim = queues[(self + offset) % workers];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                cell = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
 // Simple test framework
 class TestRunner {
 private:
@@ -228,6 +498,604 @@ void runTests() {
         runner.expect_eq(result > 0 ? 1 : 0, 1, "Performance test (positive result)");
     }
     
+    // Test 16: Iterative top-down solver agrees with the recursive one
+    {
+        DungeonGameIterative iterative;
+        vector<vector<vector<int>>> cases = {
+            {{-3, 5}, {1, -4}},
+            {{-5}},
+            {{-1, -2, -3}, {-4, -5, -6}, {-7, -8, -9}},
+            {{-3, 5, -2, 4}},
+            {{-3}, {5}, {-2}, {4}},
+            {{-5, 1, -2}, {1, -100, 1}, {1, 1, 1}},
+            {{-200, 100, -50}, {50, -100, 200}, {-50, 50, -10}}
+        };
+        bool allMatch = true;
+        for (auto& dungeon : cases) {
+            if (iterative.calculateMinimumHP(dungeon) != game.calculateMinimumHP(dungeon)) {
+                allMatch = false;
+            }
+        }
+        runner.expect_eq(allMatch ? 1 : 0, 1, "Iterative matches recursive on small grids");
+    }
+    
+    // Test 17: Iterative solver across tile boundaries
+    {
+        srand(42);
+        vector<vector<int>> dungeon(150, vector<int>(130));
+        for (auto& row : dungeon) {
+            for (auto& cell : row) {
+                cell = (rand() % 21) - 10;
+            }
+        }
+        DungeonGameIterative iterative;
+        runner.expect_eq(iterative.calculateMinimumHP(dungeon), game.calculateMinimumHP(dungeon),
+                         "Iterative matches recursive on 150x130 grid");
+    }
+    
+    // Test 18: Deep grid that would overflow the recursive call stack
+    {
+        vector<vector<int>> dungeon(1, vector<int>(1000000, -1));
+        dungeon[0][999999] = 0;
+        DungeonGameIterative iterative;
+        runner.expect_eq(iterative.calculateMinimumHP(dungeon), 1000000, "Iterative 1x1000000 row");
+    }
+    
+    // Test 19: Parallel fork-join solver agrees with the recursive one
+    {
+        srand(7);
+        vector<vector<int>> dungeon(120, vector<int>(90));
+        for (auto& row : dungeon) {
+            for (auto& cell : row) {
+                cell = (rand() % 21) - 10;
+            }
+        }
+        DungeonGameParallel parallel;
+        runner.expect_eq(parallel.calculateMinimumHP(dungeon, 4), game.calculateMinimumHP(dungeon),
+                         "Parallel matches recursive on 120x90 grid");
+        
+        // Lazy query from an interior cell reuses the loaded memo
+        vector<vector<int>> memo(120, vector<int>(90, INT_MIN));
+        runner.expect_eq(parallel.minimumHPFrom(60, 45, 4), game.recurse(60, 45, dungeon, memo),
+                         "Parallel interior query (60,45)");
+    }
+    
+    // Test 20: Every kernel behind the adaptive solver agrees with DungeonGame
+    {
+        srand(11);
+        bool allMatch = true;
+        for (int trial = 0; trial < 200 && allMatch; trial++) {
+            int rows = 1 + rand() % 40, cols = 1 + rand() % 40;
+            DungeonGrid grid(rows, cols);
+            for (auto& cell : grid.cells) {
+                cell = (rand() % 21) - 10;
+            }
+            vector<vector<int>> dungeon = grid.toNested();
+            int expected = game.calculateMinimumHP(dungeon);
+            allMatch = DungeonKernels::scalar1D(grid) == expected &&
+                       DungeonKernels::wavefront<int32_t>(grid) == expected &&
+                       DungeonKernels::tiledParallel(grid, 1 + rand() % 8, 1 + rand() % 8, 3) == expected &&
+                       DungeonKernels::fullTable(grid, nullptr) == expected &&
+                       (!DungeonKernels::fitsInt16(grid) || DungeonKernels::wavefront<int16_t>(grid) == expected);
+        }
+        runner.expect_eq(allMatch ? 1 : 0, 1, "Kernels match recursive on random grids");
+    }
+    
+    // Test 21: Adaptive dispatch, path reconstruction and memory budget
+    {
+        vector<vector<int>> dungeon = {{-2, -3, 3}, {-5, -10, 1}, {10, 30, -5}};
+        AdaptiveDungeonSolver solver(2);
+        SolveOptions withPath;
+        withPath.needPath = true;
+        SolveResult result = solver.solve(dungeon, withPath);
+        runner.expect_eq(result.minimumHP, 7, "Adaptive solve with path");
+        runner.expect_eq(result.path == "RRDD" ? 1 : 0, 1, "Adaptive path is RRDD");
+        
+        SolveOptions tight;
+        tight.memoryBudget = 4096;
+        runner.expect_eq(solver.choose(5000, 5000, tight) == KernelKind::Scalar1D ? 1 : 0, 1,
+                         "Tight memory budget picks scalar1d");
+
+        withPath.memoryBudget = 16;
+        result = solver.solve(dungeon, withPath);
+        runner.expect_eq(result.minimumHP == 0 && result.path.empty() && !result.error.empty(), true,
+                         "Path over the memory budget fails with an error");
+        
+        vector<DungeonGrid> grids(20, DungeonGrid::fromNested(dungeon));
+        vector<int> answers = solver.solveBatch(grids);
+        runner.expect_eq(answers.back(), 7, "Adaptive batch solve");
+    }
+    
+    // Test 22: Tuning profiles round-trip per CPU model
+    {
+        const char* path = "simple_tests_tuning.profile";
+        TuningProfile first, second, loaded;
+        first.cpuModel = "Model A";
+        first.classes[static_cast<int>(SizeClass::Large)].tileRows = 128;
+        second.cpuModel = "Model B";
+        second.classes[static_cast<int>(SizeClass::Large)].int16Lanes = false;
+        std::remove(path);
+        AutoTuner::saveProfile(path, first);
+        AutoTuner::saveProfile(path, second);
+        AutoTuner::saveProfile(path, first);  // replaces Model A, keeps Model B
+        
+        bool loadedA = AutoTuner::loadProfile(path, "Model A", loaded);
+        runner.expect_eq(loadedA ? loaded.forCells(1000 * 1000).tileRows : 0, 128,
+                         "Profile for Model A keeps its tile size");
+        bool loadedB = AutoTuner::loadProfile(path, "Model B", loaded);
+        runner.expect_eq(loadedB && !loaded.forCells(1000 * 1000).int16Lanes ? 1 : 0, 1,
+                         "Profile for Model B survives a save for Model A");
+        runner.expect_eq(AutoTuner::loadProfile(path, "Model C", loaded) ? 1 : 0, 0,
+                         "No profile for an unknown CPU model");
+        std::remove(path);
+    }
+    
+    // Test 23: Benchmark statistics and the regression test
+    {
+        vector<double> samples = {5, 1, 4, 2, 3};
+        SampleStats stats = summarize(samples);
+        runner.expect_eq(static_cast<int>(stats.median), 3, "Median of 1..5");
+        runner.expect_eq(static_cast<int>(stats.p95 * 10), 48, "p95 of 1..5 interpolates to 4.8");
+        
+        vector<double> baseline, same, slower;
+        for (int i = 0; i < 30; i++) {
+            baseline.push_back(100 + i % 7);
+            same.push_back(100 + (i * 3) % 7);
+            slower.push_back(110 + i % 7);
+        }
+        runner.expect_eq(mannWhitneyU(baseline, same).pSlower > 0.05 ? 1 : 0, 1,
+                         "Mann-Whitney: same distribution is not slower");
+        runner.expect_eq(mannWhitneyU(baseline, slower).pSlower < 0.001 ? 1 : 0, 1,
+                         "Mann-Whitney: shifted distribution is slower");
+        runner.expect_eq(mannWhitneyU(slower, baseline).pSlower > 0.99 ? 1 : 0, 1,
+                         "Mann-Whitney: faster run is not flagged");
+    }
+    
+    // Test 24: Thread-sharded instrumentation counters merge exactly
+    {
+        CountingInstrumentation<8> probes;
+        vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&probes]() {
+                for (int solve = 0; solve < 100; solve++) {
+                    CountingInstrumentation<8>::Tally tally(probes);
+                    for (int call = 0; call < 50; call++) {
+                        CountingInstrumentation<8>::CallScope scope(tally);
+                        if (call % 5 == 0) tally.onMemoHit();
+                        tally.onBoundaryCheck();
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        ProbeTotals totals = probes.totals();
+        runner.expect_eq(static_cast<int>(totals.calls), 4 * 100 * 50, "Sharded call count");
+        runner.expect_eq(static_cast<int>(totals.memoHits), 4 * 100 * 10, "Sharded memo hits");
+        runner.expect_eq(static_cast<int>(totals.sampledCalls), 4 * 100 * 7, "One call in 8 is timed");
+        probes.reset();
+        runner.expect_eq(static_cast<int>(probes.totals().boundaryChecks), 0, "Reset clears every shard");
+    }
+    
+    // Test 25: Counting allocator feeds the per-solve allocation stats
+    {
+        AllocationStats stats = measureAllocations([]() {
+            TrackedVector<int> dp(100, 0);
+            TrackedVector<int> scratch;
+            scratch.reserve(50);
+        });
+        runner.expect_eq(static_cast<int>(stats.allocations), 2, "Tracked vectors counted");
+        runner.expect_eq(static_cast<int>(stats.bytes), 600, "Tracked bytes");
+        runner.expect_eq(static_cast<int>(stats.peakLiveBytes), 600, "Peak live bytes");
+        runner.expect_eq(static_cast<int>(stats.frees), 2, "Tracked vectors freed");
+    }
+
+    // Test 26: Workspace arena reaches its high-water mark and stops growing
+    {
+        DungeonGrid grid = syntheticGrid(60, 45, 7, -10, 10);
+        int expected = DungeonKernels::scalar1D(grid);
+        Workspace workspace;
+        bool allMatch = true;
+        size_t growthsAfterWarmup = 0;
+        for (int round = 0; round < 3; round++) {
+            allMatch = allMatch &&
+                       DungeonKernels::scalar1D(grid, &workspace) == expected &&
+                       DungeonKernels::wavefront<int32_t>(grid, &workspace) == expected &&
+                       DungeonKernels::tiledParallel(grid, 8, 8, 3, &workspace) == expected &&
+                       DungeonKernels::fullTable(grid, nullptr, &workspace) == expected;
+            if (round == 0) {
+                growthsAfterWarmup = workspace.growths();
+            }
+        }
+        runner.expect_eq(allMatch, true, "Kernels agree when sharing a workspace");
+        runner.expect_eq(static_cast<int>(workspace.growths()), static_cast<int>(growthsAfterWarmup),
+                         "Warm workspace does not grow");
+        runner.expect_eq(static_cast<int>(workspace.inUse()), 0, "Workspace rewound after each solve");
+        runner.expect_eq(workspace.capacity() >= workspace.highWater(), true, "One chunk holds the high-water mark");
+    }
+
+    // Test 27: Latency histograms keep ~3% precision and merge across threads
+    {
+        LatencyHistogram histogram;
+        for (uint64_t ns = 1; ns <= 100000; ns++) {
+            histogram.record(ns);
+        }
+        double p50 = static_cast<double>(histogram.percentile(0.5));
+        double p999 = static_cast<double>(histogram.percentile(0.999));
+        runner.expect_eq(p50 >= 50000 && p50 <= 50000 * 1.04, true, "Histogram p50 within 4%");
+        runner.expect_eq(p999 >= 99900 && p999 <= 100000, true, "Histogram p999 capped at max");
+
+        SolveMetrics metrics;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.push_back(std::thread([&metrics, t]() {
+                for (int k = 0; k < 1000; k++) {
+                    metrics.record(KernelKind::Scalar1D, 100, 1000 + t, 0);
+                }
+                metrics.recordInt16Widened();
+            }));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        MetricsSnapshot snapshot = metrics.snapshot();
+        const SeriesSnapshot* series = snapshot.find(KernelKind::Scalar1D, SizeClass::Small);
+        runner.expect_eq(series ? static_cast<int>(series->latency.count()) : 0, 4000, "Per-thread solves merged");
+        runner.expect_eq(series ? static_cast<int>(series->cells) : 0, 400000, "Cells counted");
+        runner.expect_eq(static_cast<int>(snapshot.int16Widened), 4, "Widening fallbacks counted");
+
+        std::ostringstream prometheus;
+        SolveMetrics::writePrometheus(prometheus, snapshot);
+        bool hasCount = prometheus.str().find(
+            "dungeon_solve_duration_seconds_count{kernel=\"scalar1d\",size_class=\"small\"} 4000") != std::string::npos;
+        runner.expect_eq(hasCount, true, "Prometheus histogram exported");
+    }
+
+    // Test 28: Timeline spans for tiles, batches and search probes
+    {
+        DungeonGrid grid = syntheticGrid(20, 30, 11, -10, 10);
+        std::vector<DungeonGrid> grids(3, grid);
+        std::vector<int> results;
+
+        DungeonKernels::tiledParallel(grid, 10, 15, 2);  // no tracer: nothing recorded
+        SpanTracer timeline;
+        timeline.activate();
+        DungeonKernels::tiledParallel(grid, 10, 15, 2);
+        DungeonKernels::batch(grids, results, 2);
+        int found = parallelMinimumHealth(1, 1000, 3, [](int, int health) { return health >= 321; });
+        SpanTracer::deactivate();
+        DungeonKernels::tiledParallel(grid, 10, 15, 2);
+
+        int counts[static_cast<int>(SpanKind::Count)] = {0};
+        bool rangesValid = true;
+        timeline.forEach([&](uint32_t, const SpanRecord& span) {
+            counts[static_cast<int>(span.kind)]++;
+            rangesValid = rangesValid && span.endNs >= span.startNs;
+        });
+        std::ostringstream json;
+        timeline.writeChromeJson(json);
+
+        runner.expect_eq(found, 321, "Parallel search under tracing");
+        runner.expect_eq(counts[static_cast<int>(SpanKind::Tile)], 4, "One span per tile");
+        runner.expect_eq(counts[static_cast<int>(SpanKind::BatchGrid)], 3, "One span per batch grid");
+        runner.expect_eq(counts[static_cast<int>(SpanKind::Probe)] > 0, true, "Probe spans recorded");
+        runner.expect_eq(rangesValid, true, "Spans end after they start");
+        runner.expect_eq(json.str().find("\"ph\":\"X\"") != std::string::npos, true, "Chrome trace events written");
+
+        SpanTracer sequential;
+        sequential.activate();
+        found = sequentialMinimumHealth(1, 1000, [](int health) { return health >= 321; });
+        SpanTracer::deactivate();
+        int rounds = 0, probes = 0;
+        sequential.forEach([&](uint32_t, const SpanRecord& span) {
+            rounds += span.kind == SpanKind::SearchRound;
+            probes += span.kind == SpanKind::Probe;
+        });
+        runner.expect_eq(found == 321 && rounds == 10 && probes == 10, true, "Binary search spans one probe per round");
+    }
+
+    // Test 29: Coordinated-omission correction backfills the stalled requests
+    {
+        LatencyHistogram corrected;
+        for (int k = 0; k < 99; k++) {
+            corrected.recordWithExpectedInterval(10, 100);
+        }
+        corrected.recordWithExpectedInterval(1000, 100);  // hid 9 requests
+        runner.expect_eq(static_cast<int>(corrected.count()), 109, "Stall backfilled at the pacing interval");
+        uint64_t p95 = corrected.percentile(0.95);
+        runner.expect_eq(p95 >= 500 && p95 < 520, true, "Corrected p95 sees the stall");
+    }
+
+    // Test 30: Roofline bound and level sizing
+    {
+        runner.expect_eq(rooflineBound(2.0, 8.0, 8.0) == 1.0, true, "Memory-bound kernel capped at GB/s per byte");
+        runner.expect_eq(rooflineBound(0.5, 80.0, 4.0) == 0.5, true, "Compute-bound kernel capped at its ceiling");
+        CacheSizes caches;
+        caches.l1 = 32 << 10;
+        caches.l2 = 1 << 20;
+        caches.llc = 32 << 20;
+        runner.expect_eq(static_cast<int>(residentBytes(MemoryLevel::L2, caches, 1 << 30)), 256 << 10, "L2 grid is a quarter of L2");
+        runner.expect_eq(static_cast<int>(residentBytes(MemoryLevel::DRAM, caches, 1 << 30)), 128 << 20, "DRAM grid outgrows the LLC");
+        runner.expect_eq(static_cast<int>(residentBytes(MemoryLevel::DRAM, caches, 16 << 20)), 16 << 20, "DRAM grid respects the cap");
+    }
+
+    // Test 31: Power-law fit recovers exponent and constant
+    {
+        vector<double> sizes = {256, 1024, 4096, 16384};
+        vector<double> quadratic, linear;
+        for (double n : sizes) {
+            quadratic.push_back(3 * n * n);
+            linear.push_back(5 * n);
+        }
+        PowerLawFit fit = fitPowerLaw(sizes, quadratic);
+        runner.expect_eq(static_cast<int>(fit.points), 4, "Fit uses every point");
+        runner.expect_eq(std::fabs(fit.exponent - 2) < 1e-9, true, "Quadratic exponent");
+        runner.expect_eq(std::fabs(fit.constant - 3) < 1e-6, true, "Quadratic constant");
+        runner.expect_eq(std::fabs(fit.r2 - 1) < 1e-9, true, "Exact power law has R^2 = 1");
+        runner.expect_eq(std::fabs(fitPowerLaw(sizes, linear).predict(1e8) - 5e8) < 1, true, "Linear extrapolation");
+        runner.expect_eq(static_cast<int>(fitPowerLaw(vector<double>(1, 10), vector<double>(1, 10)).points), 1, "One point leaves the fit empty");
+    }
+
+    // Test 32: Generator is independent of threads and tiling; files round-trip
+    {
+        DungeonGenerator uniform(GeneratorSpec::make(DungeonFamily::Uniform, 97, 131, 7));
+        DungeonGrid serial = uniform.generate(1);
+        runner.expect_eq(uniform.generate(3).cells == serial.cells, true, "Same grid with 1 and 3 threads");
+        vector<int> tile(20 * 30);
+        uniform.fillTile(40, 60, 100, 130, &tile[0], 30);
+        bool tileMatches = true;
+        for (int i = 40; i < 60; i++) {
+            for (int j = 100; j < 130; j++) {
+                tileMatches = tileMatches && tile[(i - 40) * 30 + (j - 100)] == serial.at(i, j);
+            }
+        }
+        runner.expect_eq(tileMatches, true, "A tile generated alone matches the grid");
+        int lowest = *std::min_element(serial.cells.begin(), serial.cells.end());
+        int highest = *std::max_element(serial.cells.begin(), serial.cells.end());
+        runner.expect_eq(lowest * 100 + highest, -10 * 100 + 10, "Uniform family fills -10..10");
+        runner.expect_eq(DungeonGenerator(GeneratorSpec::make(DungeonFamily::Uniform, 97, 131, 8)).generate().cells == serial.cells,
+                         false, "Another seed gives another grid");
+
+        // The main corridor joins knight and princess, so no wall is crossed
+        DungeonGrid corridor = DungeonGenerator(GeneratorSpec::make(DungeonFamily::Corridor, 64, 48, 1)).generate();
+        runner.expect_eq(DungeonKernels::scalar1D(corridor) <= 1 + 1000 * (64 + 48 - 1), true, "Corridor answer avoids the walls");
+
+        const char* path = "simple_tests_grid.dgrid";
+        std::string error;
+        runner.expect_eq(writeDungeonFile(path, serial, &error), true, "Write a dungeon file");
+        MappedDungeonFile file;
+        runner.expect_eq(file.open(path) && file.toGrid().cells == serial.cells, true, "Mapped file reads back the grid");
+        runner.expect_eq(file.isOpen() ? DungeonKernels::streaming(file.rows(), file.cols(), [&file](int i) { return file.row(i); }) : 0,
+                         DungeonKernels::scalar1D(serial), "Streaming solve over the mapping");
+        file.close();
+        std::FILE* text = std::fopen(path, "w");
+        std::fputs("1 2 3\n", text);
+        std::fclose(text);
+        runner.expect_eq(file.open(path), false, "A text file is not a dungeon file");
+        std::remove(path);
+        runner.expect_eq(!file.open("simple_tests_missing/grid.dgrid") && !file.error().empty(), true,
+                         "A missing file says why it cannot be opened");
+        runner.expect_eq(!file.create("simple_tests_missing/grid.dgrid", makeDungeonFileHeader(4, 4)) && !file.error().empty(),
+                         true, "A file that cannot be created says why");
+    }
+
+    // Test 33: Text loader accepts CSV and whitespace, names the bad line
+    {
+        std::string csv = "1,-2,3\r\n4,5,-6\r\n\n";
+        DungeonGrid grid;
+        std::string error;
+        runner.expect_eq(parseDungeonText(csv.data(), csv.size(), grid, &error) && grid.rows == 2 && grid.cols == 3 &&
+                         grid.at(1, 2) == -6, true, "CSV with CRLF line ends");
+        std::string spaced = "  1 \t-2  3\n4 5 +6";
+        runner.expect_eq(parseDungeonText(spaced.data(), spaced.size(), grid, &error) && grid.at(1, 2) == 6, true,
+                         "Tabs, runs of spaces, no final newline");
+        std::string ragged = "1 2 3\n4 5\n6 7 8\n";
+        parseDungeonText(ragged.data(), ragged.size(), grid, &error);
+        runner.expect_eq(error == "line 2: 2 values, expected 3", true, "Short row named");
+        std::string bad = "1 2 3\n4 5 6\n7 8-1 9\n";
+        parseDungeonText(bad.data(), bad.size(), grid, &error);
+        runner.expect_eq(error == "line 3: not an integer", true, "Sign inside a number rejected");
+        std::string large = "2147483647 -2147483648\n2147483648 0\n";
+        parseDungeonText(large.data(), large.size(), grid, &error);
+        runner.expect_eq(error == "line 2: value out of int range", true, "int limits parse, one past them do not");
+        std::string largeFirst = "2147483648 1\n";
+        parseDungeonText(largeFirst.data(), largeFirst.size(), grid, &error);
+        runner.expect_eq(error == "line 1: value out of int range", true, "Out-of-range first line named");
+        std::string empty = "\n1 2\n";
+        parseDungeonText(empty.data(), empty.size(), grid, &error);
+        runner.expect_eq(error == "line 1: no row of integers", true, "Empty first line named");
+
+        // Several MB, so the text is split into chunks across threads
+        DungeonGrid generated = DungeonGenerator(GeneratorSpec::make(DungeonFamily::Extreme, 1500, 700, 3)).generate();
+        std::string text;
+        for (int i = 0; i < generated.rows; i++) {
+            appendDungeonTextRow(text, generated.row(i), generated.cols);
+        }
+        runner.expect_eq(parseDungeonText(text.data(), text.size(), grid, &error, 3) && grid.cells == generated.cells,
+                         true, "Formatted rows parse back across threads");
+        text[text.size() * 3 / 4] = 'x';
+        size_t line = std::count(text.begin(), text.begin() + text.size() * 3 / 4, '\n') + 1;
+        parseDungeonText(text.data(), text.size(), grid, &error, 3);
+        runner.expect_eq(error == "line " + std::to_string(line) + ": not an integer", true, "Bad line found in a later chunk");
+    }
+
+    // Test 34: Row index streams a text dungeon bottom up in small blocks
+    {
+        DungeonGrid grid = DungeonGenerator(GeneratorSpec::make(DungeonFamily::Stale, 203, 57, 11)).generate();
+        std::string text;
+        for (int i = 0; i < grid.rows; i++) {
+            appendDungeonTextRow(text, grid.row(i), grid.cols);
+        }
+        const char* path = "simple_tests_grid.txt";
+        std::FILE* out = std::fopen(path, "wb");
+        std::fwrite(text.data(), 1, text.size(), out);
+        std::fclose(out);
+
+        TextRowIndex index;
+        std::string error;
+        runner.expect_eq(buildTextRowIndex(path, 10, index, &error) && index.rows == 203 && index.offsets.size() == 22,
+                         true, "Index holds every 10th row and the end");
+        runner.expect_eq(static_cast<int>(std::count(text.begin(), text.begin() + index.offsets[7], '\n')), 70,
+                         "Entry 7 starts row 70");
+        ReverseTextRowReader reader;
+        runner.expect_eq(reader.open(path, index, 1000), true, "Reader opens with a current index");
+        int answer = DungeonKernels::streaming(reader.rows(), reader.cols(), [&reader](int i) { return reader.row(i); });
+        runner.expect_eq(answer, DungeonKernels::scalar1D(grid), "Bottom-up stream matches the in-memory solve");
+        runner.expect_eq(reader.bufferBytes() < text.size() / 2, true, "Blocks hold a fraction of the text");
+        reader.close();
+
+        out = std::fopen(path, "ab");
+        std::fputs("1 2 3\n", out);
+        std::fclose(out);
+        runner.expect_eq(reader.open(path, index), false, "Index of a grown text is stale");
+
+        std::string sidecar = textRowIndexPath(path);
+        TextRowIndex loaded;
+        runner.expect_eq(writeTextRowIndex(sidecar, index) && readTextRowIndex(sidecar, loaded) &&
+                             loaded.offsets == index.offsets,
+                         true, "Row index reads back as written");
+        TextRowIndex corrupt;
+        corrupt.rows = INT_MAX;
+        corrupt.cols = index.cols;
+        corrupt.offsets = index.offsets;
+        writeTextRowIndex(sidecar, corrupt);
+        runner.expect_eq(!readTextRowIndex(sidecar, loaded, &error) &&
+                             error == sidecar + ": row index is truncated or corrupt",
+                         true, "Row count larger than the file is rejected");
+        corrupt.rows = index.rows;
+        corrupt.stride = index.stride;
+        corrupt.textBytes = index.textBytes;
+        std::swap(corrupt.offsets[3], corrupt.offsets[4]);
+        writeTextRowIndex(sidecar, corrupt);
+        runner.expect_eq(readTextRowIndex(sidecar, loaded), false, "Offsets out of order are rejected");
+        corrupt.offsets = index.offsets;
+        corrupt.offsets.back() = index.textBytes + 1;
+        writeTextRowIndex(sidecar, corrupt);
+        runner.expect_eq(readTextRowIndex(sidecar, loaded), false, "Offsets past the text are rejected");
+        corrupt.offsets = index.offsets;
+        corrupt.offsets[0] = 1;
+        writeTextRowIndex(sidecar, corrupt);
+        runner.expect_eq(readTextRowIndex(sidecar, loaded), false, "First offset must be 0");
+        corrupt.offsets = index.offsets;
+        std::swap(corrupt.offsets[3], corrupt.offsets[4]);
+        runner.expect_eq(!reader.open(path, corrupt) && reader.error() == std::string(path) + ": row index is corrupt",
+                         true, "Reader refuses an inconsistent index");
+        std::remove(sidecar.c_str());
+        std::remove(path);
+    }
+
+    // Test 35: Every read-ahead engine streams a dungeon file to the same answer
+    {
+        DungeonGrid grid = DungeonGenerator(GeneratorSpec::make(DungeonFamily::Stale, 151, 97, 5)).generate();
+        const char* path = "simple_tests_stream.dgrid";
+        std::string error;
+        writeDungeonFile(path, grid, &error);
+        int expected = DungeonKernels::scalar1D(grid);
+        for (ReadEngine engine : {ReadEngine::Sync, ReadEngine::Threads, ReadEngine::IoUring}) {
+            for (bool direct : {false, true}) {
+                ReadAheadOptions options;
+                options.engine = engine;
+                options.depth = 3;
+                options.blockBytes = 5000;  // 12 rows, blocks across page boundaries
+                options.direct = direct;
+                ReadAheadDungeonFile file;
+                bool opened = file.open(path, options);
+                int answer = DungeonKernels::streaming(file.rows(), file.cols(), [&file](int i) { return file.row(i); });
+                runner.expect_eq(opened && !file.failed() && answer == expected, true,
+                                 std::string("Read-ahead ") + readEngineName(engine) + (direct ? " direct" : "") +
+                                     " matches the in-memory solve");
+            }
+        }
+
+        ReadAheadOptions options;
+        options.blockBytes = 5000;
+        ReadAheadDungeonFile file;
+        file.open(path, options);
+        file.row(150);
+        file.row(3);
+        runner.expect_eq(file.failed() && file.error() == "rows must be read bottom up", true,
+                         "Rows out of order fail the stream");
+        std::remove(path);
+    }
+
+    // Test 36: Forward sweep feasibility agrees with the backward DP
+    {
+        srand(36);
+        bool allMatch = true;
+        ForwardHealthSweep sweep;
+        for (int trial = 0; trial < 500 && allMatch; trial++) {
+            int rows = 1 + rand() % 24, cols = 1 + rand() % 24;
+            int range = trial % 2 ? 21 : 2001;
+            DungeonGrid grid(rows, cols);
+            for (auto& cell : grid.cells) {
+                cell = (rand() % range) - range / 2;
+            }
+            int expected = DungeonKernels::scalar1D(grid);
+            sweep.load(grid.toNested());
+            allMatch = sweep.canReach(expected) && (expected == 1 || !sweep.canReach(expected - 1));
+        }
+        runner.expect_eq(allMatch, true, "Sweep feasibility flips exactly at the DP answer");
+    }
+
+    // Test 37: Indexed heap pops in key order, once per cell; flat bitset
+    {
+        srand(37);
+        const int cells = 300;
+        IndexedDaryHeap<int> heap(cells);
+        vector<int> best(cells, INT_MAX);
+        for (int step = 0; step < 2000; step++) {
+            int id = rand() % (cells - 1);
+            int key = rand() % 10000;
+            heap.pushOrDecrease(id, key);
+            best[id] = std::min(best[id], key);
+        }
+        heap.push(cells - 1, -1);
+        best[cells - 1] = -1;
+        heap.decreaseKey(cells - 1, 1 << 20);  // a larger key is ignored
+        runner.expect_eq(heap.top(), cells - 1, "Heap top is the smallest key");
+        bool ordered = true;
+        int popped = 0;
+        int lastKey = INT_MIN;
+        while (!heap.empty()) {
+            int key = heap.topKey();
+            int id = heap.pop();
+            ordered = ordered && key >= lastKey && key == best[id] && !heap.contains(id);
+            lastKey = key;
+            popped++;
+        }
+        int queued = static_cast<int>(std::count_if(best.begin(), best.end(), [](int key) { return key != INT_MAX; }));
+        runner.expect_eq(ordered, true, "Heap pops each cell once in key order with its smallest key");
+        runner.expect_eq(popped, queued, "Heap holds each cell at most once");
+
+        // The same with the arrays from a workspace
+        Workspace workspace;
+        bool sameOrder = true;
+        for (int pass = 0; pass < 2; pass++) {
+            Workspace::Frame frame(workspace);
+            IndexedDaryHeap<int> borrowed(cells, workspace);
+            for (int id = 0; id < cells; id++) {
+                borrowed.push(id, best[id]);
+            }
+            lastKey = INT_MIN;
+            while (!borrowed.empty()) {
+                sameOrder = sameOrder && borrowed.topKey() >= lastKey;
+                lastKey = borrowed.topKey();
+                borrowed.pop();
+            }
+        }
+        runner.expect_eq(sameOrder && workspace.growths() == 1, true, "Heap on a workspace pops in key order and reuses it");
+
+        FlatBitset bits(130);
+        bits.set(0);
+        bits.set(64);
+        bits.set(129);
+        bits.clear(64);
+        runner.expect_eq(bits.test(0) && !bits.test(1) && !bits.test(64) && bits.test(129), true, "Bitset sets and clears across words");
+        bits.reset(130);
+        runner.expect_eq(bits.test(0) || bits.test(129), false, "Bitset reset clears every bit");
+    }
+
     runner.print_summary();
 }
 
@@ -0,0 +1,338 @@
+#ifndef DUNGEON_GAME_SOLVE_METRICS_H
+#define DUNGEON_GAME_SOLVE_METRICS_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <ostream>
+#include <iostream>
+#include <cstdio>
+#include <cstdint>
+
+#include "adaptive_solver.h"
+#include "alloc_tracking.h"
+#include "latency_histogram.h"
+
+// Everything SolveMetrics knows about one (kernel, size class) series
+struct SeriesSnapshot {
+    KernelKind kernel = KernelKind::Scalar1D;
+    SizeClass sizeClass = SizeClass::Small;
+    LatencyHistogram latency;
+    uint64_t cells = 0;
+    uint64_t allocations = 0;
+};
+
+struct MetricsSnapshot {
+    std::vector<SeriesSnapshot> series;  // only series with solves
+    uint64_t int16Widened = 0;
+
+    const SeriesSnapshot* find(KernelKind kernel, SizeClass sizeClass) const {
+        for (const auto& entry : series) {
+            if (entry.kernel == kernel && entry.sizeClass == sizeClass) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * Solve latency histograms and counters for a long-running service
+ *
+ * One series per (kernel, size class) holds a LatencyHistogram, the cells
+ * processed and the heap allocations made by the solving thread (counted
+ * only when the program includes alloc_hooks.h). A process-wide counter
+ * tracks solves that ran int32 wavefront lanes although this machine's
+ * profile prefers int16 (value range unknown, or too wide for int16).
+ *
+ * Recording is lock-free: each thread writes its own shard, found through
+ * a thread_local cache, with relaxed load + store pairs (it is the only
+ * writer), and a series' buckets are allocated the first time the thread
+ * records into it. snapshot() merges every shard and can run at any time;
+ * a solve in flight is either fully in it or not at all, up to the order
+ * of its relaxed stores. Shards outlive their threads, so totals are
+ * monotonic, as Prometheus counters must be.
+ */
+class SolveMetrics {
+public:
+    static const int kKernels = static_cast<int>(KernelKind::Count);
+    static const int kClasses = static_cast<int>(SizeClass::Count);
+    static const int kSeries = kKernels * kClasses;
+
+private:
+    struct SeriesCells {
+        std::atomic<uint64_t> buckets[LatencyHistogram::kBuckets];
+        std::atomic<uint64_t> sumNs;
+        std::atomic<uint64_t> maxNs;
+        std::atomic<uint64_t> cells;
+        std::atomic<uint64_t> allocations;
+
+        SeriesCells() : sumNs(0), maxNs(0), cells(0), allocations(0) {
+            for (auto& bucket : buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    struct ThreadShard {
+        std::thread::id owner;
+        std::atomic<SeriesCells*> series[kSeries];
+        std::atomic<uint64_t> int16Widened;
+
+        explicit ThreadShard(std::thread::id id) : owner(id), int16Widened(0) {
+            for (auto& entry : series) {
+                entry.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~ThreadShard() {
+            for (auto& entry : series) {
+                delete entry.load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // Single writer per shard: no read-modify-write needed
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static uint64_t nextRegistryId() {
+        static std::atomic<uint64_t> next(1);
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const uint64_t id;
+    mutable std::mutex shardsLock;
+    std::vector<std::unique_ptr<ThreadShard>> shards;
+
+    ThreadShard& threadShard() {
+        struct Cache {
+            uint64_t registry;
+            ThreadShard* shard;
+        };
+        static thread_local Cache cache = { 0, nullptr };
+        if (cache.registry == id) {
+            return *cache.shard;
+        }
+
+        // First record from this thread, or it alternates between registries.
+        // A recycled thread id takes over the shard of a finished thread.
+        std::lock_guard<std::mutex> guard(shardsLock);
+        std::thread::id self = std::this_thread::get_id();
+        ThreadShard* shard = nullptr;
+        for (auto& candidate : shards) {
+            if (candidate->owner == self) {
+                shard = candidate.get();
+                break;
+            }
+        }
+        if (!shard) {
+            shards.push_back(std::unique_ptr<ThreadShard>(new ThreadShard(self)));
+            shard = shards.back().get();
+        }
+        cache.registry = id;
+        cache.shard = shard;
+        return *shard;
+    }
+
+public:
+    SolveMetrics() : id(nextRegistryId()) {}
+
+    SolveMetrics(const SolveMetrics&) = delete;
+    SolveMetrics& operator=(const SolveMetrics&) = delete;
+
+    void record(KernelKind kernel, size_t cells, uint64_t ns, uint64_t allocations) {
+        ThreadShard& shard = threadShard();
+        int index = static_cast<int>(kernel) * kClasses + static_cast<int>(sizeClassOf(cells));
+        SeriesCells* series = shard.series[index].load(std::memory_order_relaxed);
+        if (!series) {
+            series = new SeriesCells();
+            shard.series[index].store(series, std::memory_order_release);
+        }
+        bump(series->buckets[LatencyHistogram::bucketOf(ns)], 1);
+        bump(series->sumNs, ns);
+        bump(series->cells, cells);
+        bump(series->allocations, allocations);
+        if (ns > series->maxNs.load(std::memory_order_relaxed)) {
+            series->maxNs.store(ns, std::memory_order_relaxed);
+        }
+    }
+
+    void recordInt16Widened() {
+        bump(threadShard().int16Widened, 1);
+    }
+
+    MetricsSnapshot snapshot() const {
+        MetricsSnapshot result;
+        std::lock_guard<std::mutex> guard(shardsLock);
+        for (int index = 0; index < kSeries; index++) {
+            SeriesSnapshot merged;
+            merged.kernel = static_cast<KernelKind>(index / kClasses);
+            merged.sizeClass = static_cast<SizeClass>(index % kClasses);
+            for (const auto& shard : shards) {
+                const SeriesCells* series = shard->series[index].load(std::memory_order_acquire);
+                if (!series) continue;
+                for (size_t b = 0; b < LatencyHistogram::kBuckets; b++) {
+                    uint64_t count = series->buckets[b].load(std::memory_order_relaxed);
+                    if (count) merged.latency.addBucket(b, count);
+                }
+                merged.latency.addSum(series->sumNs.load(std::memory_order_relaxed));
+                merged.latency.addMax(series->maxNs.load(std::memory_order_relaxed));
+                merged.cells += series->cells.load(std::memory_order_relaxed);
+                merged.allocations += series->allocations.load(std::memory_order_relaxed);
+            }
+            if (merged.latency.count() > 0) {
+                result.series.push_back(std::move(merged));
+            }
+        }
+        for (const auto& shard : shards) {
+            result.int16Widened += shard->int16Widened.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    // ---- Prometheus text exposition format (version 0.0.4) -------------
+
+    // Cumulative buckets come from the log-linear slots, so an `le` edge is
+    // exact to within the slot width (about 3%)
+    static void writePrometheus(std::ostream& out, const MetricsSnapshot& snapshot) {
+        static const double kEdgesSeconds[] = {
+            1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4,
+            1e-3, 2.5e-3, 5e-3, 1e-2, 2.5e-2, 5e-2, 0.1, 0.25, 0.5, 1, 2.5, 5, 10
+        };
+        static const double kQuantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+        out << "# HELP dungeon_solve_duration_seconds Solve latency by kernel and grid size class.\n"
+            << "# TYPE dungeon_solve_duration_seconds histogram\n";
+        for (const auto& series : snapshot.series) {
+            std::string labels = seriesLabels(series);
+            for (double edge : kEdgesSeconds) {
+                out << "dungeon_solve_duration_seconds_bucket{" << labels << ",le=\"" << edge << "\"} "
+                    << series.latency.countAtOrBelow(static_cast<uint64_t>(edge * 1e9)) << "\n";
+            }
+            out << "dungeon_solve_duration_seconds_bucket{" << labels << ",le=\"+Inf\"} "
+                << series.latency.count() << "\n";
+            out << "dungeon_solve_duration_seconds_sum{" << labels << "} " << series.latency.sum() / 1e9 << "\n";
+            out << "dungeon_solve_duration_seconds_count{" << labels << "} " << series.latency.count() << "\n";
+        }
+
+        out << "# HELP dungeon_solve_latency_seconds Solve latency quantiles since start.\n"
+            << "# TYPE dungeon_solve_latency_seconds summary\n";
+        for (const auto& series : snapshot.series) {
+            std::string labels = seriesLabels(series);
+            for (double q : kQuantiles) {
+                out << "dungeon_solve_latency_seconds{" << labels << ",quantile=\"" << q << "\"} "
+                    << series.latency.percentile(q) / 1e9 << "\n";
+            }
+            out << "dungeon_solve_latency_seconds_sum{" << labels << "} " << series.latency.sum() / 1e9 << "\n";
+            out << "dungeon_solve_latency_seconds_count{" << labels << "} " << series.latency.count() << "\n";
+        }
+
+        out << "# HELP dungeon_solve_cells_total Grid cells processed.\n"
+            << "# TYPE dungeon_solve_cells_total counter\n";
+        for (const auto& series : snapshot.series) {
+            out << "dungeon_solve_cells_total{" << seriesLabels(series) << "} " << series.cells << "\n";
+        }
+
+        out << "# HELP dungeon_solve_allocations_total Heap allocations made by solving threads.\n"
+            << "# TYPE dungeon_solve_allocations_total counter\n";
+        for (const auto& series : snapshot.series) {
+            out << "dungeon_solve_allocations_total{" << seriesLabels(series) << "} "
+                << series.allocations << "\n";
+        }
+
+        out << "# HELP dungeon_solve_int16_widened_total Solves run on int32 lanes where int16 was preferred.\n"
+            << "# TYPE dungeon_solve_int16_widened_total counter\n"
+            << "dungeon_solve_int16_widened_total " << snapshot.int16Widened << "\n";
+    }
+
+    void writePrometheus(std::ostream& out) const {
+        writePrometheus(out, snapshot());
+    }
+
+    // "-" writes to stdout. A file is written next to its target and
+    // renamed over it, so a textfile collector never reads half a snapshot.
+    bool exportPrometheus(const std::string& path) const {
+        if (path == "-") {
+            writePrometheus(std::cout);
+            std::cout.flush();
+            return static_cast<bool>(std::cout);
+        }
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary);
+            writePrometheus(out);
+            if (!out) {
+                return false;
+            }
+        }
+        return std::rename(temporary.c_str(), path.c_str()) == 0;
+    }
+
+private:
+    static std::string seriesLabels(const SeriesSnapshot& series) {
+        return std::string("kernel=\"") + kernelName(series.kernel) +
+               "\",size_class=\"" + sizeClassName(series.sizeClass) + "\"";
+    }
+};
+
+/**
+ * AdaptiveDungeonSolver that records every solve into a SolveMetrics
+ *
+ * Adds two steady_clock reads and a few relaxed stores to each solve. The
+ * solver and the metrics are shared; wrap them once per thread or share
+ * one wrapper, both are safe.
+ */
+class MeteredDungeonSolver {
+private:
+    const AdaptiveDungeonSolver& solver;
+    SolveMetrics& metrics;
+
+public:
+    MeteredDungeonSolver(const AdaptiveDungeonSolver& solver, SolveMetrics& metrics)
+        : solver(solver), metrics(metrics) {}
+
+    SolveResult solve(const DungeonGrid& grid, const SolveOptions& options = SolveOptions(),
+                      Workspace* workspace = nullptr) const {
+        uint64_t allocationsBefore = threadAllocationCount();
+        auto start = std::chrono::steady_clock::now();
+        SolveResult result = solver.solve(grid, options, workspace);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        uint64_t ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        metrics.record(result.kernel, grid.size(), ns, threadAllocationCount() - allocationsBefore);
+        if (result.kernel == KernelKind::Wavefront32 &&
+            solver.profile().forCells(grid.size()).int16Lanes) {
+            metrics.recordInt16Widened();
+        }
+        return result;
+    }
+
+    // Recorded as one Batch solve over all the cells
+    std::vector<int> solveBatch(const std::vector<DungeonGrid>& grids,
+                                const SolveOptions& options = SolveOptions(),
+                                Workspace* workspace = nullptr) const {
+        size_t cells = 0;
+        for (const auto& grid : grids) {
+            cells += grid.size();
+        }
+        uint64_t allocationsBefore = threadAllocationCount();
+        auto start = std::chrono::steady_clock::now();
+        std::vector<int> results = solver.solveBatch(grids, options, workspace);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        uint64_t ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        metrics.record(KernelKind::Batch, cells, ns, threadAllocationCount() - allocationsBefore);
+        return results;
+    }
+};
+
+#endif // DUNGEON_GAME_SOLVE_METRICS_H
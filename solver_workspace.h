@@ -0,0 +1,188 @@
+#ifndef DUNGEON_GAME_SOLVER_WORKSPACE_H
+#define DUNGEON_GAME_SOLVER_WORKSPACE_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * Monotonic scratch arena for the bottom-up kernels
+ *
+ * A kernel takes its DP rows, diagonal copies and tile edges from the
+ * workspace with allocate<T>() and gives them all back at once when its
+ * Frame goes out of scope; nothing is freed individually. Memory comes
+ * from a chain of chunks. When the outermost frame closes and the solve
+ * needed more than one chunk, the chain is replaced by a single chunk of
+ * the high-water size, so from the second solve of a given shape on a
+ * solve touches the heap zero times.
+ *
+ * Every block is rounded up to and aligned on 64 bytes: blocks never share
+ * a cache line (worker threads write their own rows concurrently), and
+ * the same sequence of requests always fits the consolidated chunk.
+ *
+ * Not thread-safe: allocate from one thread, then hand the blocks out.
+ */
+class Workspace {
+public:
+    static const size_t kAlignment = 64;
+
+    // Position in the arena; rewinding to it frees everything allocated since
+    struct Mark {
+        size_t chunk;
+        size_t offset;
+        size_t used;
+    };
+
+    // Rewinds the workspace to where it was when the frame was opened
+    class Frame {
+    private:
+        Workspace& workspace;
+        Mark mark;
+
+    public:
+        explicit Frame(Workspace& owner) : workspace(owner), mark(owner.mark()) {}
+        ~Frame() { workspace.rewind(mark); }
+
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+    };
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> storage;
+        char* base;  // storage rounded up to kAlignment
+        size_t size;
+    };
+
+    std::vector<Chunk> chunks;
+    size_t current = 0;     // chunk being bumped
+    size_t offset = 0;      // next free byte in chunks[current]
+    size_t used = 0;        // bytes handed out since the arena was empty
+    size_t highWater_ = 0;
+    size_t growths_ = 0;    // chunk allocations, consolidation included
+
+public:
+    Workspace() {}
+
+    // Starts with one chunk of at least `bytes`, e.g. a known high-water mark
+    explicit Workspace(size_t bytes) {
+        if (bytes > 0) {
+            addChunk(bytes);
+        }
+    }
+
+    Workspace(const Workspace&) = delete;
+    Workspace& operator=(const Workspace&) = delete;
+
+    // Bytes a block of `count` T occupies
+    template<typename T>
+    static size_t bytesFor(size_t count) {
+        return roundUp(count * sizeof(T));
+    }
+
+    // Makes the next `bytes` of requests come from one chunk; kernels call
+    // it with their total need so even a fresh workspace grows only once
+    void reserve(size_t bytes) {
+        if (chunks.empty() || chunks[current].size - offset < bytes) {
+            advance(bytes);
+        }
+    }
+
+    // Uninitialised storage for `count` T; T must be trivially destructible
+    template<typename T>
+    T* allocate(size_t count) {
+        size_t bytes = bytesFor<T>(count);
+        reserve(bytes);
+        char* block = chunks[current].base + offset;
+        offset += bytes;
+        used += bytes;
+        highWater_ = std::max(highWater_, used);
+        return reinterpret_cast<T*>(block);
+    }
+
+    template<typename T>
+    T* allocate(size_t count, T value) {
+        T* block = allocate<T>(count);
+        std::fill(block, block + count, value);
+        return block;
+    }
+
+    Mark mark() const {
+        Mark position = { current, offset, used };
+        return position;
+    }
+
+    void rewind(const Mark& position) {
+        current = position.chunk;
+        offset = position.offset;
+        used = position.used;
+        if (used == 0 && chunks.size() > 1) {
+            consolidate();
+        }
+    }
+
+    // Frees every block; consolidates the chunks if there are several
+    void reset() {
+        Mark empty = { 0, 0, 0 };
+        rewind(empty);
+    }
+
+    // Bytes held across all chunks
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Chunk& chunk : chunks) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+    size_t inUse() const { return used; }
+    size_t highWater() const { return highWater_; }
+    size_t growths() const { return growths_; }
+
+private:
+    static size_t roundUp(size_t bytes) {
+        return (bytes + kAlignment - 1) / kAlignment * kAlignment;
+    }
+
+    // Moves to the first later chunk with room, allocating one if none has
+    void advance(size_t bytes) {
+        for (size_t next = chunks.empty() ? 0 : current + 1; next < chunks.size(); next++) {
+            if (chunks[next].size >= bytes) {
+                current = next;
+                offset = 0;
+                return;
+            }
+        }
+        // Geometric growth keeps the number of chunks per warmup logarithmic
+        addChunk(std::max(bytes, capacity()));
+        current = chunks.size() - 1;
+        offset = 0;
+    }
+
+    void addChunk(size_t bytes) {
+        Chunk chunk;
+        chunk.size = roundUp(std::max<size_t>(bytes, 4096));
+        chunk.storage.reset(new char[chunk.size + kAlignment - 1]);
+        uintptr_t address = reinterpret_cast<uintptr_t>(chunk.storage.get());
+        chunk.base = reinterpret_cast<char*>((address + kAlignment - 1) & ~(uintptr_t)(kAlignment - 1));
+        chunks.push_back(std::move(chunk));
+        growths_++;
+    }
+
+    // One chunk of the high-water size replaces the chain. Blocks are
+    // rounded to kAlignment, so the largest solve seen so far fits in it.
+    void consolidate() {
+        size_t bytes = highWater_;
+        chunks.clear();
+        chunks.shrink_to_fit();
+        chunks.reserve(1);
+        addChunk(bytes);
+        current = 0;
+        offset = 0;
+    }
+};
+
+#endif // DUNGEON_GAME_SOLVER_WORKSPACE_H
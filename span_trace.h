@@ -0,0 +1,280 @@
+#ifndef DUNGEON_GAME_SPAN_TRACE_H
+#define DUNGEON_GAME_SPAN_TRACE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <algorithm>
+
+// What a timeline span covers
+enum class SpanKind : uint8_t {
+    Solve,        // one AdaptiveDungeonSolver::solve; index = kernel
+    Tile,         // one tile of tiledParallel; index = band, value = strip
+    WaveBarrier,  // a tiledParallel worker waiting for the rest of its wave
+    Batch,        // one solveBatch / DungeonKernels::batch call
+    BatchGrid,    // one grid of a batch; index = grid number
+    SearchRound,  // one round of a health search; value = interval width
+    Probe,        // one feasibility probe; index = lane, value = health
+    Count
+};
+
+inline const char* spanKindName(SpanKind kind) {
+    switch (kind) {
+        case SpanKind::Solve:       return "solve";
+        case SpanKind::Tile:        return "tile";
+        case SpanKind::WaveBarrier: return "wave_barrier";
+        case SpanKind::Batch:       return "batch";
+        case SpanKind::BatchGrid:   return "batch_grid";
+        case SpanKind::SearchRound: return "search_round";
+        case SpanKind::Probe:       return "probe";
+        default:                    return "unknown";
+    }
+}
+
+// Cells a span worked on: rows [rowBegin, rowEnd) x cols [colBegin, colEnd)
+struct CellRange {
+    int32_t rowBegin;
+    int32_t rowEnd;
+    int32_t colBegin;
+    int32_t colEnd;
+};
+
+inline CellRange cellRange(int rowBegin, int rowEnd, int colBegin, int colEnd) {
+    CellRange range = { rowBegin, rowEnd, colBegin, colEnd };
+    return range;
+}
+
+struct SpanRecord {
+    uint64_t startNs;  // since the tracer was created
+    uint64_t endNs;
+    CellRange cells;
+    int64_t value;
+    int32_t index;
+    SpanKind kind;
+};
+
+/**
+ * Timeline of parallel solver execution, exported as Chrome trace JSON
+ *
+ * While a tracer is active (one per process), the kernels and the
+ * parallel search record a span per solve, tile, barrier wait, batch grid,
+ * search round and probe: thread, start, end, the cells it covered and
+ * one kind-specific value. The JSON opens in Perfetto (ui.perfetto.dev)
+ * or chrome://tracing, where stragglers and idle gaps between waves show
+ * up directly.
+ *
+ * Each thread appends to its own buffer, registered on its first span, so
+ * recording takes no lock. Export after the traced work has finished (the
+ * kernels join their threads before returning, so after the solve call).
+ * A thread stops recording after maxSpansPerThread and counts the rest as
+ * dropped.
+ *
+ * With no tracer active a span is one relaxed atomic load and a branch per
+ * tile or probe, not per cell. Defining DUNGEON_GAME_NO_SPANS removes even
+ * that: SpanScope becomes an empty type.
+ */
+class SpanTracer {
+private:
+    struct ThreadBuffer {
+        uint32_t thread;
+        std::vector<SpanRecord> spans;
+        uint64_t dropped = 0;
+    };
+
+    static std::atomic<SpanTracer*>& activeTracer() {
+        static std::atomic<SpanTracer*> tracer(nullptr);
+        return tracer;
+    }
+
+    static uint64_t nextTracerId() {
+        static std::atomic<uint64_t> next(1);
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const uint64_t id;
+    const size_t maxSpansPerThread;
+    const std::chrono::steady_clock::time_point origin;
+    mutable std::mutex buffersLock;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+    ThreadBuffer& threadBuffer() {
+        struct Cache {
+            uint64_t tracer;
+            ThreadBuffer* buffer;
+        };
+        static thread_local Cache cache = { 0, nullptr };
+        if (cache.tracer != id) {
+            std::lock_guard<std::mutex> guard(buffersLock);
+            buffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer()));
+            buffers.back()->thread = static_cast<uint32_t>(buffers.size());
+            buffers.back()->spans.reserve(std::min<size_t>(maxSpansPerThread, 4096));
+            cache.tracer = id;
+            cache.buffer = buffers.back().get();
+        }
+        return *cache.buffer;
+    }
+
+public:
+    explicit SpanTracer(size_t maxSpansPerThread = 1 << 20)
+        : id(nextTracerId()), maxSpansPerThread(maxSpansPerThread),
+          origin(std::chrono::steady_clock::now()) {}
+
+    ~SpanTracer() {
+        SpanTracer* self = this;
+        activeTracer().compare_exchange_strong(self, nullptr);
+    }
+
+    SpanTracer(const SpanTracer&) = delete;
+    SpanTracer& operator=(const SpanTracer&) = delete;
+
+    // Acquire pairs with activate()'s release, so a thread that sees the
+    // tracer also sees it fully constructed
+    static SpanTracer* active() {
+        return activeTracer().load(std::memory_order_acquire);
+    }
+
+    // Spans started after activate() go to this tracer
+    void activate() { activeTracer().store(this, std::memory_order_release); }
+    static void deactivate() { activeTracer().store(nullptr, std::memory_order_release); }
+
+    uint64_t nowNs() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - origin).count());
+    }
+
+    void record(SpanKind kind, uint64_t startNs, uint64_t endNs, const CellRange& cells,
+                int32_t index, int64_t value) {
+        ThreadBuffer& buffer = threadBuffer();
+        if (buffer.spans.size() >= maxSpansPerThread) {
+            buffer.dropped++;
+            return;
+        }
+        SpanRecord span;
+        span.startNs = startNs;
+        span.endNs = endNs;
+        span.cells = cells;
+        span.value = value;
+        span.index = index;
+        span.kind = kind;
+        buffer.spans.push_back(span);
+    }
+
+    size_t spans() const {
+        std::lock_guard<std::mutex> guard(buffersLock);
+        size_t total = 0;
+        for (const auto& buffer : buffers) {
+            total += buffer->spans.size();
+        }
+        return total;
+    }
+
+    uint64_t dropped() const {
+        std::lock_guard<std::mutex> guard(buffersLock);
+        uint64_t total = 0;
+        for (const auto& buffer : buffers) {
+            total += buffer->dropped;
+        }
+        return total;
+    }
+
+    size_t threads() const {
+        std::lock_guard<std::mutex> guard(buffersLock);
+        return buffers.size();
+    }
+
+    // Calls visit(thread, span) for every span, thread by thread
+    template<typename Visit>
+    void forEach(Visit visit) const {
+        std::lock_guard<std::mutex> guard(buffersLock);
+        for (const auto& buffer : buffers) {
+            for (const SpanRecord& span : buffer->spans) {
+                visit(buffer->thread, span);
+            }
+        }
+    }
+
+    // Trace-event format: complete ("X") events in microseconds, plus a
+    // thread_name metadata event per thread
+    void writeChromeJson(std::ostream& out) const {
+        std::lock_guard<std::mutex> guard(buffersLock);
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        char line[320];
+        for (const auto& buffer : buffers) {
+            std::snprintf(line, sizeof(line),
+                          "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                          "\"args\":{\"name\":\"thread %u\"}}",
+                          first ? "" : ",", buffer->thread, buffer->thread);
+            out << line;
+            first = false;
+            for (const SpanRecord& span : buffer->spans) {
+                std::snprintf(line, sizeof(line),
+                              ",\n{\"name\":\"%s\",\"cat\":\"dungeon\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                              "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"rows\":[%d,%d],\"cols\":[%d,%d],"
+                              "\"index\":%d,\"value\":%lld}}",
+                              spanKindName(span.kind), buffer->thread, span.startNs / 1e3,
+                              (span.endNs - span.startNs) / 1e3, span.cells.rowBegin, span.cells.rowEnd,
+                              span.cells.colBegin, span.cells.colEnd, span.index,
+                              static_cast<long long>(span.value));
+                out << line;
+            }
+        }
+        out << "\n]}\n";
+    }
+
+    bool writeChromeJson(const std::string& path) const {
+        std::ofstream out(path);
+        writeChromeJson(out);
+        return static_cast<bool>(out);
+    }
+};
+
+#if defined(DUNGEON_GAME_NO_SPANS)
+
+class SpanScope {
+public:
+    SpanScope(SpanKind, const CellRange&, int32_t = 0, int64_t = 0) {}
+};
+
+#else
+
+// Records a span from construction to destruction if a tracer is active
+class SpanScope {
+private:
+    SpanTracer* tracer;
+    uint64_t startNs = 0;
+    SpanKind kind;
+    CellRange cells;
+    int32_t index;
+    int64_t value;
+
+public:
+    SpanScope(SpanKind kind, const CellRange& cells, int32_t index = 0, int64_t value = 0)
+        : tracer(SpanTracer::active()), kind(kind), cells(cells), index(index), value(value) {
+        if (tracer) {
+            startNs = tracer->nowNs();
+        }
+    }
+
+    ~SpanScope() {
+        if (tracer) {
+            tracer->record(kind, startNs, tracer->nowNs(), cells, index, value);
+        }
+    }
+
+    SpanScope(const SpanScope&) = delete;
+    SpanScope& operator=(const SpanScope&) = delete;
+};
+
+#endif
+
+#endif // DUNGEON_GAME_SPAN_TRACE_H
@@ -0,0 +1,176 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include "trace_reader.h"
+
+using std::vector;
+using std::string;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/**
+ * Offline analysis of callgraph_generator binary traces
+ *
+ *   trace_analyze summary TRACE               event counts, depth, duration
+ *   trace_analyze dot TRACE OUT.dot [--bin K] aggregated call graph
+ *   trace_analyze heatmap TRACE OUT.csv|OUT.pgm [--event NAME]
+ *   trace_analyze text TRACE OUT.txt          indented call trace
+ *
+ * Every command streams the trace once, so a multi-GB trace needs no more
+ * memory than the aggregate it builds: the per-cell heatmap for the grid,
+ * or at most a few thousand nodes for the binned DOT graph.
+ */
+
+static bool parseEvent(const string& name, TraceEvent& event) {
+    for (int e = 0; e < static_cast<int>(TraceEvent::Count); e++) {
+        if (name == traceEventName(static_cast<TraceEvent>(e))) {
+            event = static_cast<TraceEvent>(e);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool hasSuffix(const string& text, const string& suffix) {
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static int summarizeTrace(const string& path) {
+    TraceReader reader(path);
+    TraceStacks stacks;
+    TraceSummary summary;
+    bool ok = reader.forEach([&](uint32_t thread, const TraceRecord& record) {
+        int depth = static_cast<int>(stacks.apply(thread, record).size());
+        summary.add(thread, record, depth);
+    });
+    if (!ok) {
+        cerr << reader.lastError() << endl;
+        return 2;
+    }
+
+    cout << "Records: " << summary.records << " (" << std::fixed << std::setprecision(1)
+         << summary.records * sizeof(TraceRecord) / (1024.0 * 1024.0) << " MB)" << endl;
+    cout << "Threads: " << summary.threads << ", solves: " << summary.solves << endl;
+    cout << "Max call depth: " << summary.maxDepth << endl;
+    cout << "Traced span: " << std::setprecision(3) << (summary.lastNs - summary.firstNs) / 1e6 << " ms" << endl;
+    for (int e = 0; e < static_cast<int>(TraceEvent::Count); e++) {
+        TraceEvent event = static_cast<TraceEvent>(e);
+        cout << "  " << std::left << std::setw(14) << traceEventName(event) << std::right
+             << std::setw(14) << summary.count(event) << endl;
+    }
+    uint64_t calls = summary.count(TraceEvent::Enter);
+    if (calls > 0) {
+        cout << "Memo hit rate: " << std::setprecision(2)
+             << 100.0 * summary.count(TraceEvent::Memoized) / calls << "%" << endl;
+    }
+    return 0;
+}
+
+static int writeDot(const string& path, const string& out, int bin) {
+    TraceReader reader(path);
+    CallGraphAggregate graph(bin);
+    bool ok = reader.forEach([&](uint32_t thread, const TraceRecord& record) {
+        graph.add(thread, record);
+    });
+    if (!ok) {
+        cerr << reader.lastError() << endl;
+        return 2;
+    }
+
+    std::ofstream dot(out);
+    graph.writeDot(dot);
+    if (!dot) {
+        cerr << "Cannot write " << out << endl;
+        return 2;
+    }
+    cout << graph.nodeCount() << " nodes (bin " << graph.binSize() << ") written to " << out << endl;
+    return 0;
+}
+
+static int writeHeatmap(const string& path, const string& out, TraceEvent event) {
+    TraceReader reader(path);
+    CellHeatmap heatmap(event);
+    bool ok = reader.forEach([&](uint32_t thread, const TraceRecord& record) {
+        heatmap.add(thread, record);
+    });
+    if (!ok) {
+        cerr << reader.lastError() << endl;
+        return 2;
+    }
+
+    bool pgm = hasSuffix(out, ".pgm");
+    std::ofstream file(out, pgm ? std::ios::binary : std::ios::out);
+    if (!(pgm ? heatmap.writePgm(file) : heatmap.writeCsv(file))) {
+        cerr << "Cannot write " << out << endl;
+        return 2;
+    }
+    cout << "Heatmap of '" << traceEventName(event) << "' written to " << out << endl;
+    return 0;
+}
+
+static int writeText(const string& path, const string& out) {
+    TraceReader reader(path);
+    std::ofstream text(out);
+    TraceTextWriter writer(text);
+    bool ok = reader.forEach([&](uint32_t thread, const TraceRecord& record) {
+        writer.add(thread, record);
+    });
+    if (!ok) {
+        cerr << reader.lastError() << endl;
+        return 2;
+    }
+    return text ? 0 : 2;
+}
+
+static void printUsage() {
+    cerr << "Usage:\n"
+         << "  trace_analyze summary TRACE\n"
+         << "  trace_analyze dot TRACE OUT.dot [--bin K]\n"
+         << "  trace_analyze heatmap TRACE OUT.csv|OUT.pgm [--event enter|memoized|computed|...]\n"
+         << "  trace_analyze text TRACE OUT.txt\n";
+}
+
+int main(int argc, char** argv) {
+    vector<string> positional;
+    int bin = 0;
+    TraceEvent event = TraceEvent::Enter;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--bin" && hasValue) {
+            bin = std::atoi(argv[++i]);
+        } else if (arg == "--event" && hasValue) {
+            if (!parseEvent(argv[++i], event)) {
+                cerr << "Unknown event " << argv[i] << endl;
+                return 2;
+            }
+        } else if (arg.compare(0, 2, "--") == 0) {
+            printUsage();
+            return 2;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() == 2 && positional[0] == "summary") {
+        return summarizeTrace(positional[1]);
+    }
+    if (positional.size() == 3 && positional[0] == "dot") {
+        return writeDot(positional[1], positional[2], bin);
+    }
+    if (positional.size() == 3 && positional[0] == "heatmap") {
+        return writeHeatmap(positional[1], positional[2], event);
+    }
+    if (positional.size() == 3 && positional[0] == "text") {
+        return writeText(positional[1], positional[2]);
+    }
+    printUsage();
+    return 2;
+}
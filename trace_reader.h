@@ -0,0 +1,405 @@
+#ifndef DUNGEON_GAME_TRACE_READER_H
+#define DUNGEON_GAME_TRACE_READER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "call_trace.h"
+
+/**
+ * Streaming reader for CallTracer files
+ *
+ * Reads blocks in chunks of 64K records and hands each record to a visitor
+ * together with its thread id, so memory use does not depend on the trace
+ * size.
+ */
+class TraceReader {
+private:
+    static const size_t kChunkRecords = 1 << 16;
+
+    std::FILE* file = nullptr;
+    std::string error;
+
+public:
+    explicit TraceReader(const std::string& path) {
+        file = std::fopen(path.c_str(), "rb");
+        if (!file) {
+            error = "cannot open " + path;
+            return;
+        }
+        TraceFileHeader header;
+        if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+            std::memcmp(header.magic, kTraceMagic, sizeof(kTraceMagic)) != 0) {
+            error = path + ": not a dungeon trace";
+        } else if (header.version != kTraceVersion || header.recordSize != sizeof(TraceRecord)) {
+            error = path + ": unsupported trace version";
+        }
+    }
+
+    ~TraceReader() {
+        if (file) std::fclose(file);
+    }
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    bool ok() const { return file && error.empty(); }
+    const std::string& lastError() const { return error; }
+
+    // Calls visit(thread, record) for every record, in file order
+    template<typename Visitor>
+    bool forEach(Visitor visit) {
+        if (!ok()) {
+            return false;
+        }
+        std::vector<TraceRecord> chunk(kChunkRecords);
+        TraceBlockHeader block;
+        while (std::fread(&block, sizeof(block), 1, file) == 1) {
+            size_t remaining = block.count;
+            while (remaining > 0) {
+                size_t want = remaining < kChunkRecords ? remaining : kChunkRecords;
+                if (std::fread(chunk.data(), sizeof(TraceRecord), want, file) != want) {
+                    error = "truncated trace block";
+                    return false;
+                }
+                for (size_t i = 0; i < want; i++) {
+                    visit(block.thread, chunk[i]);
+                }
+                remaining -= want;
+            }
+        }
+        return true;
+    }
+};
+
+// Per-thread call stacks, for finding the caller of each Enter
+class TraceStacks {
+public:
+    struct Frame {
+        int32_t row;
+        int32_t col;
+    };
+
+private:
+    std::unordered_map<uint32_t, std::vector<Frame>> stacks;
+
+public:
+    // Applies `record` and returns the thread's stack afterwards; on Enter
+    // the caller is the frame below the top
+    const std::vector<Frame>& apply(uint32_t thread, const TraceRecord& record) {
+        std::vector<Frame>& stack = stacks[thread];
+        TraceEvent event = static_cast<TraceEvent>(record.event);
+        if (event == TraceEvent::Enter) {
+            Frame frame = {record.row, record.col};
+            stack.push_back(frame);
+        } else if (traceEventReturns(event) && !stack.empty()) {
+            stack.pop_back();
+        } else if (event == TraceEvent::SolveBegin) {
+            stack.clear();
+        }
+        return stack;
+    }
+};
+
+// Call totals for summary output
+struct TraceSummary {
+    uint64_t records = 0;
+    uint64_t solves = 0;
+    uint64_t events[static_cast<int>(TraceEvent::Count)] = {};
+    uint32_t threads = 0;
+    int maxDepth = 0;
+    uint64_t firstNs = 0;
+    uint64_t lastNs = 0;
+
+    void add(uint32_t thread, const TraceRecord& record, int depth) {
+        if (records == 0 || record.timestampNs < firstNs) firstNs = record.timestampNs;
+        lastNs = std::max(lastNs, static_cast<uint64_t>(record.timestampNs));
+        records++;
+        if (record.event < static_cast<int>(TraceEvent::Count)) {
+            events[record.event]++;
+        }
+        if (static_cast<TraceEvent>(record.event) == TraceEvent::SolveBegin) {
+            solves++;
+        }
+        threads = std::max(threads, thread + 1);
+        maxDepth = std::max(maxDepth, depth);
+    }
+
+    uint64_t count(TraceEvent event) const { return events[static_cast<int>(event)]; }
+};
+
+/**
+ * Call graph aggregated over cells, or over bin x bin blocks of cells
+ *
+ * A node counts the calls into its cells by outcome, an edge counts calls
+ * from one node to another. Binning keeps the DOT file readable for large
+ * grids: a 1000x1000 solve with bin 32 is at most 32x32 nodes however many
+ * millions of calls the trace holds.
+ */
+class CallGraphAggregate {
+private:
+    struct Node {
+        uint64_t calls = 0;
+        uint64_t outcomes[static_cast<int>(TraceEvent::Count)] = {};
+    };
+
+    static const uint64_t kRoot = ~static_cast<uint64_t>(0);
+
+    int bin;
+    int rows = 0;
+    int cols = 0;
+    TraceStacks stacks;
+    std::unordered_map<uint64_t, Node> nodes;
+    std::unordered_map<uint64_t, std::unordered_map<uint64_t, uint64_t>> edges;
+
+    uint64_t keyOf(int32_t row, int32_t col) const {
+        return (static_cast<uint64_t>(row / bin) << 32) | static_cast<uint32_t>(col / bin);
+    }
+
+public:
+    // bin = 0 picks a bin that keeps the graph within about 32x32 nodes
+    explicit CallGraphAggregate(int bin = 0) : bin(bin) {}
+
+    void add(uint32_t thread, const TraceRecord& record) {
+        TraceEvent event = static_cast<TraceEvent>(record.event);
+        if (event == TraceEvent::SolveBegin) {
+            rows = std::max(rows, static_cast<int>(record.row));
+            cols = std::max(cols, static_cast<int>(record.col));
+            if (bin <= 0) {
+                bin = std::max(1, (std::max(rows, cols) + 1 + 31) / 32);
+            }
+        }
+        if (bin <= 0) {
+            bin = 1;  // trace without a SolveBegin
+        }
+
+        const std::vector<TraceStacks::Frame>& stack = stacks.apply(thread, record);
+        if (event == TraceEvent::Enter) {
+            uint64_t child = keyOf(record.row, record.col);
+            uint64_t parent = stack.size() >= 2
+                ? keyOf(stack[stack.size() - 2].row, stack[stack.size() - 2].col)
+                : kRoot;
+            nodes[child].calls++;
+            edges[parent][child]++;
+        } else if (traceEventReturns(event)) {
+            nodes[keyOf(record.row, record.col)].outcomes[record.event]++;
+        }
+    }
+
+    int binSize() const { return bin; }
+    size_t nodeCount() const { return nodes.size(); }
+
+    void writeDot(std::ostream& dot) const {
+        dot << "digraph CallGraph {\n";
+        dot << "  rankdir=TD;\n";
+        dot << "  node [shape=box, style=filled, fillcolor=lightblue];\n";
+        dot << "  edge [color=blue];\n\n";
+        dot << "  \"calculateMinimumHP\" [fillcolor=lightgreen];\n";
+
+        std::vector<uint64_t> keys;
+        for (const auto& node : nodes) {
+            keys.push_back(node.first);
+        }
+        std::sort(keys.begin(), keys.end());
+
+        for (uint64_t key : keys) {
+            const Node& node = nodes.at(key);
+            uint64_t outOfBounds = node.outcomes[static_cast<int>(TraceEvent::OutOfBounds)];
+            uint64_t princess = node.outcomes[static_cast<int>(TraceEvent::Princess)];
+            uint64_t memoized = node.outcomes[static_cast<int>(TraceEvent::Memoized)];
+
+            const char* fill = "yellow";
+            std::string label = nodeName(key);
+            if (outOfBounds == node.calls) {
+                fill = "red";
+                label += "\\nOut of Bounds";
+            } else if (princess > 0) {
+                fill = "orange";
+                label += "\\nPrincess Room";
+            }
+            if (node.calls > 1) {
+                label += "\\n" + std::to_string(node.calls) + " calls";
+                if (memoized > 0) {
+                    label += ", " + std::to_string(memoized) + " memoized";
+                }
+            }
+            dot << "  \"" << nodeName(key) << "\" [fillcolor=" << fill
+                << ", label=\"" << label << "\"];\n";
+        }
+        dot << "\n";
+
+        std::vector<uint64_t> parents;
+        for (const auto& edge : edges) {
+            parents.push_back(edge.first);
+        }
+        std::sort(parents.begin(), parents.end());
+        for (uint64_t parent : parents) {
+            std::vector<std::pair<uint64_t, uint64_t>> children(edges.at(parent).begin(),
+                                                                 edges.at(parent).end());
+            std::sort(children.begin(), children.end());
+            for (const auto& child : children) {
+                if (bin > 1 && parent == child.first) {
+                    continue;  // calls within one block
+                }
+                dot << "  \"" << nodeName(parent) << "\" -> \"" << nodeName(child.first) << "\"";
+                if (child.second > 1) {
+                    dot << " [label=\"" << child.second << "\"]";
+                }
+                dot << ";\n";
+            }
+        }
+        dot << "}\n";
+    }
+
+private:
+    std::string nodeName(uint64_t key) const {
+        if (key == kRoot) {
+            return "calculateMinimumHP";
+        }
+        int row = static_cast<int>(key >> 32);
+        int col = static_cast<int>(key & 0xffffffffu);
+        if (bin == 1) {
+            return "recurse(" + std::to_string(row) + "," + std::to_string(col) + ")";
+        }
+        // Out-of-bounds calls land one past the grid, so clamp to rows/cols
+        int lastRow = std::min(row * bin + bin - 1, rows);
+        int lastCol = std::min(col * bin + bin - 1, cols);
+        return "rows " + std::to_string(row * bin) + "-" + std::to_string(lastRow) +
+               ", cols " + std::to_string(col * bin) + "-" + std::to_string(lastCol);
+    }
+};
+
+/**
+ * Per-cell count of one event, for grids up to the largest SolveBegin
+ *
+ * Written as CSV (one grid row per line) or as a binary PGM image with a
+ * logarithmic grey scale, which stays viewable for a 20000x20000 grid.
+ */
+class CellHeatmap {
+private:
+    TraceEvent event;
+    int rows = 0;
+    int cols = 0;
+    std::vector<uint64_t> counts;
+
+public:
+    explicit CellHeatmap(TraceEvent event = TraceEvent::Enter) : event(event) {}
+
+    void add(uint32_t, const TraceRecord& record) {
+        TraceEvent kind = static_cast<TraceEvent>(record.event);
+        if (kind == TraceEvent::SolveBegin && (record.row > rows || record.col > cols)) {
+            resize(std::max(rows, static_cast<int>(record.row)), std::max(cols, static_cast<int>(record.col)));
+        } else if (kind == event && record.row >= 0 && record.row < rows &&
+                   record.col >= 0 && record.col < cols) {
+            counts[static_cast<size_t>(record.row) * cols + record.col]++;
+        }
+    }
+
+    bool writeCsv(std::ostream& out) const {
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                if (j > 0) out << ',';
+                out << counts[static_cast<size_t>(i) * cols + j];
+            }
+            out << '\n';
+        }
+        return static_cast<bool>(out);
+    }
+
+    bool writePgm(std::ostream& out) const {
+        uint64_t peak = 1;
+        for (uint64_t count : counts) {
+            peak = std::max(peak, count);
+        }
+        double scale = 255.0 / std::log1p(static_cast<double>(peak));
+
+        out << "P5\n" << cols << " " << rows << "\n255\n";
+        std::vector<char> line(cols);
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                double level = std::log1p(static_cast<double>(counts[static_cast<size_t>(i) * cols + j]));
+                line[j] = static_cast<char>(static_cast<unsigned char>(level * scale + 0.5));
+            }
+            out.write(line.data(), line.size());
+        }
+        return static_cast<bool>(out);
+    }
+
+private:
+    void resize(int newRows, int newCols) {
+        std::vector<uint64_t> grown(static_cast<size_t>(newRows) * newCols, 0);
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                grown[static_cast<size_t>(i) * newCols + j] = counts[static_cast<size_t>(i) * cols + j];
+            }
+        }
+        counts.swap(grown);
+        rows = newRows;
+        cols = newCols;
+    }
+};
+
+/**
+ * Indented text rendering of a trace, in the layout callgraph_trace.txt
+ * always had
+ */
+class TraceTextWriter {
+private:
+    std::ostream& out;
+    TraceStacks stacks;
+
+public:
+    explicit TraceTextWriter(std::ostream& out) : out(out) {}
+
+    void add(uint32_t thread, const TraceRecord& record) {
+        TraceEvent event = static_cast<TraceEvent>(record.event);
+        size_t depth = stacks.apply(thread, record).size();
+
+        switch (event) {
+            case TraceEvent::SolveBegin:
+                out << "=== DUNGEON GAME CALL TRACE ===\n";
+                out << "Grid size: " << record.row << "x" << record.col << "\n\n";
+                return;
+            case TraceEvent::SolveEnd:
+                out << "\n=== FINAL RESULT ===\n";
+                out << "Minimum HP needed: " << record.value << "\n";
+                return;
+            case TraceEvent::Enter:
+                out << std::string(depth * 2, ' ') << callName(record) << " - ENTER\n";
+                return;
+            default:
+                break;
+        }
+
+        // Return events: the call was one deeper than the stack is now
+        out << std::string((depth + 1) * 2, ' ') << callName(record);
+        switch (event) {
+            case TraceEvent::Princess:
+                out << " - PRINCESS ROOM, health needed: " << record.value << "\n";
+                break;
+            case TraceEvent::OutOfBounds:
+                out << " - OUT OF BOUNDS\n";
+                break;
+            case TraceEvent::Memoized:
+                out << " - MEMOIZED: " << record.value << "\n";
+                break;
+            default:
+                out << " - COMPUTED: " << record.value << "\n";
+                break;
+        }
+    }
+
+private:
+    static std::string callName(const TraceRecord& record) {
+        return "recurse(" + std::to_string(record.row) + "," + std::to_string(record.col) + ")";
+    }
+};
+
+#endif // DUNGEON_GAME_TRACE_READER_H